@@ -0,0 +1,1084 @@
+// Canvas benchmark of the host build: pixel formats and drawing of src/graphics.hpp
+//
+//     canvas_bench [--scenario name] [--repeat n]
+//
+// Every scenario checks the canvas against a reference computed here in the
+// simplest possible way, then times the same calls on the host CPU. Times are
+// wall clock, the best of --repeat runs (default 5); host Mpixel/s only compare
+// implementations with each other, not with the RP2040. The program exits with
+// 1 when any check fails.
+//
+// Scenarios:
+//     formats     every encode/decode and pack/unpack round trip of Rgb444,
+//                 Rgb565 and Rgb666 over all native values and all 24-bit
+//                 colours, RGB::toColorDepth against encode; drawPixel and clear
+//     lines       drawLine with butt, square and round caps against a per pixel
+//                 test of the same band, including lines thousands of pixels
+//                 long and endpoints off the canvas; pixel writes and time of
+//                 the span fill against the old square stamp per Bresenham step
+//     aa          drawLineAA against a floating point Wu reference image, also
+//                 for lines running tens of thousands of pixels off the canvas;
+//                 Mpixel/s over plotted pixels in every format
+//     blend       Format::blend and compositeLayer, fast and precise, against a
+//                 floating point reference; the case shows the largest channel
+//                 error and its bound in 8-bit units (format step + 1.5, plus
+//                 the alpha rounding of the fast mode, twice the step for
+//                 composite); Mpixel/s of both over a whole canvas
+//     blit        gImage_1IN69_PIC copied onto the canvas with blit, blitKeyed and
+//                 blitMasked (RGB565 source, RGB565 and RGB444 canvas) against
+//                 per pixel references; Paint_DrawImage of lib/GUI on the same
+//                 picture as the baseline it replaces, its buffer must equal
+//                 the blit
+//     packed      every image packed by tools/pack_images.py decoded with
+//                 decodeRow (whole rows and random parts, all formats, no
+//                 writes outside the part) and drawImage (clipped at all edges)
+//                 against the arrays of examples/ImageData.c; packed size and
+//                 Mpixel/s of drawImage against blit of the raw picture
+//     polygons    fillPolygon up to MaxPolygonPoints vertices against a per pixel
+//                 even-odd test, drawn and replayed from a DisplayList; one vertex
+//                 more draws nothing and is refused by the recorder
+//     fills       fillRect, hLine and vLine against setPixel pixel by pixel in all
+//                 formats: rectangles at and past every edge, empty and negative
+//                 sizes, full width rows (one contiguous fill), starts at x 0 - 3
+//                 and widths 0 - 13 for every head and tail of the 32-bit
+//                 stores, random rectangles; Mpixel/s of the setPixel loop
+//                 against fillRect
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "display_list.hpp"
+#include "graphics.hpp"
+#include "image_assets.hpp"
+
+extern "C" {
+#include "GUI_Paint.h"
+#include "ImageData.h"
+}
+
+using namespace Graphics;
+
+#define CANVAS_WIDTH 240
+#define CANVAS_HEIGHT 280
+
+// ========================================
+// POMIAR I RAPORT
+// ========================================
+static uint32_t repeat = 5;
+
+static uint64_t wall_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+// Najkrótszy z powtórzonych przebiegów, w Mpixel/s
+template<typename Fn>
+static double measure(uint64_t pixels, Fn&& fn) {
+    uint64_t best = UINT64_MAX;
+    for (uint32_t i = 0; i < repeat; i++) {
+        const uint64_t t0 = wall_ns();
+        fn();
+        const uint64_t t = wall_ns() - t0;
+        if (t < best) best = t;
+    }
+    return best ? pixels * 1e3 / best : 0.0;
+}
+
+static bool report(const char* scenario, const char* what, double mpixels, uint64_t checked, uint64_t wrong) {
+    char speed[16] = "";
+    if (mpixels > 0) snprintf(speed, sizeof(speed), "%.1f", mpixels);
+    printf("%-10s %-30s %10s %11llu %8llu  %s\n", scenario, what, speed, static_cast<unsigned long long>(checked),
+           static_cast<unsigned long long>(wrong), wrong ? "FAIL" : "ok");
+    return wrong == 0;
+}
+
+// ========================================
+// FORMATS: PRZEJŚCIA TAM I Z POWROTEM
+// ========================================
+// Kanał obcięty do bits bitów i rozwinięty powtórzeniem jak w dekoderach formatów
+static uint8_t quantize(uint8_t value, uint8_t bits) {
+    const uint32_t top = value >> (8 - bits);
+    uint32_t out = 0;
+    for (int shift = 8 - bits; shift > -bits; shift -= bits) {
+        out |= shift >= 0 ? top << shift : top >> -shift;
+    }
+    return static_cast<uint8_t>(out);
+}
+
+template<typename Format> struct FormatInfo;
+template<> struct FormatInfo<Rgb444> {
+    static constexpr const char* name = "rgb444";
+    static constexpr uint8_t bits[3] = {4, 4, 4};
+};
+template<> struct FormatInfo<Rgb565> {
+    static constexpr const char* name = "rgb565";
+    static constexpr uint8_t bits[3] = {5, 6, 5};
+};
+template<> struct FormatInfo<Rgb666> {
+    static constexpr const char* name = "rgb666";
+    static constexpr uint8_t bits[3] = {6, 6, 6};
+};
+
+template<typename Format>
+static bool sameStorage(typename Format::Storage a, typename Format::Storage b) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+template<typename Format>
+static bool checkFormat() {
+    using Info = FormatInfo<Format>;
+    const uint32_t values = 1u << (Info::bits[0] + Info::bits[1] + Info::bits[2]);
+    uint64_t checked = 0, wrong = 0;
+    char what[48];      // nazwa przypadku i błąd mieszczą się zawsze
+
+    // Każda wartość natywna: decode -> encode, pack -> unpack -> pack, RGB::fromColorDepth
+    for (uint32_t v = 0; v < values; v++) {
+        const RGB c = Format::decode(v);
+        const typename Format::Storage s = Format::pack(c);
+        wrong += Format::encode(c) != v;
+        wrong += Format::unpack(s) != c;
+        wrong += !sameStorage<Format>(Format::pack(Format::unpack(s)), s);
+        wrong += RGB::fromColorDepth(v, Format::depth) != c;
+        checked += 4;
+    }
+
+    // Każdy kolor 24-bitowy: decode(encode) = unpack(pack) = kanały obcięte i powtórzone
+    for (uint32_t rgb = 0; rgb < (1u << 24); rgb++) {
+        const RGB c(static_cast<uint8_t>(rgb >> 16), static_cast<uint8_t>(rgb >> 8), static_cast<uint8_t>(rgb));
+        const RGB want(quantize(c.r, Info::bits[0]), quantize(c.g, Info::bits[1]), quantize(c.b, Info::bits[2]));
+        const uint32_t v = Format::encode(c);
+        wrong += Format::decode(v) != want;
+        wrong += Format::unpack(Format::pack(c)) != want;
+        wrong += c.toColorDepth(Format::depth) != v;
+        checked += 3;
+    }
+    snprintf(what, sizeof(what), "%s round trips", Info::name);
+    return report("formats", what, 0, checked, wrong);
+}
+
+template<typename Format>
+static bool benchCanvas() {
+    using Info = FormatInfo<Format>;
+    static typename Format::Storage buffer[CANVAS_WIDTH * CANVAS_HEIGHT];
+    PixelCanvas<Format> canvas(CANVAS_WIDTH, CANVAS_HEIGHT, buffer);
+    const uint64_t pixels = static_cast<uint64_t>(CANVAS_WIDTH) * CANVAS_HEIGHT;
+    bool ok = true;
+    char what[32];
+
+    // drawPixel wzorem, getPixel musi oddać kolor po kwantyzacji formatu
+    auto color = [](uint32_t x, uint32_t y) {
+        return RGB(static_cast<uint8_t>(x * 7 + y), static_cast<uint8_t>(x ^ y * 3), static_cast<uint8_t>(y * 5 - x));
+    };
+    const double draw = measure(pixels, [&] {
+        for (uint16_t y = 0; y < CANVAS_HEIGHT; y++) {
+            for (uint16_t x = 0; x < CANVAS_WIDTH; x++) canvas.drawPixel(x, y, color(x, y));
+        }
+    });
+    uint64_t wrong = 0;
+    for (uint16_t y = 0; y < CANVAS_HEIGHT; y++) {
+        for (uint16_t x = 0; x < CANVAS_WIDTH; x++) {
+            wrong += canvas.getPixel(x, y) != Format::unpack(Format::pack(color(x, y)));
+        }
+    }
+    snprintf(what, sizeof(what), "%s drawPixel", Info::name);
+    ok &= report("formats", what, draw, pixels, wrong);
+
+    // clear kolejnymi kolorami, na końcu cały bufor w ostatnim
+    uint8_t shade = 0;
+    const double clear = measure(pixels, [&] {
+        canvas.clear(RGB(shade, static_cast<uint8_t>(255 - shade), 0x5A));
+        shade += 17;
+    });
+    const RGB last(static_cast<uint8_t>(shade - 17), static_cast<uint8_t>(255 - (shade - 17)), 0x5A);
+    wrong = 0;
+    for (uint16_t y = 0; y < CANVAS_HEIGHT; y++) {
+        for (uint16_t x = 0; x < CANVAS_WIDTH; x++) {
+            wrong += canvas.getPixel(x, y) != Format::unpack(Format::pack(last));
+        }
+    }
+    snprintf(what, sizeof(what), "%s clear", Info::name);
+    ok &= report("formats", what, clear, pixels, wrong);
+    return ok;
+}
+
+static bool runFormats() {
+    bool ok = checkFormat<Rgb444>();
+    ok &= checkFormat<Rgb565>();
+    ok &= checkFormat<Rgb666>();
+    ok &= benchCanvas<Rgb444>();
+    ok &= benchCanvas<Rgb565>();
+    ok &= benchCanvas<Rgb666>();
+    return ok;
+}
+
+// ========================================
+// LINES: PASY I STARY STEMPEL
+// ========================================
+struct Line {
+    int16_t x0, y0, x1, y1;
+    uint8_t thickness;
+    LineCap cap;
+};
+
+static uint64_t isqrtRef(uint64_t v) {
+    uint64_t r = static_cast<uint64_t>(sqrt(static_cast<double>(v)));
+    while (r * r > v) r--;
+    while ((r + 1) * (r + 1) <= v) r++;
+    return r;
+}
+
+// Środek piksela w linii, sprawdzany wprost dla każdego piksela w int64
+static bool lineCovers(const Line& l, int64_t x, int64_t y) {
+    const int64_t t = l.thickness;
+    const int64_t dx = l.x1 - l.x0, dy = l.y1 - l.y0;
+    const int64_t rx = x - l.x0, ry = y - l.y0;
+
+    if (t <= 1) {
+        // Bresenham bez obcinania - piksel po pikselu
+        int64_t px = l.x0, py = l.y0, err = llabs(dx) - llabs(dy);
+        while (true) {
+            if (px == x && py == y) return true;
+            if (px == l.x1 && py == l.y1) return false;
+            const int64_t e2 = 2 * err;
+            if (e2 > -llabs(dy)) { err -= llabs(dy); px += dx > 0 ? 1 : -1; }
+            if (e2 < llabs(dx)) { err += llabs(dx); py += dy > 0 ? 1 : -1; }
+        }
+    }
+
+    const int64_t lengthSq = dx * dx + dy * dy;
+    if (lengthSq == 0 && l.cap != LineCap::Round) {
+        return rx >= -t / 2 && rx < t - t / 2 && ry >= -t / 2 && ry < t - t / 2;
+    }
+    if (l.cap == LineCap::Round) {
+        if (4 * (rx * rx + ry * ry) <= t * t) return true;
+        const int64_t ex = x - l.x1, ey = y - l.y1;
+        if (4 * (ex * ex + ey * ey) <= t * t) return true;
+        if (lengthSq == 0) return false;
+    }
+    const int64_t halfWidth = t * static_cast<int64_t>(isqrtRef(static_cast<uint64_t>(lengthSq) * 256)) / 2;
+    const int64_t extra = l.cap == LineCap::Square ? halfWidth : 0;
+    const int64_t across = 16 * (dy * rx - dx * ry);
+    const int64_t along = 16 * (dx * rx + dy * ry);
+    return llabs(across) <= halfWidth && along >= -extra && along <= lengthSq * 16 + extra;
+}
+
+// Dawne drawLine: kwadrat (t/2 * 2 + 1)^2 w każdym kroku Bresenhama, liczy zapisy
+static uint64_t stampLine(Rgb565::Storage* buffer, const Line& l, Rgb565::Storage value) {
+    int16_t x0 = l.x0, y0 = l.y0;
+    const int16_t dx = abs(l.x1 - x0), dy = abs(l.y1 - y0);
+    const int16_t sx = x0 < l.x1 ? 1 : -1, sy = y0 < l.y1 ? 1 : -1;
+    const int16_t offset = l.thickness / 2;
+    int16_t err = dx - dy;
+    uint64_t writes = 0;
+
+    while (true) {
+        for (int16_t tx = -offset; tx <= offset; ++tx) {
+            for (int16_t ty = -offset; ty <= offset; ++ty) {
+                const int16_t px = x0 + tx, py = y0 + ty;
+                if (px >= 0 && px < CANVAS_WIDTH && py >= 0 && py < CANVAS_HEIGHT) {
+                    buffer[py * CANVAS_WIDTH + px] = value;
+                    writes++;
+                }
+            }
+        }
+        if (x0 == l.x1 && y0 == l.y1) break;
+        const int16_t e2 = 2 * err;
+        if (e2 > -dy) { err -= dy; x0 += sx; }
+        if (e2 < dx) { err += dx; y0 += sy; }
+    }
+    return writes;
+}
+
+static const char* capName(LineCap cap) {
+    return cap == LineCap::Round ? "round" : cap == LineCap::Square ? "square" : "butt";
+}
+
+static bool runLines() {
+    static Rgb565::Storage buffer[CANVAS_WIDTH * CANVAS_HEIGHT];
+    PixelCanvas<Rgb565> canvas(CANVAS_WIDTH, CANVAS_HEIGHT, buffer);
+    const RGB ink(255, 255, 255);
+    const Rgb565::Storage inkValue = Rgb565::pack(ink), paper = Rgb565::pack(RGB());
+    bool ok = true;
+    char what[48];      // nazwa przypadku i błąd mieszczą się zawsze
+
+    // Jedna linia na czystym płótnie, porównana piksel po pikselu; zwraca liczbę pikseli
+    auto check = [&](const Line& l, uint64_t& wrong) {
+        canvas.clear(RGB());
+        canvas.drawLine(l.x0, l.y0, l.x1, l.y1, ink, l.thickness, l.cap);
+        uint64_t covered = 0;
+        for (int32_t y = 0; y < CANVAS_HEIGHT; y++) {
+            for (int32_t x = 0; x < CANVAS_WIDTH; x++) {
+                const bool want = lineCovers(l, x, y);
+                wrong += sameStorage<Rgb565>(buffer[y * CANVAS_WIDTH + x], inkValue) != want;
+                covered += want;
+            }
+        }
+        return covered;
+    };
+
+    // Przypadki brzegowe ze znaną liczbą pikseli (-1: bez liczenia)
+    const struct {
+        const char* name;
+        Line line;
+        int64_t pixels;
+    } edges[] = {
+        {"vertical t=1", {3, 2, 3, 5, 1, LineCap::Butt}, 4},
+        {"vertical x=-1", {-1, 2, -1, 10, 1, LineCap::Butt}, 0},
+        {"vertical x=width", {CANVAS_WIDTH, 2, CANVAS_WIDTH, 10, 1, LineCap::Butt}, 0},
+        {"horizontal 6000 t=3", {-3000, 4, 3000, 4, 3, LineCap::Butt}, 3 * CANVAS_WIDTH},
+        {"vertical 6000 t=5", {100, -3000, 100, 3000, 5, LineCap::Square}, 5 * CANVAS_HEIGHT},
+        {"diagonal 9000 t=7", {-4000, -5000, 5000, 4000, 7, LineCap::Round}, -1},
+        {"far end 30000 t=9", {120, 140, 30000, -32000, 9, LineCap::Round}, -1},
+    };
+    for (const auto& edge : edges) {
+        uint64_t wrong = 0;
+        const uint64_t covered = check(edge.line, wrong);
+        if (edge.pixels >= 0) wrong += covered != static_cast<uint64_t>(edge.pixels);
+        ok &= report("lines", edge.name, 0, CANVAS_WIDTH * CANVAS_HEIGHT, wrong);
+    }
+
+    // Losowe linie każdej końcówki, w tym wychodzące daleko poza płótno
+    uint32_t seed = 12345;
+    auto next = [&seed](int32_t lo, int32_t hi) {
+        seed = seed * 1103515245u + 12345u;
+        return lo + static_cast<int32_t>((seed >> 8) % static_cast<uint32_t>(hi - lo + 1));
+    };
+    for (LineCap cap : {LineCap::Butt, LineCap::Square, LineCap::Round}) {
+        uint64_t wrong = 0, checked = 0;
+        for (int i = 0; i < 60; i++) {
+            const int32_t span = i % 3 == 0 ? 6000 : 400;
+            const Line l = {static_cast<int16_t>(next(-span, span)), static_cast<int16_t>(next(-span, span)),
+                            static_cast<int16_t>(next(-60, CANVAS_WIDTH + 60)), static_cast<int16_t>(next(-60, CANVAS_HEIGHT + 60)),
+                            static_cast<uint8_t>(next(1, 40)), cap};
+            check(l, wrong);
+            checked += CANVAS_WIDTH * CANVAS_HEIGHT;
+        }
+        snprintf(what, sizeof(what), "random %s", capName(cap));
+        ok &= report("lines", what, 0, checked, wrong);
+    }
+
+    // Wachlarz 64 linii ze środka do brzegów: pasy kontra stary stempel
+    Line fan[64];
+    for (int i = 0; i < 64; i++) {
+        const int32_t side = i / 16, k = i % 16;
+        const int32_t ex = side == 0 ? k * CANVAS_WIDTH / 16 : side == 1 ? CANVAS_WIDTH - 1 : side == 2 ? CANVAS_WIDTH - 1 - k * CANVAS_WIDTH / 16 : 0;
+        const int32_t ey = side == 0 ? 0 : side == 1 ? k * CANVAS_HEIGHT / 16 : side == 2 ? CANVAS_HEIGHT - 1 : CANVAS_HEIGHT - 1 - k * CANVAS_HEIGHT / 16;
+        fan[i] = {CANVAS_WIDTH / 2, CANVAS_HEIGHT / 2, static_cast<int16_t>(ex), static_cast<int16_t>(ey), 1, LineCap::Butt};
+    }
+    for (uint8_t t : {3, 9, 25}) {
+        uint64_t covered = 0, stampWrites = 0;
+        for (Line& l : fan) {
+            l.thickness = t;
+            canvas.clear(RGB());
+            canvas.drawLine(l.x0, l.y0, l.x1, l.y1, ink, t);
+            for (size_t i = 0; i < CANVAS_WIDTH * CANVAS_HEIGHT; i++) covered += !sameStorage<Rgb565>(buffer[i], paper);
+            stampWrites += stampLine(buffer, l, inkValue);
+        }
+        // Pasy piszą każdy piksel raz, więc zapisy = pokryte piksele
+        const double spans = measure(covered, [&] {
+            for (const Line& l : fan) canvas.drawLine(l.x0, l.y0, l.x1, l.y1, ink, t);
+        });
+        const double stamp = measure(covered, [&] {
+            for (const Line& l : fan) stampLine(buffer, l, inkValue);
+        });
+        snprintf(what, sizeof(what), "fan t=%u spans", t);
+        ok &= report("lines", what, spans, covered, 0);
+        snprintf(what, sizeof(what), "fan t=%u stamp", t);
+        ok &= report("lines", what, stamp, stampWrites, 0);
+    }
+    return ok;
+}
+
+// ========================================
+// AA: LINIE WU I OBRAZ WZORCOWY
+// ========================================
+// Wzorzec Wu w double: pokrycie dwóch pikseli przy dokładnym położeniu na osi krótszej
+static void wuReference(const Line& l, double* coverage) {
+    const bool steep = abs(l.y1 - l.y0) > abs(l.x1 - l.x0);
+    double a0 = steep ? l.y0 : l.x0, b0 = steep ? l.x0 : l.y0;
+    double a1 = steep ? l.y1 : l.x1, b1 = steep ? l.x1 : l.y1;
+    if (a0 > a1) {
+        std::swap(a0, a1);
+        std::swap(b0, b1);
+    }
+    const int32_t limit = (steep ? CANVAS_HEIGHT : CANVAS_WIDTH) - 1;
+    for (int32_t a = std::max<int32_t>(a0, 0); a <= std::min<int32_t>(a1, limit); a++) {
+        const double b = a1 == a0 ? b0 : b0 + (b1 - b0) * (a - a0) / (a1 - a0);
+        const double base = floor(b);
+        for (int k = 0; k < 2; k++) {
+            const double bk = base + k;
+            const double x = steep ? bk : a, y = steep ? a : bk;
+            if (x < 0 || x >= CANVAS_WIDTH || y < 0 || y >= CANVAS_HEIGHT) continue;
+            coverage[static_cast<int32_t>(y) * CANVAS_WIDTH + static_cast<int32_t>(x)] = k ? b - base : 1.0 - (b - base);
+        }
+    }
+}
+
+template<typename Format>
+static bool benchLineAA(const Line* lines, size_t count) {
+    using Info = FormatInfo<Format>;
+    static typename Format::Storage buffer[CANVAS_WIDTH * CANVAS_HEIGHT];
+    PixelCanvas<Format> canvas(CANVAS_WIDTH, CANVAS_HEIGHT, buffer);
+    char what[48];      // nazwa przypadku i błąd mieszczą się zawsze
+
+    uint64_t plotted = 0;
+    for (size_t i = 0; i < count; i++) {
+        // Dwa piksele na krok osi głównej obciętej do płótna
+        const Line& l = lines[i];
+        const bool steep = abs(l.y1 - l.y0) > abs(l.x1 - l.x0);
+        const int32_t a0 = steep ? l.y0 : l.x0, a1 = steep ? l.y1 : l.x1;
+        const int32_t limit = (steep ? CANVAS_HEIGHT : CANVAS_WIDTH) - 1;
+        plotted += 2 * std::max<int32_t>(std::min(std::max(a0, a1), limit) - std::max(std::min(a0, a1), 0) + 1, 0);
+    }
+    const double speed = measure(plotted, [&] {
+        for (size_t i = 0; i < count; i++) canvas.drawLineAA(lines[i].x0, lines[i].y0, lines[i].x1, lines[i].y1, RGB(255, 255, 255));
+    });
+    snprintf(what, sizeof(what), "%s throughput", Info::name);
+    return report("aa", what, speed, plotted, 0);
+}
+
+static bool runLineAA() {
+    static Rgb666::Storage buffer[CANVAS_WIDTH * CANVAS_HEIGHT];
+    static double coverage[CANVAS_WIDTH * CANVAS_HEIGHT];
+    PixelCanvas<Rgb666> canvas(CANVAS_WIDTH, CANVAS_HEIGHT, buffer);
+    bool ok = true;
+    char what[48];      // nazwa i błąd o dowolnej liczbie cyfr bez obcinania
+
+    // Biała linia na czarnym Rgb666: kanał = pokrycie * 255 z dokładnością
+    // kwantyzacji do 6 bitów i 8-bitowego ułamka pozycji
+    const int32_t tolerance = 8;
+    uint32_t seed = 777;
+    auto next = [&seed](int32_t lo, int32_t hi) {
+        seed = seed * 1103515245u + 12345u;
+        return lo + static_cast<int32_t>((seed >> 8) % static_cast<uint32_t>(hi - lo + 1));
+    };
+    auto compare = [&](const char* name, const Line* lines, size_t count) {
+        uint64_t checked = 0, wrong = 0;
+        int32_t worst = 0;
+        for (size_t i = 0; i < count; i++) {
+            const Line& l = lines[i];
+            canvas.clear(RGB());
+            canvas.drawLineAA(l.x0, l.y0, l.x1, l.y1, RGB(255, 255, 255));
+            memset(coverage, 0, sizeof(coverage));
+            wuReference(l, coverage);
+            for (size_t p = 0; p < CANVAS_WIDTH * CANVAS_HEIGHT; p++) {
+                const RGB got = Rgb666::unpack(buffer[p]);
+                const int32_t want = static_cast<int32_t>(lround(coverage[p] * 255));
+                for (int32_t channel : {got.r, got.g, got.b}) {
+                    const int32_t err = abs(channel - want);
+                    worst = std::max(worst, err);
+                    wrong += err > tolerance;
+                    checked++;
+                }
+            }
+        }
+        snprintf(what, sizeof(what), "%s, max err %d/255", name, worst);
+        return report("aa", what, 0, checked, wrong);
+    };
+
+    Line inside[200], far[40];
+    for (Line& l : inside) {
+        l = {static_cast<int16_t>(next(-40, CANVAS_WIDTH + 40)), static_cast<int16_t>(next(-40, CANVAS_HEIGHT + 40)),
+             static_cast<int16_t>(next(-40, CANVAS_WIDTH + 40)), static_cast<int16_t>(next(-40, CANVAS_HEIGHT + 40)), 1, LineCap::Butt};
+    }
+    // Końce daleko poza płótnem: (b1 - b0) * 65536 i b0 * 65536 poza int32
+    for (Line& l : far) {
+        l = {static_cast<int16_t>(next(-32000, 32000)), static_cast<int16_t>(next(-32000, 32000)),
+             static_cast<int16_t>(next(0, CANVAS_WIDTH - 1)), static_cast<int16_t>(next(0, CANVAS_HEIGHT - 1)), 1, LineCap::Butt};
+    }
+    far[0] = {-20000, -20000, 20000, 20000, 1, LineCap::Butt};
+    far[1] = {-30000, 10, 30000, 40, 1, LineCap::Butt};
+    ok &= compare("near canvas", inside, 200);
+    ok &= compare("off canvas", far, 40);
+
+    ok &= benchLineAA<Rgb444>(inside, 200);
+    ok &= benchLineAA<Rgb565>(inside, 200);
+    ok &= benchLineAA<Rgb666>(inside, 200);
+    return ok;
+}
+
+// ========================================
+// BLIT: KOPIE OBRAZU KONTRA PAINT_DRAWIMAGE
+// ========================================
+template<typename Format>
+static bool benchBlit(const Image<Rgb565>& picture, const uint8_t* mask, const Rgb565::Storage* paintBuffer) {
+    using Info = FormatInfo<Format>;
+    static typename Format::Storage buffer[CANVAS_WIDTH * CANVAS_HEIGHT];
+    PixelCanvas<Format> canvas(CANVAS_WIDTH, CANVAS_HEIGHT, buffer);
+    const uint64_t pixels = static_cast<uint64_t>(CANVAS_WIDTH) * CANVAS_HEIGHT;
+    const Rect all{0, 0, CANVAS_WIDTH - 1, CANVAS_HEIGHT - 1};
+    const RGB paper(0, 0, 255);
+    const Rgb565::Storage key = Rgb565::pack(RGB(255, 255, 255));
+    bool ok = true;
+    char what[32];
+
+    // Piksel obrazu przepisany do formatu płótna
+    auto converted = [&](size_t i) { return Format::pack(Rgb565::unpack(picture.pixels[i])); };
+    auto countWrong = [&](auto want) {
+        uint64_t wrong = 0;
+        for (size_t i = 0; i < pixels; i++) wrong += !sameStorage<Format>(buffer[i], want(i));
+        return wrong;
+    };
+
+    const double plain = measure(pixels, [&] { canvas.blit(picture, all, 0, 0); });
+    uint64_t wrong = countWrong(converted);
+    // Ten sam format: bufor Paint (Scale 65, bajty jak na panelu) musi być identyczny
+    if constexpr (std::is_same_v<Format, Rgb565>) wrong += memcmp(buffer, paintBuffer, sizeof(buffer)) != 0;
+    snprintf(what, sizeof(what), "%s blit", Info::name);
+    ok &= report("blit", what, plain, pixels, wrong);
+
+    canvas.clear(paper);
+    const double keyed = measure(pixels, [&] { canvas.blitKeyed(picture, all, 0, 0, RGB(255, 255, 255)); });
+    wrong = countWrong([&](size_t i) { return picture.pixels[i] == key ? Format::pack(paper) : converted(i); });
+    snprintf(what, sizeof(what), "%s blitKeyed white", Info::name);
+    ok &= report("blit", what, keyed, pixels, wrong);
+
+    canvas.clear(paper);
+    const double masked = measure(pixels, [&] { canvas.blitMasked(picture, mask, all, 0, 0); });
+    wrong = countWrong([&](size_t i) {
+        const size_t x = i % CANVAS_WIDTH, y = i / CANVAS_WIDTH;
+        return mask[y * (CANVAS_WIDTH / 8) + x / 8] & (0x80 >> (x & 7)) ? converted(i) : Format::pack(paper);
+    });
+    snprintf(what, sizeof(what), "%s blitMasked circle", Info::name);
+    ok &= report("blit", what, masked, pixels, wrong);
+    return ok;
+}
+
+static bool runBlit() {
+    static Rgb565::Storage picturePixels[CANVAS_WIDTH * CANVAS_HEIGHT], paintBuffer[CANVAS_WIDTH * CANVAS_HEIGHT];
+    static uint8_t mask[CANVAS_WIDTH / 8 * CANVAS_HEIGHT];
+    const uint64_t pixels = static_cast<uint64_t>(CANVAS_WIDTH) * CANVAS_HEIGHT;
+
+    // Tablica z ImageData.c ma młodszy bajt pierwszy, płótno RGB565 - kolejność panelu
+    for (size_t i = 0; i < pixels; i++) {
+        picturePixels[i] = Rgb565::toStorage(static_cast<uint16_t>(gImage_1IN69_PIC[2 * i + 1] << 8 | gImage_1IN69_PIC[2 * i]));
+    }
+    const Image<Rgb565> picture{picturePixels, CANVAS_WIDTH, CANVAS_HEIGHT};
+
+    // Maska: koło wpisane w płótno
+    for (int32_t y = 0; y < CANVAS_HEIGHT; y++) {
+        for (int32_t x = 0; x < CANVAS_WIDTH; x++) {
+            const int32_t dx = x - CANVAS_WIDTH / 2, dy = y - CANVAS_HEIGHT / 2;
+            if (dx * dx + dy * dy <= 115 * 115) mask[y * (CANVAS_WIDTH / 8) + x / 8] |= 0x80 >> (x & 7);
+        }
+    }
+
+    // Punkt odniesienia: jak w examples/LCD_1in69_test.c
+    Paint_NewImage(reinterpret_cast<UBYTE*>(paintBuffer), CANVAS_WIDTH, CANVAS_HEIGHT, 0, 0xFFFF);
+    Paint_SetScale(65);
+    const double paint = measure(pixels, [] { Paint_DrawImage(gImage_1IN69_PIC, 0, 0, CANVAS_WIDTH, CANVAS_HEIGHT); });
+    bool ok = report("blit", "Paint_DrawImage", paint, 0, 0);
+
+    ok &= benchBlit<Rgb565>(picture, mask, paintBuffer);
+    ok &= benchBlit<Rgb444>(picture, mask, paintBuffer);
+    return ok;
+}
+
+// ========================================
+// PACKED: DEKODOWANIE SPAKOWANYCH OBRAZÓW
+// ========================================
+// Ten sam prosty generator liniowy wszędzie, żeby wyniki były powtarzalne
+static uint32_t nextRandom(uint32_t& seed) {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+// Piksel obrazu z ImageData.c (młodszy bajt pierwszy) w formacie płótna
+template<typename Format>
+static typename Format::Storage rawPixel(const unsigned char* raw, size_t i) {
+    return Format::pack(Rgb565::decode(static_cast<uint16_t>(raw[2 * i + 1] << 8 | raw[2 * i])));
+}
+
+template<typename Format>
+static uint64_t checkDecodeRows(const PackedImage& image, const unsigned char* raw, uint64_t& checked) {
+    typename Format::Storage row[CANVAS_WIDTH + 2];
+    const typename Format::Storage guard = Format::pack(RGB(1, 2, 3));
+    uint32_t seed = image.width * 31u + image.height;
+    uint64_t wrong = 0;
+
+    for (uint16_t y = 0; y < image.height; y++) {
+        // Cały wiersz, potem losowy kawałek; strażnicy po obu stronach nie mogą się zmienić
+        for (int part = 0; part < 2; part++) {
+            uint16_t skip = 0, count = image.width;
+            if (part == 1) {
+                skip = static_cast<uint16_t>(nextRandom(seed) % image.width);
+                count = static_cast<uint16_t>(1 + nextRandom(seed) % (image.width - skip));
+            }
+            row[0] = row[count + 1] = guard;
+            decodeRow<Format>(image, y, skip, count, row + 1);
+            for (uint16_t i = 0; i < count; i++) {
+                wrong += !sameStorage<Format>(row[1 + i], rawPixel<Format>(raw, static_cast<size_t>(y) * image.width + skip + i));
+            }
+            wrong += !sameStorage<Format>(row[0], guard) + !sameStorage<Format>(row[count + 1], guard);
+            checked += count + 2;
+        }
+    }
+    return wrong;
+}
+
+// drawImage w pozycjach obcinanych przy każdej krawędzi, reszta płótna nietknięta
+template<typename Format>
+static uint64_t checkDrawImage(const PackedImage& image, const unsigned char* raw, uint64_t& checked) {
+    static typename Format::Storage buffer[CANVAS_WIDTH * CANVAS_HEIGHT];
+    PixelCanvas<Format> canvas(CANVAS_WIDTH, CANVAS_HEIGHT, buffer);
+    const RGB paper(1, 2, 3);
+    const int16_t places[][2] = {{0, 0}, {-37, -50}, {static_cast<int16_t>(CANVAS_WIDTH - 60), static_cast<int16_t>(CANVAS_HEIGHT - 45)},
+                                 {-5, static_cast<int16_t>(CANVAS_HEIGHT - 10)}, {static_cast<int16_t>(CANVAS_WIDTH + 1), 0}};
+    uint64_t wrong = 0;
+
+    for (const auto& place : places) {
+        canvas.clear(paper);
+        canvas.drawImage(image, place[0], place[1]);
+        for (int32_t y = 0; y < CANVAS_HEIGHT; y++) {
+            for (int32_t x = 0; x < CANVAS_WIDTH; x++) {
+                const int32_t ix = x - place[0], iy = y - place[1];
+                const bool inside = ix >= 0 && ix < image.width && iy >= 0 && iy < image.height;
+                const typename Format::Storage want = inside ? rawPixel<Format>(raw, static_cast<size_t>(iy) * image.width + ix) : Format::pack(paper);
+                wrong += !sameStorage<Format>(buffer[y * CANVAS_WIDTH + x], want);
+            }
+        }
+        checked += CANVAS_WIDTH * CANVAS_HEIGHT;
+    }
+    return wrong;
+}
+
+static bool runPacked() {
+    const struct {
+        const char* name;
+        const PackedImage& image;
+        const unsigned char* raw;
+    } images[] = {
+        {"1IN69_PIC", gImage_1IN69_PIC_packed, gImage_1IN69_PIC},
+        {"up", gImage_up_packed, gImage_up},
+        {"down", gImage_down_packed, gImage_down},
+        {"right", gImage_right_packed, gImage_right},
+        {"left", gImage_left_packed, gImage_left},
+        {"long_press", gImage_long_press_packed, gImage_long_press},
+        {"double_click", gImage_double_click_packed, gImage_double_click},
+    };
+    bool ok = true;
+    char what[40];
+
+    for (const auto& img : images) {
+        uint64_t checked = 0;
+        uint64_t wrong = checkDecodeRows<Rgb565>(img.image, img.raw, checked);
+        wrong += checkDecodeRows<Rgb444>(img.image, img.raw, checked);
+        wrong += checkDecodeRows<Rgb666>(img.image, img.raw, checked);
+        wrong += checkDrawImage<Rgb565>(img.image, img.raw, checked);
+        wrong += checkDrawImage<Rgb444>(img.image, img.raw, checked);
+        wrong += checkDrawImage<Rgb666>(img.image, img.raw, checked);
+        snprintf(what, sizeof(what), "%s %zu/%u B", img.name, img.image.getPackedSize(), img.image.width * img.image.height * 2u);
+        ok &= report("packed", what, 0, checked, wrong);
+    }
+
+    // Szybkość: całe zdjęcie dekodowane na płótno kontra kopia surowego obrazu
+    static Rgb565::Storage rawPixels[CANVAS_WIDTH * CANVAS_HEIGHT], buffer[CANVAS_WIDTH * CANVAS_HEIGHT];
+    const uint64_t pixels = static_cast<uint64_t>(CANVAS_WIDTH) * CANVAS_HEIGHT;
+    for (size_t i = 0; i < pixels; i++) rawPixels[i] = rawPixel<Rgb565>(gImage_1IN69_PIC, i);
+    PixelCanvas<Rgb565> canvas(CANVAS_WIDTH, CANVAS_HEIGHT, buffer);
+    const Image<Rgb565> picture{rawPixels, CANVAS_WIDTH, CANVAS_HEIGHT};
+    const double decode = measure(pixels, [&] { canvas.drawImage(gImage_1IN69_PIC_packed, 0, 0); });
+    ok &= report("packed", "1IN69_PIC drawImage", decode, 0, 0);
+    const double copy = measure(pixels, [&] { canvas.blit(picture, Rect{0, 0, CANVAS_WIDTH - 1, CANVAS_HEIGHT - 1}, 0, 0); });
+    ok &= report("packed", "1IN69_PIC blit raw", copy, 0, 0);
+    return ok;
+}
+
+// ========================================
+// POLYGONS: LIMIT WIERZCHOŁKÓW
+// ========================================
+// Reguła lewej krawędzi dla całkowitego y: piksel x wypełniony, gdy nieparzyście wiele
+// krawędzi [top, bottom) przecina wiersz w xe <= x (porównanie dokładne, bez dzielenia)
+static bool polygonCovers(const Point* points, uint8_t count, int64_t x, int64_t y) {
+    bool inside = false;
+    for (uint8_t i = 0; i < count; i++) {
+        Point a = points[i], b = points[(i + 1) % count];
+        if (a.y > b.y) std::swap(a, b);
+        if (y < a.y || y >= b.y) continue;
+        const int64_t dy = b.y - a.y;
+        inside ^= static_cast<int64_t>(a.x) * dy + static_cast<int64_t>(b.x - a.x) * (y - a.y) <= x * dy;
+    }
+    return inside;
+}
+
+static bool runPolygons() {
+    static Rgb565::Storage drawn[CANVAS_WIDTH * CANVAS_HEIGHT], replayed[CANVAS_WIDTH * CANVAS_HEIGHT];
+    static uint8_t memory[4096];
+    PixelCanvas<Rgb565> canvas(CANVAS_WIDTH, CANVAS_HEIGHT, drawn), copy(CANVAS_WIDTH, CANVAS_HEIGHT, replayed);
+    const Rgb565::Storage ink = Rgb565::pack(RGB(255, 255, 255));
+    bool ok = true;
+
+    // Wielokąt foremny o count wierzchołkach, środek na płótnie
+    Point points[MaxPolygonPoints + 1];
+    auto regular = [&points](uint8_t count) {
+        for (uint8_t i = 0; i < count; i++) {
+            const double angle = 6.283185307179586 * i / count + 0.1;
+            points[i] = {static_cast<int16_t>(lround(120 + 100 * cos(angle))), static_cast<int16_t>(lround(140 + 110 * sin(angle)))};
+        }
+    };
+
+    for (uint8_t count : {static_cast<uint8_t>(3), static_cast<uint8_t>(7), MaxPolygonPoints, static_cast<uint8_t>(MaxPolygonPoints + 1)}) {
+        regular(count);
+        const bool accepted = count <= MaxPolygonPoints;
+        Arena arena(memory, sizeof(memory));
+        DisplayList list(arena);
+        canvas.clear(RGB());
+        copy.clear(RGB());
+        canvas.fillPolygon(points, count, RGB(255, 255, 255));
+        uint64_t wrong = list.fillPolygon(points, count, RGB(255, 255, 255)) != accepted;
+        wrong += list.size() != (accepted ? 1 : 0);
+        list.replay(copy);
+
+        for (int32_t y = 0; y < CANVAS_HEIGHT; y++) {
+            for (int32_t x = 0; x < CANVAS_WIDTH; x++) {
+                const bool want = accepted && polygonCovers(points, count, x, y);
+                wrong += sameStorage<Rgb565>(drawn[y * CANVAS_WIDTH + x], ink) != want;
+                wrong += !sameStorage<Rgb565>(replayed[y * CANVAS_WIDTH + x], drawn[y * CANVAS_WIDTH + x]);
+            }
+        }
+        char what[32];
+        snprintf(what, sizeof(what), "%u vertices%s", count, accepted ? "" : ", refused");
+        ok &= report("polygons", what, 0, 2 * CANVAS_WIDTH * CANVAS_HEIGHT, wrong);
+    }
+    return ok;
+}
+
+// ========================================
+// BLEND: MIESZANIE KONTRA WZORZEC W DOUBLE
+// ========================================
+static RGB randomColor(uint32_t& seed) {
+    const uint32_t v = nextRandom(seed);
+    return RGB(static_cast<uint8_t>(v), static_cast<uint8_t>(v >> 8), static_cast<uint8_t>(nextRandom(seed)));
+}
+
+// Największa różnica kanału (w jednostkach 8 bitów) między kolorem a wzorcem
+static double channelError(const RGB& got, double r, double g, double b) {
+    return std::max({fabs(got.r - r), fabs(got.g - g), fabs(got.b - b)});
+}
+
+// Granica błędu jednego mieszania w jednostkach 8-bitowego kanału. Wynik jest obcinany
+// w dół do formatu, więc traci do kroku najwęższego kanału (255 / 15 w RGB444), plus 1.5
+// z alfy 0 - 255 liczonej jako 0 - 256. Tryb szybki obcina alfę do 4 (RGB444) lub
+// 5 (RGB565) bitów: pół kroku alfy z pełnej różnicy kanałów
+template<typename Format>
+static double blendBound(bool precise) {
+    using Info = FormatInfo<Format>;
+    const uint8_t bits = std::min({Info::bits[0], Info::bits[1], Info::bits[2]});
+    const uint8_t alphaBits = std::is_same<Format, Rgb444>::value ? 4 : std::is_same<Format, Rgb565>::value ? 5 : 8;
+    const double step = 255.0 / ((1 << bits) - 1);
+    return step + 1.5 + (precise || alphaBits == 8 ? 0.0 : 255.0 / (2 << alphaBits));
+}
+
+template<typename Format, bool Precise>
+static bool checkBlend() {
+    using Info = FormatInfo<Format>;
+    const double bound = blendBound<Format>(Precise);
+    uint32_t seed = 4242;
+    uint64_t checked = 0, wrong = 0;
+    double worst = 0;
+
+    // Losowe pary pikseli plus skrajne wartości, każda alfa 0 - 255
+    for (uint32_t pair = 0; pair < 4096; pair++) {
+        RGB bg = randomColor(seed), fg = randomColor(seed);
+        if (pair == 0) bg = RGB(), fg = RGB(255, 255, 255);
+        if (pair == 1) bg = RGB(255, 255, 255), fg = RGB();
+        const typename Format::Storage b = Format::pack(bg), f = Format::pack(fg);
+        const RGB bq = Format::unpack(b), fq = Format::unpack(f);
+        for (uint32_t alpha = 0; alpha < 256; alpha++) {
+            const double w = alpha / 255.0;
+            const RGB got = Format::unpack(Format::template blend<Precise>(b, f, static_cast<uint8_t>(alpha)));
+            const double err = channelError(got, bq.r + (fq.r - bq.r) * w, bq.g + (fq.g - bq.g) * w, bq.b + (fq.b - bq.b) * w);
+            worst = std::max(worst, err);
+            wrong += err > bound;
+            checked++;
+        }
+    }
+
+    char what[48];      // nazwa przypadku i błąd mieszczą się zawsze
+    snprintf(what, sizeof(what), "%s blend %s %.1f/%.1f", Info::name, Precise ? "precise" : "fast", worst, bound);
+    return report("blend", what, 0, checked, wrong);
+}
+
+// Kompozycja to dwa mieszania (krycie warstwy i tło pod nią), błąd alfy raz
+template<typename Format, bool Precise>
+static bool checkComposite() {
+    using Info = FormatInfo<Format>;
+    const double bound = 2 * blendBound<Format>(true) + (blendBound<Format>(Precise) - blendBound<Format>(true));
+    static typename Format::Storage dst[64 * 64], layerPixels[64 * 64], before[64 * 64];
+    static uint8_t alpha[64 * 64];
+    PixelCanvas<Format> canvas(64, 64, dst), layer(64, 64, layerPixels);
+    const AlphaPrecision precision = Precise ? AlphaPrecision::Precise : AlphaPrecision::Fast;
+    uint32_t seed = 99;
+    uint64_t checked = 0, wrong = 0;
+    double worst = 0;
+
+    // Warstwa z kolorami przemnożonymi przez własną alfę, kilka krycia całej warstwy
+    for (uint32_t opacity : {255u, 200u, 128u, 37u}) {
+        for (size_t i = 0; i < 64 * 64; i++) {
+            const RGB c = randomColor(seed);
+            alpha[i] = static_cast<uint8_t>(i < 64 ? i * 4 : nextRandom(seed));
+            if (i % 97 == 0) alpha[i] = 255;
+            const double a = alpha[i] / 255.0;
+            layerPixels[i] = Format::pack(RGB(static_cast<uint8_t>(c.r * a), static_cast<uint8_t>(c.g * a), static_cast<uint8_t>(c.b * a)));
+            dst[i] = before[i] = Format::pack(randomColor(seed));
+        }
+        canvas.compositeLayer(layer, alpha, 0, 0, static_cast<uint8_t>(opacity), precision);
+
+        // dst = src * k + dst * (1 - a * k), k = krycie warstwy
+        const double k = opacity / 255.0;
+        for (size_t i = 0; i < 64 * 64; i++) {
+            const RGB src = Format::unpack(layerPixels[i]), old = Format::unpack(before[i]);
+            const double keep = 1.0 - alpha[i] / 255.0 * k;
+            const double err = channelError(Format::unpack(dst[i]), src.r * k + old.r * keep, src.g * k + old.g * keep, src.b * k + old.b * keep);
+            worst = std::max(worst, err);
+            wrong += err > bound;
+            checked++;
+        }
+    }
+
+    char what[32];
+    snprintf(what, sizeof(what), "%s comp %s %.1f/%.1f", Info::name, Precise ? "precise" : "fast", worst, bound);
+    return report("blend", what, 0, checked, wrong);
+}
+
+// Mieszanie bufora kolorem ze zmienną alfą, Mpixel/s
+template<typename Format, bool Precise>
+static bool benchBlend() {
+    using Info = FormatInfo<Format>;
+    static typename Format::Storage buffer[CANVAS_WIDTH * CANVAS_HEIGHT], layerPixels[CANVAS_WIDTH * CANVAS_HEIGHT];
+    static uint8_t alpha[CANVAS_WIDTH * CANVAS_HEIGHT];
+    const size_t pixels = CANVAS_WIDTH * CANVAS_HEIGHT;
+    const typename Format::Storage fg = Format::pack(RGB(255, 140, 0));
+    for (size_t i = 0; i < pixels; i++) {
+        buffer[i] = Format::pack(RGB(static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), 0x40));
+        alpha[i] = static_cast<uint8_t>(i * 7);
+        layerPixels[i] = Format::pack(RGB(static_cast<uint8_t>(alpha[i] / 2), 0, static_cast<uint8_t>(alpha[i] / 3)));
+    }
+    char what[48];      // nazwa przypadku i błąd mieszczą się zawsze
+
+    const double blend = measure(pixels, [&] {
+        for (size_t i = 0; i < pixels; i++) buffer[i] = Format::template blend<Precise>(buffer[i], fg, alpha[i]);
+    });
+    snprintf(what, sizeof(what), "%s blend %s", Info::name, Precise ? "precise" : "fast");
+    bool ok = report("blend", what, blend, 0, 0);
+
+    PixelCanvas<Format> canvas(CANVAS_WIDTH, CANVAS_HEIGHT, buffer), layer(CANVAS_WIDTH, CANVAS_HEIGHT, layerPixels);
+    const double composite = measure(pixels, [&] {
+        canvas.compositeLayer(layer, alpha, 0, 0, 255, Precise ? AlphaPrecision::Precise : AlphaPrecision::Fast);
+    });
+    snprintf(what, sizeof(what), "%s comp %s", Info::name, Precise ? "precise" : "fast");
+    ok &= report("blend", what, composite, 0, 0);
+    return ok;
+}
+
+static bool runBlend() {
+    bool ok = checkBlend<Rgb444, false>();
+    ok &= checkBlend<Rgb444, true>();
+    ok &= checkBlend<Rgb565, false>();
+    ok &= checkBlend<Rgb565, true>();
+    ok &= checkBlend<Rgb666, false>();
+    ok &= checkBlend<Rgb666, true>();
+    ok &= checkComposite<Rgb444, false>();
+    ok &= checkComposite<Rgb444, true>();
+    ok &= checkComposite<Rgb565, false>();
+    ok &= checkComposite<Rgb565, true>();
+    ok &= checkComposite<Rgb666, false>();
+    ok &= checkComposite<Rgb666, true>();
+    ok &= benchBlend<Rgb444, false>();
+    ok &= benchBlend<Rgb444, true>();
+    ok &= benchBlend<Rgb565, false>();
+    ok &= benchBlend<Rgb565, true>();
+    ok &= benchBlend<Rgb666, false>();
+    ok &= benchBlend<Rgb666, true>();
+    return ok;
+}
+
+// ========================================
+// FILLS: PROSTOKĄTY I LINIE KONTRA setPixel
+// ========================================
+struct FillCall {
+    int16_t x, y, w, h;
+};
+
+// Wzorzec: piksel po pikselu przez setPixel, każdy piksel sprawdzany z osobna
+template<typename Format>
+static void fillReference(PixelCanvas<Format>& canvas, const FillCall& r, typename Format::Storage value) {
+    for (int32_t y = r.y; y < r.y + r.h; y++) {
+        for (int32_t x = r.x; x < r.x + r.w; x++) {
+            if (x >= 0 && y >= 0 && x < CANVAS_WIDTH && y < CANVAS_HEIGHT) canvas.setPixel(x, y, value);
+        }
+    }
+}
+
+// Prostokąty przy każdej krawędzi, poza nią, puste i na całą szerokość (jedno wypełnienie w fillClipped)
+static const FillCall fillEdges[] = {
+    {-5, 10, 12, 7},
+    {CANVAS_WIDTH - 7, 10, 12, 7},
+    {10, -3, 9, 8},
+    {11, CANVAS_HEIGHT - 4, 9, 8},
+    {-10, -10, CANVAS_WIDTH + 20, CANVAS_HEIGHT + 20},
+    {-20, 5, 20, 5},
+    {CANVAS_WIDTH, 5, 3, 3},
+    {5, -8, 3, 8},
+    {5, CANVAS_HEIGHT, 3, 3},
+    {5, 5, 0, 5},
+    {5, 5, -3, 4},
+    {7, 9, 4, -2},
+    {0, 7, CANVAS_WIDTH, 5},
+    {-1, 20, CANVAS_WIDTH + 1, 3},
+    {CANVAS_WIDTH - 1, CANVAS_HEIGHT - 1, 1, 1},
+};
+
+template<typename Format>
+static bool checkFills() {
+    using Info = FormatInfo<Format>;
+    using Storage = typename Format::Storage;
+    // Wyrównanie do słowa: przesunięcie x o 0 - 3 daje każdy początek fill (dla Rgb666 wiersz ma 720 bajtów)
+    alignas(4) static Storage buffer[CANVAS_WIDTH * CANVAS_HEIGHT];
+    alignas(4) static Storage expected[CANVAS_WIDTH * CANVAS_HEIGHT];
+    PixelCanvas<Format> canvas(CANVAS_WIDTH, CANVAS_HEIGHT, buffer);
+    PixelCanvas<Format> reference(CANVAS_WIDTH, CANVAS_HEIGHT, expected);
+    uint64_t checked = 0, wrong = 0;
+    uint32_t seed = 777;
+    char what[32];
+
+    // Wywołanie fillRect, hLine albo vLine i ten sam obszar przez setPixel, potem cały bufor
+    uint32_t index = 0;
+    auto apply = [&](const FillCall& r, int kind) {
+        const RGB color(static_cast<uint8_t>(index * 37), static_cast<uint8_t>(index * 91 + 5), static_cast<uint8_t>(255 - index * 13));
+        index++;
+        FillCall ref = r;
+        if (kind == 0) {
+            canvas.fillRect(r.x, r.y, r.w, r.h, color);
+        } else if (kind == 1) {
+            canvas.hLine(r.x, r.y, r.w, color);
+            ref.h = 1;
+        } else {
+            canvas.vLine(r.x, r.y, r.h, color);
+            ref.w = 1;
+        }
+        fillReference(reference, ref, Format::pack(color));
+        wrong += memcmp(buffer, expected, sizeof(buffer)) != 0;
+        checked++;
+    };
+
+    canvas.clear(RGB(1, 2, 3));
+    reference.clear(RGB(1, 2, 3));
+    wrong += memcmp(buffer, expected, sizeof(buffer)) != 0;
+    for (const FillCall& r : fillEdges) {
+        for (int kind = 0; kind < 3; kind++) apply(r, kind);
+    }
+    // Początek pod każdym adresem i nieparzyste końce: x = 0 - 3, szerokość 0 - 13
+    for (int16_t x = 0; x < 4; x++) {
+        for (int16_t w = 0; w < 14; w++) {
+            apply(FillCall{x, static_cast<int16_t>(40 + w * 3), w, 2}, 0);
+            apply(FillCall{static_cast<int16_t>(CANVAS_WIDTH - 4 + x), static_cast<int16_t>(100 + w), w, 1}, 1);
+        }
+    }
+    for (int i = 0; i < 400; i++) {
+        const FillCall r = {static_cast<int16_t>(static_cast<int32_t>(nextRandom(seed) % (CANVAS_WIDTH + 80)) - 60),
+                            static_cast<int16_t>(static_cast<int32_t>(nextRandom(seed) % (CANVAS_HEIGHT + 80)) - 60),
+                            static_cast<int16_t>(static_cast<int32_t>(nextRandom(seed) % (CANVAS_WIDTH + 44)) - 4),
+                            static_cast<int16_t>(static_cast<int32_t>(nextRandom(seed) % 64) - 4)};
+        apply(r, i % 3);
+    }
+    snprintf(what, sizeof(what), "%s rects and lines", Info::name);
+    return report("fills", what, 0, checked, wrong);
+}
+
+template<typename Format>
+static bool benchFills() {
+    using Info = FormatInfo<Format>;
+    static typename Format::Storage buffer[CANVAS_WIDTH * CANVAS_HEIGHT];
+    PixelCanvas<Format> canvas(CANVAS_WIDTH, CANVAS_HEIGHT, buffer);
+    const typename Format::Storage value = Format::pack(RGB(200, 100, 50));
+    bool ok = true;
+    char what[32];
+
+    // Prostokąty na płótnie od 1x1 do całego ekranu, w tym szerokie i niskie jak tła etykiet
+    FillCall rects[64];
+    uint32_t seed = 4242;
+    uint64_t pixels = 0;
+    for (FillCall& r : rects) {
+        r.w = static_cast<int16_t>(1 + nextRandom(seed) % CANVAS_WIDTH);
+        r.h = static_cast<int16_t>(1 + nextRandom(seed) % 80);
+        r.x = static_cast<int16_t>(nextRandom(seed) % (CANVAS_WIDTH - r.w + 1));
+        r.y = static_cast<int16_t>(nextRandom(seed) % (CANVAS_HEIGHT - r.h + 1));
+        pixels += static_cast<uint64_t>(r.w) * r.h;
+    }
+
+    const double loop = measure(pixels, [&] {
+        for (const FillCall& r : rects) fillReference(canvas, r, value);
+    });
+    const double span = measure(pixels, [&] {
+        for (const FillCall& r : rects) canvas.fillRect(r.x, r.y, r.w, r.h, RGB(200, 100, 50));
+    });
+    snprintf(what, sizeof(what), "%s setPixel loop", Info::name);
+    ok &= report("fills", what, loop, pixels, 0);
+    snprintf(what, sizeof(what), "%s fillRect", Info::name);
+    ok &= report("fills", what, span, pixels, 0);
+    return ok;
+}
+
+static bool runFills() {
+    bool ok = checkFills<Rgb444>();
+    ok &= checkFills<Rgb565>();
+    ok &= checkFills<Rgb666>();
+    ok &= benchFills<Rgb444>();
+    ok &= benchFills<Rgb565>();
+    ok &= benchFills<Rgb666>();
+    return ok;
+}
+
+// ========================================
+// SCENARIUSZE
+// ========================================
+struct Scenario {
+    const char* name;
+    bool (*run)();
+};
+
+static const Scenario scenarios[] = {
+    {"formats", runFormats},
+    {"lines", runLines},
+    {"aa", runLineAA},
+    {"blit", runBlit},
+    {"packed", runPacked},
+    {"polygons", runPolygons},
+    {"blend", runBlend},
+    {"fills", runFills},
+};
+
+int main(int argc, char** argv) {
+    const char* only = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--scenario") == 0) {
+            only = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--repeat") == 0) {
+            repeat = static_cast<uint32_t>(atoi(argv[++i]));
+            if (repeat == 0) repeat = 1;
+        } else {
+            fprintf(stderr, "usage: %s [--scenario name] [--repeat n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("canvas %ux%u, best of %u runs\n", CANVAS_WIDTH, CANVAS_HEIGHT, static_cast<unsigned>(repeat));
+    printf("%-10s %-30s %10s %11s %8s  %s\n", "scenario", "case", "Mpixel/s", "checked", "wrong", "check");
+
+    bool ok = true, found = false;
+    for (const Scenario& sc : scenarios) {
+        if (only && strcmp(only, sc.name) != 0) continue;
+        found = true;
+        ok &= sc.run();
+    }
+    if (!found) {
+        fprintf(stderr, "unknown scenario %s\n", only);
+        return 2;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,618 @@
+// Display checks of the host build: frames from src/display.cpp on the emulated panel
+//
+//     display_bench [--scenario name]
+//
+// Every scenario draws frames on a canvas of src/graphics.hpp, sends them through
+// the Display namespace like the firmware and reads the emulated panel back.
+// Bytes, transactions and command bytes are what the panel saw, time is the
+// virtual clock with the CPU costs of host_cpu_costs (drawing itself is not
+// charged). The program exits with 1 when any check fails.
+//
+// Scenarios:
+//     setframe    a countdown screen (label, progress bar, moving marker) for 30
+//                 frames through Display::SetFrame in RGB565, RGB444 and RGB666,
+//                 sending only the dirty region and again sending full frames;
+//                 the panel must match the canvas after every frame and dirty
+//                 frames must cost fewer bytes than full ones. RGB444 and RGB666
+//                 also in the horizontal scan direction (280x240 screen) with a
+//                 280x240 canvas and a 240x280 one cut at the bottom: the visible
+//                 part must be on the panel in one window per chunk of rows
+//     banded      one recorded DisplayList (text, rings, thick and AA lines and
+//                 polygons across strip edges) replayed into a full framebuffer
+//                 and sent with SetFrame, then drawn with Display::RenderBanded
+//                 in strips of 40, 20 and 8 lines and in one shared strip; every
+//                 banded panel must equal the full frame panel, peak memory is
+//                 the pixel buffers plus the recorded list
+//     culling     screens built in layers (a slide over an old screen, a popup
+//                 over the main screen, random primitives under random opaque
+//                 fills) drawn directly and recorded; the replay after cover()
+//                 culling must be pixel identical to direct drawing, on the
+//                 canvas and on the panel. Reports culled commands and host
+//                 wall time of direct drawing, recording and replay (in that
+//                 order, microseconds)
+//     heap        global operator new and delete replaced by a counter; after
+//                 warm-up frames of the countdown screen (record, replay into
+//                 the back canvas, swap(), SetFrame, RenderBanded and an RGB444
+//                 strip through SetFrame) no frame may allocate, and swap()
+//                 must only exchange the pixel pointers
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <new>
+#include <utility>
+
+#include "display.hpp"
+
+extern "C" {
+#include "DEV_Config.h"
+#include "LCD_1in69.h"
+#include "host.h"
+#include "hardware/sync.h"
+}
+
+using namespace Graphics;
+
+#define FRAMES 30
+
+// ========================================
+// PANEL
+// ========================================
+// Piksel płótna tak, jak pokaże go panel w RGB565
+template<typename Format>
+static uint32_t panelRgb(typename Format::Storage px) {
+    const RGB c = Rgb565::unpack(Rgb565::pack(Format::unpack(px)));
+    return static_cast<uint32_t>(c.r) << 16 | static_cast<uint32_t>(c.g) << 8 | c.b;
+}
+
+// Punkt w układzie bieżącego kierunku skanowania; w poziomie x biegnie w górę szkła
+static uint32_t panelPixel(uint16_t x, uint16_t y) {
+    return LCD_1IN69.SCAN_DIR == HORIZONTAL ? host_panel_pixel(y, LCD_1IN69_HEIGHT - 1 - x) : host_panel_pixel(x, y);
+}
+
+// Część płótna widoczna na ekranie w bieżącym kierunku skanowania
+template<typename Format>
+static uint32_t panelDiffers(const PixelCanvas<Format>& canvas) {
+    const uint16_t width = std::min(canvas.getWidth(), LCD_1IN69.WIDTH);
+    const uint16_t height = std::min(canvas.getHeight(), LCD_1IN69.HEIGHT);
+    uint32_t wrong = 0;
+    for (uint16_t y = 0; y < height; y++) {
+        const typename Format::Storage* row = canvas.data() + static_cast<size_t>(y) * canvas.getWidth();
+        for (uint16_t x = 0; x < width; x++) {
+            wrong += panelPixel(x, y) != panelRgb<Format>(row[x]);
+        }
+    }
+    return wrong;
+}
+
+// ========================================
+// POMIAR I RAPORT
+// ========================================
+struct Meter {
+    uint64_t startNs;
+    uint64_t bytes;
+    host_panel_stats bus;
+};
+
+struct Result {
+    uint64_t timeNs;
+    uint64_t bytes;
+    host_panel_stats bus;
+    uint32_t wrong;             // piksele niezgodne z płótnem
+    char note[48];
+    bool ok;
+};
+
+static Meter meterStart() {
+    return Meter{host_time_ns(), host_spi_bytes(spi_get_index(SPI_PORT)), host_panel_get_stats()};
+}
+
+// Pomiar kończy się, gdy ostatni bajt jest na magistrali; dodaje do wyniku
+static void meterStop(const Meter& m, Result& res) {
+    while (DEV_SPI_DMA_Busy()) __wfe();
+
+    const host_panel_stats after = host_panel_get_stats();
+    res.timeNs += host_time_ns() - m.startNs;
+    res.bytes += host_spi_bytes(spi_get_index(SPI_PORT)) - m.bytes;
+    res.bus.transactions += after.transactions - m.bus.transactions;
+    res.bus.commands += after.commands - m.bus.commands;
+    res.bus.parameter_bytes += after.parameter_bytes - m.bus.parameter_bytes;
+    res.bus.pixel_bytes += after.pixel_bytes - m.bus.pixel_bytes;
+}
+
+static void report(const char* scenario, const char* what, const Result& res) {
+    printf("%-10s %-14s %9llu %6llu %6llu %9.3f %7u  %-30s %s\n", scenario, what, static_cast<unsigned long long>(res.bytes),
+           static_cast<unsigned long long>(res.bus.transactions),
+           static_cast<unsigned long long>(res.bus.commands + res.bus.parameter_bytes), res.timeNs / 1e6,
+           static_cast<unsigned>(res.wrong), res.note, res.ok ? "ok" : "FAIL");
+}
+
+// ========================================
+// SETFRAME: ZMIENIONY OBSZAR KONTRA PEŁNE KLATKI
+// ========================================
+// Bufor na największy format (Rgb666 - 3 bajty na piksel)
+static uint8_t frameBuffer[LCD_1IN69_WIDTH * LCD_1IN69_HEIGHT * 3] __attribute__((aligned(4)));
+
+// Ekran odliczania: tło i ramki w klatce 0, potem etykieta, pasek i znacznik
+static void drawCountdown(Canvas& canvas, uint32_t frame) {
+    const RGB background(16, 24, 40), accent(255, 140, 0), text(240, 240, 240);
+    if (frame == 0) {
+        canvas.clear(background);
+        canvas.fillRect(10, 10, 220, 40, RGB(40, 60, 90));
+        canvas.drawText(20, 20, "CURING", Font24, text);
+        canvas.fillRect(18, 198, 204, 12, RGB(60, 60, 60));
+    }
+
+    const uint32_t left = 5 * 60 - frame;
+    char label[8];
+    snprintf(label, sizeof(label), "%02u:%02u", static_cast<unsigned>(left / 60), static_cast<unsigned>(left % 60));
+    canvas.fillRect(50, 120, 140, 24, background);
+    canvas.drawText(50, 120, label, Font24, text);
+
+    canvas.fillRect(20, 200, static_cast<int16_t>(frame * 200 / FRAMES), 8, accent);
+
+    // Znacznik przesuwany co trzecią klatkę: stare miejsce zamazane, nowe narysowane
+    if (frame % 3 == 0) {
+        const int16_t x = static_cast<int16_t>(20 + frame * 6);
+        if (frame > 0) canvas.fillRect(x - 18, 240, 12, 12, background);
+        canvas.fillRect(x, 240, 12, 12, accent);
+    }
+}
+
+template<typename Format>
+static bool runSetFrameFormat(const char* name, ColorDepth depth) {
+    Result dirty = {}, full = {};
+    char what[16];
+
+    // Zmieniony obszar: SetFrame wysyła tylko prostokąty z getDirty
+    {
+        Canvas canvas(LCD_1IN69_WIDTH, LCD_1IN69_HEIGHT, depth, frameBuffer);
+        for (uint32_t frame = 0; frame <= FRAMES; frame++) {
+            drawCountdown(canvas, frame);
+            if (frame == 0) {
+                Display::SetFrame(canvas);     // klatka startowa nie liczy się do porównania
+                continue;
+            }
+            const Meter m = meterStart();
+            Display::SetFrame(canvas);
+            meterStop(m, dirty);
+            dirty.wrong += panelDiffers(*canvas.as<Format>());
+        }
+    }
+
+    // Pełne klatki: nowe płótno na tym samym buforze jest całe zmienione
+    {
+        Canvas canvas(LCD_1IN69_WIDTH, LCD_1IN69_HEIGHT, depth, frameBuffer);
+        for (uint32_t frame = 0; frame <= FRAMES; frame++) {
+            drawCountdown(canvas, frame);
+            canvas.clearDirty();
+            Canvas whole(LCD_1IN69_WIDTH, LCD_1IN69_HEIGHT, depth, frameBuffer);
+            if (frame == 0) {
+                Display::SetFrame(whole);
+                continue;
+            }
+            const Meter m = meterStart();
+            Display::SetFrame(whole);
+            meterStop(m, full);
+            full.wrong += panelDiffers(*whole.as<Format>());
+        }
+    }
+
+    full.ok = full.wrong == 0;
+    dirty.ok = dirty.wrong == 0 && dirty.bytes < full.bytes;
+    snprintf(dirty.note, sizeof(dirty.note), "%.1f%% of full bytes, %.1f%% time", 100.0 * dirty.bytes / full.bytes,
+             100.0 * dirty.timeNs / full.timeNs);
+    snprintf(full.note, sizeof(full.note), "%u frames", FRAMES);
+
+    snprintf(what, sizeof(what), "%s dirty", name);
+    report("setframe", what, dirty);
+    snprintf(what, sizeof(what), "%s full", name);
+    report("setframe", what, full);
+    return dirty.ok && full.ok;
+}
+
+// Poziomy kierunek skanowania, ekran 280x240: płótno na cały ekran i płótno pionowe, którego dół
+// wystaje poza ekran. Widoczna część musi być na panelu, wysłana jednym oknem na porcję wierszy
+template<typename Format>
+static bool runSetFrameHorizontal(const char* name, ColorDepth depth) {
+    const uint16_t sizes[2][2] = {{LCD_1IN69_HEIGHT, LCD_1IN69_WIDTH}, {LCD_1IN69_WIDTH, LCD_1IN69_HEIGHT}};
+    Result res = {};
+    uint32_t windows = 0;
+    char what[16];
+
+    LCD_1IN69_Init(HORIZONTAL);
+    for (const auto& size : sizes) {
+        Canvas canvas(size[0], size[1], depth, frameBuffer);
+        for (uint16_t y = 0; y < size[1]; y++) {
+            for (uint16_t x = 0; x < size[0]; x++) {
+                canvas.drawPixel(x, y, RGB(static_cast<uint8_t>(x * 3), static_cast<uint8_t>(y * 5), static_cast<uint8_t>(x ^ y)));
+            }
+        }
+        const Meter m = meterStart();
+        Display::SetFrame(canvas);
+        meterStop(m, res);
+        res.wrong += panelDiffers(*canvas.as<Format>());
+
+        // Okna po tyle wierszy szerokości widocznej części, ile mieści połówka bufora w display.cpp
+        const uint16_t width = std::min(size[0], LCD_1IN69.WIDTH), height = std::min(size[1], LCD_1IN69.HEIGHT);
+        const uint16_t rows = 8 * LCD_1IN69_HEIGHT / width;
+        windows += (height + rows - 1) / rows;
+    }
+    LCD_1IN69_Init(VERTICAL);
+
+    // Okno to co najwyżej CASET, RASET i RAMWR
+    res.ok = res.wrong == 0 && res.bus.commands <= 3 * windows;
+    snprintf(res.note, sizeof(res.note), "280x240 and 240x280, %u windows", static_cast<unsigned>(windows));
+    snprintf(what, sizeof(what), "%s horiz", name);
+    report("setframe", what, res);
+    return res.ok;
+}
+
+static bool runSetFrame() {
+    bool ok = runSetFrameFormat<Rgb565>("rgb565", ColorDepth::RGB565);
+    ok &= runSetFrameFormat<Rgb444>("rgb444", ColorDepth::RGB444);
+    ok &= runSetFrameFormat<Rgb666>("rgb666", ColorDepth::RGB666);
+    ok &= runSetFrameHorizontal<Rgb444>("rgb444", ColorDepth::RGB444);
+    ok &= runSetFrameHorizontal<Rgb666>("rgb666", ColorDepth::RGB666);
+    return ok;
+}
+
+// ========================================
+// BANDED: PASKI KONTRA PEŁNA KLATKA Z LISTY
+// ========================================
+static uint8_t listMemory[4096] __attribute__((aligned(8)));
+static uint16_t stripBuffer[2][LCD_1IN69_WIDTH * 40];
+static uint32_t fullPanel[LCD_1IN69_WIDTH * LCD_1IN69_HEIGHT];
+
+// Ekran główny: elementy celowo przecinają granice pasków
+static void recordScreen(DisplayList& list) {
+    const RGB background(16, 24, 40), accent(255, 140, 0), text(240, 240, 240);
+    list.clear(background);
+    list.fillRect(10, 10, 220, 40, RGB(40, 60, 90));
+    list.drawText(20, 20, "CURING", Font24, text);
+    list.drawRingAA(120, 140, 90, 78, RGB(60, 60, 60));
+    list.drawRingAA(120, 140, 86, 82, accent);
+    list.drawText(50, 128, "04:59", Font24, text);
+    list.drawLine(20, 230, 220, 250, accent, 7, LineCap::Round);
+    list.drawLine(30, 70, 210, 210, RGB(80, 200, 120), 3);
+    list.drawLineAA(0, 279, 239, 0, RGB(255, 255, 255));
+    list.drawLineAA(5, 35, 235, 43, RGB(255, 255, 0));
+    list.fillTriangle(100, 255, 140, 255, 120, 278, accent);
+    const Point star[10] = {{200, 60}, {207, 75}, {223, 77}, {211, 88}, {214, 104},
+                            {200, 96}, {186, 104}, {189, 88}, {177, 77}, {193, 75}};
+    list.fillPolygon(star, 10, RGB(255, 220, 0));
+}
+
+static void readPanel(uint32_t* out) {
+    for (uint16_t y = 0; y < LCD_1IN69_HEIGHT; y++) {
+        for (uint16_t x = 0; x < LCD_1IN69_WIDTH; x++) out[y * LCD_1IN69_WIDTH + x] = host_panel_pixel(x, y);
+    }
+}
+
+static uint32_t panelDiffersFrom(const uint32_t* want) {
+    uint32_t wrong = 0;
+    for (uint16_t y = 0; y < LCD_1IN69_HEIGHT; y++) {
+        for (uint16_t x = 0; x < LCD_1IN69_WIDTH; x++) wrong += host_panel_pixel(x, y) != want[y * LCD_1IN69_WIDTH + x];
+    }
+    return wrong;
+}
+
+static bool runBanded() {
+    Arena arena(listMemory, sizeof(listMemory));
+    DisplayList list(arena);
+    recordScreen(list);
+    const size_t listBytes = arena.getUsed();
+    bool ok = true;
+
+    // Pełna klatka: lista odtworzona w całym buforze i wysłana przez SetFrame
+    Result full = {};
+    {
+        LCD_1IN69_Clear(0x0000);
+        Canvas canvas(LCD_1IN69_WIDTH, LCD_1IN69_HEIGHT, ColorDepth::RGB565, frameBuffer);
+        list.replay(*canvas.as<Rgb565>());
+        const Meter m = meterStart();
+        Display::SetFrame(canvas);
+        meterStop(m, full);
+        full.wrong = panelDiffers(*canvas.as<Rgb565>());
+        full.ok = full.wrong == 0;
+        readPanel(fullPanel);
+        snprintf(full.note, sizeof(full.note), "peak %zu B", sizeof(uint16_t) * LCD_1IN69_WIDTH * LCD_1IN69_HEIGHT + listBytes);
+        report("banded", "full frame", full);
+    }
+
+    // Paski: dwa na zmianę albo jeden wspólny; panel czyszczony, żeby stary obraz nie przeszedł
+    const struct {
+        uint16_t lines;
+        bool shared;
+    } cases[] = {{40, false}, {20, false}, {8, false}, {40, true}};
+    for (const auto& c : cases) {
+        LCD_1IN69_Clear(0xFFFF);
+        PixelCanvas<Rgb565> front(LCD_1IN69_WIDTH, c.lines, stripBuffer[0]);
+        PixelCanvas<Rgb565> back(LCD_1IN69_WIDTH, c.lines, stripBuffer[1]);
+        Result res = {};
+        const Meter m = meterStart();
+        Display::RenderBanded(list, front, c.shared ? front : back);
+        meterStop(m, res);
+        res.wrong = panelDiffersFrom(fullPanel);
+        res.ok = res.wrong == 0;
+        const size_t pixels = (c.shared ? 1 : 2) * sizeof(uint16_t) * LCD_1IN69_WIDTH * c.lines;
+        snprintf(res.note, sizeof(res.note), "peak %zu B, %.1f%% of full", pixels + listBytes,
+                 100.0 * (pixels + listBytes) / (sizeof(uint16_t) * LCD_1IN69_WIDTH * LCD_1IN69_HEIGHT + listBytes));
+        char what[16];
+        snprintf(what, sizeof(what), "%s%u lines", c.shared ? "1x" : "2x", c.lines);
+        report("banded", what, res);
+        ok &= res.ok;
+    }
+    return ok && full.ok;
+}
+
+// ========================================
+// CULLING: ODTWORZENIE PO ODRZUCENIU ZAKRYTYCH KOMEND
+// ========================================
+static uint8_t layerMemory[32768] __attribute__((aligned(8)));
+static uint16_t replayBuffer[LCD_1IN69_WIDTH * LCD_1IN69_HEIGHT];
+
+static uint64_t wallNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+// Najkrótszy z pięciu przebiegów, w mikrosekundach czasu hosta
+template<typename Fn>
+static double wallUs(Fn&& fn) {
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 5; i++) {
+        const uint64_t t0 = wallNs();
+        fn();
+        best = std::min(best, wallNs() - t0);
+    }
+    return best / 1e3;
+}
+
+// Ekran główny odliczania; Target to Canvas albo DisplayList - te same nazwy metod
+template<typename Target>
+static void drawMainScreen(Target& t) {
+    const RGB background(16, 24, 40), accent(255, 140, 0), text(240, 240, 240);
+    t.clear(background);
+    t.fillRect(10, 10, 220, 40, RGB(40, 60, 90));
+    t.drawText(20, 20, "CURING", Font24, text);
+    t.drawRingAA(120, 140, 90, 78, RGB(60, 60, 60));
+    t.drawRingAA(120, 140, 86, 82, accent);
+    t.drawText(50, 128, "04:59", Font24, text);
+    t.drawLine(20, 240, 220, 240, accent, 9, LineCap::Round);
+    t.fillCircleAA(20, 260, 6, accent);
+}
+
+template<typename Target>
+static void drawSlide(Target& t, uint32_t) {
+    drawMainScreen(t);
+    // Nowy ekran wjeżdża z prawej: nieprzezroczyste tło zakrywa prawie cały stary
+    t.fillRect(8, 0, 232, 280, RGB(30, 30, 30));
+    t.drawText(20, 40, "SETTINGS", Font24, RGB(255, 255, 255));
+    for (int16_t i = 0; i < 5; i++) t.fillRect(20, static_cast<int16_t>(80 + i * 36), 200, 28, RGB(50, 50, 70));
+}
+
+template<typename Target>
+static void drawPopup(Target& t, uint32_t) {
+    drawMainScreen(t);
+    t.fillRect(30, 90, 180, 100, RGB(230, 230, 230));
+    t.drawText(50, 110, "DONE", Font24, RGB(0, 0, 0));
+    t.drawLine(60, 160, 180, 160, RGB(0, 160, 0), 5);
+}
+
+// Losowe prymitywy przykrywane co kilka komend losowym nieprzezroczystym prostokątem
+template<typename Target>
+static void drawLayers(Target& t, uint32_t seed) {
+    auto next = [&seed](int32_t lo, int32_t hi) {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<int16_t>(lo + static_cast<int32_t>((seed >> 8) % static_cast<uint32_t>(hi - lo + 1)));
+    };
+    auto color = [&next] { return RGB(static_cast<uint8_t>(next(0, 255)), static_cast<uint8_t>(next(0, 255)), static_cast<uint8_t>(next(0, 255))); };
+
+    t.clear(RGB(0, 0, 0));
+    for (int i = 0; i < 200; i++) {
+        switch (next(0, 7)) {
+            case 0: t.fillRect(next(-20, 230), next(-20, 270), next(1, 80), next(1, 80), color()); break;
+            case 1: t.drawLine(next(-30, 270), next(-30, 310), next(-30, 270), next(-30, 310), color(), static_cast<uint8_t>(next(1, 12)),
+                               static_cast<LineCap>(next(0, 2))); break;
+            case 2: t.drawLineAA(next(-30, 270), next(-30, 310), next(-30, 270), next(-30, 310), color()); break;
+            case 3: t.drawRingAA(next(0, 239), next(0, 279), static_cast<uint16_t>(next(4, 40)), static_cast<uint16_t>(next(0, 4)), color()); break;
+            case 4: t.fillTriangle(next(-10, 250), next(-10, 290), next(-10, 250), next(-10, 290), next(-10, 250), next(-10, 290), color()); break;
+            case 5: t.drawText(next(-20, 230), next(-20, 270), "UV 365", Font16, color()); break;
+            default: {
+                // Duża nieprzezroczysta plansza
+                const int16_t x = next(-10, 150), y = next(-10, 190);
+                t.fillRect(x, y, next(60, 200), next(60, 200), color());
+                break;
+            }
+        }
+    }
+}
+
+static bool runCulling() {
+    const struct {
+        const char* name;
+        void (*canvas)(Canvas&, uint32_t);
+        void (*record)(DisplayList&, uint32_t);
+        uint32_t seed;
+    } scenes[] = {
+        {"slide", drawSlide<Canvas>, drawSlide<DisplayList>, 0},
+        {"popup", drawPopup<Canvas>, drawPopup<DisplayList>, 0},
+        {"layers 1", drawLayers<Canvas>, drawLayers<DisplayList>, 1},
+        {"layers 2", drawLayers<Canvas>, drawLayers<DisplayList>, 2},
+        {"layers 3", drawLayers<Canvas>, drawLayers<DisplayList>, 3},
+    };
+    bool ok = true;
+
+    for (const auto& scene : scenes) {
+        Canvas direct(LCD_1IN69_WIDTH, LCD_1IN69_HEIGHT, ColorDepth::RGB565, frameBuffer);
+        PixelCanvas<Rgb565> replayed(LCD_1IN69_WIDTH, LCD_1IN69_HEIGHT, replayBuffer);
+        Arena arena(layerMemory, sizeof(layerMemory));
+        DisplayList list(arena);
+
+        const double drawUs = wallUs([&] { scene.canvas(direct, scene.seed); });
+        const double recordUs = wallUs([&] {
+            list.reset();
+            scene.record(list, scene.seed);
+        });
+        // Odtworzenie na płótnie z innym obrazem - lista musi go całkiem zakryć
+        const double replayUs = wallUs([&] {
+            replayed.clear(RGB(255, 0, 255));
+            list.replay(replayed);
+        });
+
+        Result res = {};
+        const PixelCanvas<Rgb565>& want = *direct.as<Rgb565>();
+        for (size_t i = 0; i < static_cast<size_t>(LCD_1IN69_WIDTH) * LCD_1IN69_HEIGHT; i++) {
+            res.wrong += memcmp(&want.data()[i], &replayBuffer[i], sizeof(uint16_t)) != 0;
+        }
+
+        // Ta sama klatka z odtworzenia na panelu
+        LCD_1IN69_Clear(0x0000);
+        const Meter m = meterStart();
+        Display::SetFrame(direct);
+        meterStop(m, res);
+        res.wrong += panelDiffers(replayed);
+
+        res.ok = res.wrong == 0 && arena.getUsed() < sizeof(layerMemory);
+        snprintf(res.note, sizeof(res.note), "%u/%u culled, %.0f/%.0f/%.0f us", list.culled(), list.size(), drawUs, recordUs,
+                 replayUs);
+        report("culling", scene.name, res);
+        ok &= res.ok;
+    }
+    return ok;
+}
+
+// ========================================
+// HEAP: KLATKI BEZ SIĘGANIA DO STERTY
+// ========================================
+#define HEAP_WARMUP 3
+#define HEAP_FRAMES 20
+
+// Globalne new i delete z licznikiem, dla całego programu
+static uint64_t heapAllocations;
+
+void* operator new(size_t size) {
+    heapAllocations++;
+    void* p = malloc(size ? size : 1);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+static uint16_t backBuffer[LCD_1IN69_WIDTH * LCD_1IN69_HEIGHT] __attribute__((aligned(4)));
+static uint16_t stripBuffer444[LCD_1IN69_WIDTH * 40] __attribute__((aligned(4)));
+
+// Klatka odliczania jak w firmware: lista zapisana od nowa, odtworzona w tylnym buforze,
+// bufory zamienione i wysłane; ta sama lista w paskach i pasek RGB444 przez bufor pośredni SetFrame
+static void heapFrame(DisplayList& list, Canvas& front, Canvas& back, Canvas& strip444, PixelCanvas<Rgb565>& stripFront,
+                      PixelCanvas<Rgb565>& stripBack, uint32_t frame) {
+    const uint32_t left = 5 * 60 - frame;
+    char label[8];
+    snprintf(label, sizeof(label), "%02u:%02u", static_cast<unsigned>(left / 60), static_cast<unsigned>(left % 60));
+
+    list.reset();
+    drawMainScreen(list);
+    list.fillRect(50, 128, 140, 24, RGB(16, 24, 40));
+    list.drawText(50, 128, label, Font24, RGB(240, 240, 240));
+
+    list.replay(*back.as<Rgb565>());
+    std::swap(front, back);
+    Display::SetFrame(front);
+    Display::RenderBanded(list, stripFront, stripBack);
+    list.replay(*strip444.as<Rgb444>(), 0, 120);
+    Display::SetFrame(strip444);
+}
+
+static bool runHeap() {
+    Arena arena(listMemory, sizeof(listMemory));
+    DisplayList list(arena);
+    Canvas front(LCD_1IN69_WIDTH, LCD_1IN69_HEIGHT, ColorDepth::RGB565, frameBuffer);
+    Canvas back(LCD_1IN69_WIDTH, LCD_1IN69_HEIGHT, ColorDepth::RGB565, backBuffer);
+    Canvas strip444(LCD_1IN69_WIDTH, 40, ColorDepth::RGB444, stripBuffer444);
+    PixelCanvas<Rgb565> stripFront(LCD_1IN69_WIDTH, 40, stripBuffer[0]);
+    PixelCanvas<Rgb565> stripBack(LCD_1IN69_WIDTH, 40, stripBuffer[1]);
+    Result res = {};
+
+    // Licznik musi liczyć, inaczej zero niczego nie dowodzi
+    const uint64_t before = heapAllocations;
+    ::operator delete(::operator new(1));
+    const bool counting = heapAllocations == before + 1;
+
+    uint32_t frame = 0;
+    for (; frame < HEAP_WARMUP; frame++) heapFrame(list, front, back, strip444, stripFront, stripBack, frame);
+
+    const uint64_t start = heapAllocations;
+    const Meter m = meterStart();
+    bool swapped = true;
+    for (; frame < HEAP_WARMUP + HEAP_FRAMES; frame++) {
+        // Zamiana buforów to tylko wymiana wskaźników
+        const void* frontPixels = front.as<Rgb565>()->data();
+        const void* backPixels = back.as<Rgb565>()->data();
+        heapFrame(list, front, back, strip444, stripFront, stripBack, frame);
+        swapped &= front.as<Rgb565>()->data() == backPixels && back.as<Rgb565>()->data() == frontPixels;
+    }
+    meterStop(m, res);
+    const uint64_t allocations = heapAllocations - start;
+
+    res.wrong = static_cast<uint32_t>(allocations);
+    res.ok = counting && swapped && allocations == 0;
+    snprintf(res.note, sizeof(res.note), "%llu new in %u frames%s", static_cast<unsigned long long>(allocations), HEAP_FRAMES,
+             counting ? "" : ", counter off");
+    report("heap", "frames", res);
+    return res.ok;
+}
+
+// ========================================
+// SCENARIUSZE
+// ========================================
+struct Scenario {
+    const char* name;
+    bool (*run)();
+};
+
+static const Scenario scenarios[] = {
+    {"setframe", runSetFrame},
+    {"banded", runBanded},
+    {"culling", runCulling},
+    {"heap", runHeap},
+};
+
+int main(int argc, char** argv) {
+    const char* only = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--scenario") == 0) {
+            only = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--scenario name]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Start jak init_hardware() w main.c
+    host_board_init();
+    if (!Display::Initialize()) return 1;
+
+    printf("SPI %.3f MHz, panel RGB565\n", spi_get_baudrate(SPI_PORT) / 1e6);
+    printf("%-10s %-14s %9s %6s %6s %9s %7s  %-30s %s\n", "scenario", "case", "bytes", "trans", "cmd B", "ms", "wrong", "",
+           "check");
+
+    bool ok = true, found = false;
+    for (const Scenario& sc : scenarios) {
+        if (only && strcmp(only, sc.name) != 0) continue;
+        found = true;
+        ok &= sc.run();
+    }
+    if (!found) {
+        fprintf(stderr, "unknown scenario %s\n", only);
+        return 2;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,518 @@
+// Flush benchmark of the host build: LVGL-like refresh traces through the LCD driver
+//
+//     flush_bench [--scenario name] [--rgb444] [--baud hz] [--frames]
+//
+// Every scenario invalidates areas the way the UI does, splits them into flushes
+// like LVGL 8 with the draw buffers of main.c and sends them with the same calls
+// as my_disp_flush. Time is the virtual clock: real SPI baud from the clk_peri
+// divider, CPU costs of host_cpu_costs, rendering itself costs nothing. After
+// every scenario the emulated panel is compared with the expected picture.
+//
+// Scenarios:
+//     main_screen     one full redraw of the main screen
+//     arc_ticks       10 s of the running countdown, label and arc every 100 ms
+//     slide           LV_SCR_LOAD_ANIM_MOVE_LEFT from main to power, 500 ms
+//     labels          10 encoder steps on the power screen, arc and value label
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "LCD_1in69.h"
+#include "host.h"
+#include "hardware/sync.h"
+
+// Jak w main.c i lv_conf.h
+#define BUF_LINES 40
+#define BUF_SIZE (LCD_1IN69_WIDTH * BUF_LINES)
+#define REFR_PERIOD_MS 30
+#define ARC_UPDATE_INTERVAL_MS 100
+#define SLIDE_TIME_MS 500
+
+#define MAX_AREAS 8
+#define MAX_FRAMES 128
+
+// ========================================
+// SCENA
+// ========================================
+// Tło ekranów 0xFFEDFF, pierścień arcu i etykiety w przybliżonych miejscach z SquareLine
+#define COLOR_BG 0xFF7F
+#define COLOR_TRACK 0xDEDB
+#define COLOR_INDICATOR 0x781F
+#define COLOR_TEXT 0x2104
+
+#define ARC_X 120
+#define ARC_Y 140
+#define ARC_R_IN 92
+#define ARC_R_OUT 106
+#define ARC_START 135       // stopnie, zgodnie z ruchem wskazówek jak w LVGL
+#define ARC_SWEEP 270
+
+#define GLYPH_W 16
+#define GLYPH_H 28
+
+enum { SCREEN_MAIN, SCREEN_POWER, SCREEN_TIMER, SCREEN_COUNT };
+
+typedef struct {
+    int16_t x1, y1, x2, y2;     // włącznie, jak lv_area_t
+} area;
+
+typedef struct {
+    int16_t x, y;
+    char text[8];
+} label;
+
+typedef struct {
+    uint8_t arc_value;
+    label labels[2];
+    uint8_t label_count;
+} screen;
+
+typedef struct {
+    screen screens[SCREEN_COUNT];
+    uint8_t active;
+    uint8_t next;           // ekran wjeżdżający podczas przesuwania
+    int16_t offset;         // przesunięcie aktywnego ekranu, 0..-240
+} scene;
+
+static scene ui;
+
+static const area full_screen = {0, 0, LCD_1IN69_WIDTH - 1, LCD_1IN69_HEIGHT - 1};
+
+static void reset_scene(void)
+{
+    memset(&ui, 0, sizeof(ui));
+    ui.screens[SCREEN_MAIN] = (screen){0, {{72, 112, "00:00"}, {96, 176, "50%"}}, 2};
+    ui.screens[SCREEN_POWER] = (screen){50, {{96, 126, "50%"}}, 1};
+    ui.screens[SCREEN_TIMER] = (screen){0, {{72, 126, "00:00"}}, 1};
+}
+
+static area label_area(const label *l)
+{
+    const int16_t w = (int16_t)(strlen(l->text) * GLYPH_W);
+    return (area){l->x, l->y, l->x + w - 1, l->y + GLYPH_H - 1};
+}
+
+// Zamiast fontu deterministyczny wzór zależny od znaku, niejednolity jak tekst
+static bool glyph_pixel(char c, int x, int y)
+{
+    if (c == ' ' || x < 2 || x >= GLYPH_W - 2 || y < 3 || y >= GLYPH_H - 3) return false;
+    const uint32_t h = (uint32_t)c * 2654435761u ^ (uint32_t)(x / 3) * 40503u ^ (uint32_t)(y / 4) * 9973u;
+    return (h >> 13) & 1;
+}
+
+static UWORD screen_pixel(const screen *s, int x, int y)
+{
+    for (uint8_t i = 0; i < s->label_count; i++) {
+        const label *l = &s->labels[i];
+        const area a = label_area(l);
+        if (x >= a.x1 && x <= a.x2 && y >= a.y1 && y <= a.y2) {
+            const int cx = x - a.x1;
+            return glyph_pixel(l->text[cx / GLYPH_W], cx % GLYPH_W, y - a.y1) ? COLOR_TEXT : COLOR_BG;
+        }
+    }
+
+    const int dx = x - ARC_X, dy = y - ARC_Y;
+    const int d2 = dx * dx + dy * dy;
+    if (d2 < ARC_R_IN * ARC_R_IN || d2 > ARC_R_OUT * ARC_R_OUT) return COLOR_BG;
+
+    // Kąt bez zmiennoprzecinkowych niejednoznaczności na granicach: całe stopnie
+    int angle = (int)floor(atan2(dy, dx) * 180.0 / M_PI);
+    const int rel = (angle - ARC_START + 720) % 360;
+    if (rel >= ARC_SWEEP) return COLOR_BG;
+    return rel < ARC_SWEEP * s->arc_value / 100 ? COLOR_INDICATOR : COLOR_TRACK;
+}
+
+static UWORD scene_pixel(int x, int y)
+{
+    const int lx = x - ui.offset;
+    if (lx < LCD_1IN69_WIDTH) return screen_pixel(&ui.screens[ui.active], lx, y);
+    return screen_pixel(&ui.screens[ui.next], lx - LCD_1IN69_WIDTH, y);
+}
+
+// Obszar odświeżany przez lv_arc przy zmianie wartości: wycinek pierścienia między kątami
+static area arc_area(uint8_t from, uint8_t to)
+{
+    if (from > to) {
+        const uint8_t t = from;
+        from = to;
+        to = t;
+    }
+    area a = {INT16_MAX, INT16_MAX, INT16_MIN, INT16_MIN};
+    const int first = ARC_START + ARC_SWEEP * from / 100, last = ARC_START + ARC_SWEEP * to / 100;
+    for (int angle = first - 1; angle <= last + 1; angle++) {
+        const double rad = angle * M_PI / 180.0;
+        for (int r = ARC_R_IN; r <= ARC_R_OUT; r += ARC_R_OUT - ARC_R_IN) {
+            const int16_t px = (int16_t)floor(ARC_X + r * cos(rad)), py = (int16_t)floor(ARC_Y + r * sin(rad));
+            if (px - 1 < a.x1) a.x1 = px - 1;
+            if (py - 1 < a.y1) a.y1 = py - 1;
+            if (px + 1 > a.x2) a.x2 = px + 1;
+            if (py + 1 > a.y2) a.y2 = py + 1;
+        }
+    }
+    return a;
+}
+
+// ========================================
+// UNIEWAŻNIANIE I ODŚWIEŻANIE JAK W LVGL 8
+// ========================================
+typedef struct {
+    area areas[MAX_AREAS];
+    uint8_t count;
+} invalid_list;
+
+static invalid_list invalid;
+
+static int32_t area_size(const area *a)
+{
+    return (int32_t)(a->x2 - a->x1 + 1) * (a->y2 - a->y1 + 1);
+}
+
+static bool area_in(const area *inner, const area *outer)
+{
+    return inner->x1 >= outer->x1 && inner->y1 >= outer->y1 && inner->x2 <= outer->x2 && inner->y2 <= outer->y2;
+}
+
+// _lv_inv_area: przycięcie do ekranu, pomijanie obszarów już objętych
+static void invalidate(area a)
+{
+    if (a.x1 < 0) a.x1 = 0;
+    if (a.y1 < 0) a.y1 = 0;
+    if (a.x2 > full_screen.x2) a.x2 = full_screen.x2;
+    if (a.y2 > full_screen.y2) a.y2 = full_screen.y2;
+    if (a.x1 > a.x2 || a.y1 > a.y2) return;
+
+    for (uint8_t i = 0; i < invalid.count; i++) {
+        if (area_in(&a, &invalid.areas[i])) return;
+    }
+    if (invalid.count == MAX_AREAS) {
+        invalid.count = 0;
+        a = full_screen;
+    }
+    invalid.areas[invalid.count++] = a;
+}
+
+// lv_refr_join_area: stykające się obszary łączone, gdy wspólny jest mniejszy niż suma
+static bool join_pair(void)
+{
+    for (uint8_t i = 0; i < invalid.count; i++) {
+        for (uint8_t j = i + 1; j < invalid.count; j++) {
+            const area *a = &invalid.areas[i], *b = &invalid.areas[j];
+            if (a->x1 > b->x2 + 1 || b->x1 > a->x2 + 1 || a->y1 > b->y2 + 1 || b->y1 > a->y2 + 1) continue;
+            const area joined = {a->x1 < b->x1 ? a->x1 : b->x1, a->y1 < b->y1 ? a->y1 : b->y1,
+                                 a->x2 > b->x2 ? a->x2 : b->x2, a->y2 > b->y2 ? a->y2 : b->y2};
+            if (area_size(&joined) < area_size(a) + area_size(b)) {
+                invalid.areas[i] = joined;
+                invalid.areas[j] = invalid.areas[--invalid.count];
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void join_areas(void)
+{
+    while (join_pair()) {
+    }
+}
+
+static UWORD draw_buf[2][BUF_SIZE] __attribute__((aligned(4)));
+static uint8_t draw_buf_index;
+static volatile bool flushing;
+
+static void flush_done(void)
+{
+    flushing = false;
+}
+
+// Jak area_is_solid w main.c
+static bool area_is_solid(const UWORD *px, uint32_t pixels)
+{
+    for (uint32_t i = 1; i < pixels; i++) {
+        if (px[i] != px[0]) return false;
+    }
+    return true;
+}
+
+// Jak my_disp_flush w main.c; bufor w kolejności bajtów panelu (LV_COLOR_16_SWAP)
+static void flush(const area *a, UWORD *pixels)
+{
+    const uint32_t count = (uint32_t)area_size(a);
+    if (area_is_solid(pixels, count)) {
+        const UWORD color = (UWORD)(pixels[0] >> 8 | pixels[0] << 8);
+        LCD_1IN69_FillRect_DMA(a->x1, a->y1, a->x2, a->y2, color, NULL);
+        return;
+    }
+    flushing = true;
+    LCD_1IN69_DisplayArea_DMA(a->x1, a->y1, a->x2, a->y2, pixels, flush_done);
+}
+
+typedef struct {
+    uint64_t start_ns;
+    uint64_t time_ns;
+    uint64_t bytes;
+    uint32_t areas;
+    uint32_t flushes;
+    host_panel_stats bus;
+} frame_stats;
+
+// lv_refr_area: paski o wysokości mieszczącej się w buforze, na zmianę dwa bufory
+static void refresh(frame_stats *stats)
+{
+    const host_panel_stats before = host_panel_get_stats();
+    const uint64_t bytes = host_spi_bytes(spi_get_index(SPI_PORT));
+
+    memset(stats, 0, sizeof(*stats));
+    stats->start_ns = host_time_ns();
+    join_areas();
+    stats->areas = invalid.count;
+
+    for (uint8_t i = 0; i < invalid.count; i++) {
+        const area *a = &invalid.areas[i];
+        const int16_t w = a->x2 - a->x1 + 1;
+        const int16_t rows = (int16_t)(BUF_SIZE / w);
+
+        for (int16_t y = a->y1; y <= a->y2; y += rows) {
+            const area part = {a->x1, y, a->x2, y + rows - 1 > a->y2 ? a->y2 : y + rows - 1};
+
+            UWORD *buf = draw_buf[draw_buf_index];
+            UWORD *px = buf;
+            for (int16_t py = part.y1; py <= part.y2; py++) {
+                for (int16_t x = part.x1; x <= part.x2; x++) {
+                    const UWORD c = scene_pixel(x, py);
+                    *px++ = (UWORD)(c >> 8 | c << 8);
+                }
+            }
+
+            // Drugi bufor może jeszcze iść przez DMA - LVGL czeka na lv_disp_flush_ready
+            while (flushing) __wfe();
+            flush(&part, buf);
+            draw_buf_index ^= 1;
+            stats->flushes++;
+        }
+    }
+    invalid.count = 0;
+
+    // Klatka kończy się, gdy ostatni bajt jest na magistrali
+    while (flushing || DEV_SPI_DMA_Busy()) __wfe();
+
+    const host_panel_stats after = host_panel_get_stats();
+    stats->time_ns = host_time_ns() - stats->start_ns;
+    stats->bytes = host_spi_bytes(spi_get_index(SPI_PORT)) - bytes;
+    stats->bus.transactions = after.transactions - before.transactions;
+    stats->bus.commands = after.commands - before.commands;
+    stats->bus.parameter_bytes = after.parameter_bytes - before.parameter_bytes;
+    stats->bus.pixel_bytes = after.pixel_bytes - before.pixel_bytes;
+    stats->bus.dc_switches = after.dc_switches - before.dc_switches;
+}
+
+// ========================================
+// SCENARIUSZE
+// ========================================
+typedef struct {
+    frame_stats frames[MAX_FRAMES];
+    uint32_t count;
+} trace;
+
+// Następna klatka w okresie odświeżania, spóźniona rusza od razu
+static frame_stats *frame_at(trace *r, uint64_t at_ns)
+{
+    if (at_ns > host_time_ns()) host_advance_to_ns(at_ns);
+    frame_stats *f = &r->frames[r->count++];
+    refresh(f);
+    return f;
+}
+
+static void set_label(screen *s, uint8_t index, const char *text)
+{
+    // lv_label_set_text odświeża etykietę także przy tym samym tekście
+    invalidate(label_area(&s->labels[index]));
+    snprintf(s->labels[index].text, sizeof(s->labels[index].text), "%s", text);
+    invalidate(label_area(&s->labels[index]));
+}
+
+static void set_arc(screen *s, uint8_t value)
+{
+    if (value == s->arc_value) return;
+    invalidate(arc_area(s->arc_value, value));
+    s->arc_value = value;
+}
+
+static void run_main_screen(trace *r, uint64_t t0)
+{
+    ui.active = SCREEN_MAIN;
+    invalidate(full_screen);
+    frame_at(r, t0);
+}
+
+static void run_arc_ticks(trace *r, uint64_t t0)
+{
+    const uint32_t total_ms = 60 * 1000;
+    screen *s = &ui.screens[SCREEN_MAIN];
+
+    for (uint32_t tick = 0; tick < 100; tick++) {
+        const uint32_t remaining = total_ms - tick * ARC_UPDATE_INTERVAL_MS;
+        char text[8];
+        snprintf(text, sizeof(text), "%02u:%02u", (unsigned)(remaining / 1000 / 60), (unsigned)(remaining / 1000 % 60));
+        set_label(s, 0, text);
+        set_arc(s, (uint8_t)(remaining * 100 / total_ms));
+        frame_at(r, t0 + tick * ARC_UPDATE_INTERVAL_MS * 1000000ull);
+    }
+}
+
+static void run_slide(trace *r, uint64_t t0)
+{
+    ui.next = SCREEN_POWER;
+    for (uint32_t t = 0;; t += REFR_PERIOD_MS) {
+        if (t > SLIDE_TIME_MS) t = SLIDE_TIME_MS;
+        ui.offset = (int16_t)(-(int32_t)LCD_1IN69_WIDTH * (int32_t)t / SLIDE_TIME_MS);
+        if (t == SLIDE_TIME_MS) {
+            ui.active = ui.next;
+            ui.offset = 0;
+        }
+        invalidate(full_screen);
+        frame_at(r, t0 + t * 1000000ull);
+        if (t == SLIDE_TIME_MS) break;
+    }
+}
+
+static void run_labels(trace *r, uint64_t t0)
+{
+    screen *s = &ui.screens[SCREEN_POWER];
+    for (uint32_t step = 1; step <= 10; step++) {
+        const uint8_t value = (uint8_t)(50 + step * 5);
+        char text[8];
+        snprintf(text, sizeof(text), "%u%%", value);
+        set_arc(s, value);
+        set_label(s, 0, text);
+        frame_at(r, t0 + step * REFR_PERIOD_MS * 1000000ull);
+    }
+}
+
+typedef struct {
+    const char *name;
+    uint8_t screen;                     // ekran narysowany przed pomiarem
+    void (*run)(trace *r, uint64_t t0);
+} scenario;
+
+static const scenario scenarios[] = {
+    {"main_screen", SCREEN_TIMER, run_main_screen},
+    {"arc_ticks", SCREEN_MAIN, run_arc_ticks},
+    {"slide", SCREEN_MAIN, run_slide},
+    {"labels", SCREEN_POWER, run_labels},
+};
+
+// ========================================
+// RAPORT
+// ========================================
+static uint32_t check_panel(bool rgb444)
+{
+    uint32_t wrong = 0;
+    for (int y = 0; y < LCD_1IN69_HEIGHT; y++) {
+        for (int x = 0; x < LCD_1IN69_WIDTH; x++) {
+            const uint32_t got = host_panel_pixel(x, y);
+            const UWORD want = scene_pixel(x, y);
+            uint32_t r = want >> 11, g = (want >> 5) & 0x3F, b = want & 0x1F;
+            uint32_t gr = got >> 19, gg = (got >> 10) & 0x3F, gb = (got >> 3) & 0x1F;
+            if (rgb444) {
+                r >>= 1, g >>= 2, b >>= 1;
+                gr >>= 1, gg >>= 2, gb >>= 1;
+            }
+            if (r != gr || g != gg || b != gb) wrong++;
+        }
+    }
+    return wrong;
+}
+
+static void print_frame(uint32_t index, const frame_stats *f)
+{
+    printf("  %4u %9.3f ms  %u areas %2u flushes %7llu B %4llu trans %4llu cmd B %8.3f ms\n", (unsigned)index,
+           f->start_ns / 1e6, (unsigned)f->areas, (unsigned)f->flushes, (unsigned long long)f->bytes,
+           (unsigned long long)f->bus.transactions,
+           (unsigned long long)(f->bus.commands + f->bus.parameter_bytes), f->time_ns / 1e6);
+}
+
+static void print_summary(const char *name, const trace *r, uint32_t wrong)
+{
+    uint64_t bytes = 0, transactions = 0, cmd = 0, flushes = 0, time_ns = 0, max_ns = 0;
+    for (uint32_t i = 0; i < r->count; i++) {
+        const frame_stats *f = &r->frames[i];
+        bytes += f->bytes;
+        transactions += f->bus.transactions;
+        cmd += f->bus.commands + f->bus.parameter_bytes;
+        flushes += f->flushes;
+        time_ns += f->time_ns;
+        if (f->time_ns > max_ns) max_ns = f->time_ns;
+    }
+    const double n = r->count ? r->count : 1;
+    printf("%-12s %6u %8.1f %11.0f %11.1f %10.1f %9.3f %9.3f %10.3f  %s", name, (unsigned)r->count,
+           flushes / n, bytes / n, transactions / n, cmd / n, time_ns / n / 1e6, max_ns / 1e6, time_ns / 1e6,
+           wrong ? "" : "ok");
+    if (wrong) printf("%u px differ", (unsigned)wrong);
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *only = NULL;
+    bool rgb444 = false, frames = false;
+    uint baud = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--scenario") == 0) {
+            only = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--baud") == 0) {
+            baud = (uint)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--rgb444") == 0) {
+            rgb444 = true;
+        } else if (strcmp(argv[i], "--frames") == 0) {
+            frames = true;
+        } else {
+            fprintf(stderr, "usage: %s [--scenario name] [--rgb444] [--baud hz] [--frames]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Start jak init_hardware() w main.c
+    host_board_init();
+    if (DEV_Module_Init() != 0) return 1;
+    if (baud) spi_set_baudrate(SPI_PORT, baud);
+    LCD_1IN69_Init(VERTICAL);
+    if (rgb444) LCD_1IN69_SetColorMode(LCD_1IN69_COLOR_RGB444);
+    LCD_1IN69_Clear(0xFFFF);   // WHITE z GUI_Paint.h
+
+    const host_cpu_costs costs = host_get_cpu_costs();
+    printf("SPI %.3f MHz, %s, CPU gpio %u ns, spi call %u ns, dma start %u ns, irq %u ns\n",
+           spi_get_baudrate(SPI_PORT) / 1e6, rgb444 ? "RGB444" : "RGB565", (unsigned)costs.gpio_put_ns,
+           (unsigned)costs.spi_call_ns, (unsigned)costs.dma_start_ns, (unsigned)costs.irq_entry_ns);
+    printf("%-12s %6s %8s %11s %11s %10s %9s %9s %10s  %s\n", "scenario", "frames", "flushes", "bytes/frame",
+           "trans/frame", "cmd B/frm", "ms/frame", "ms max", "ms total", "check");
+
+    static trace r;
+    bool found = false;
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        const scenario *sc = &scenarios[i];
+        if (only && strcmp(only, sc->name) != 0) continue;
+        found = true;
+
+        // Ekran startowy narysowany poza pomiarem
+        reset_scene();
+        ui.active = sc->screen;
+        frame_stats setup;
+        invalidate(full_screen);
+        refresh(&setup);
+
+        memset(&r, 0, sizeof(r));
+        sc->run(&r, host_time_ns() + REFR_PERIOD_MS * 1000000ull);
+        print_summary(sc->name, &r, check_panel(rgb444));
+        if (frames) {
+            for (uint32_t f = 0; f < r.count; f++) print_frame(f, &r.frames[f]);
+        }
+    }
+    if (!found) {
+        fprintf(stderr, "unknown scenario %s\n", only);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,366 @@
+// Input benchmark of the host build: fast edges through the GPIO interrupt, event ring and decoder
+//
+//     input_bench [--scenario name] [--busy-ms ms] [--seconds s]
+//
+// Edges are driven on the encoder and button pins of main.c on the virtual
+// clock. The interrupt handler records them into the ring like gpio_callback,
+// and the main loop drains and decodes them only between busy periods of
+// --busy-ms (default 35, one full frame of the single-core build). At the end
+// the decoded steps and presses are compared with what was driven. Decoder
+// time per event is measured with the host clock. A scenario fails on a dropped
+// event, a decoded count that differs, or a mean decoder time above
+// MAX_MEAN_EVENT_NS; ctest runs the bench with the defaults.
+//
+// Scenarios:
+//     spin        encoder back and forth, one edge every 200 us
+//     clicks      both buttons clicked with 5 bounces on every edge, 40 ms apart
+//     mixed       spin together with clicks and long presses
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "host.h"
+#include "hardware/gpio.h"
+#include "hardware/timer.h"
+#include "input_events.h"
+#include "spsc_queue.h"
+
+// Jak w main.c
+#define ENC_A_PIN 10
+#define ENC_B_PIN 11
+#define BUTT1_PIN 9
+#define BUTT2_PIN 8
+#define DEBOUNCE_TIME_MS 10
+#define LONG_PRESS_TIME_MS 1000
+#define INPUT_RING_CAPACITY 256
+
+#define MAX_EDGES 200000
+#define MAX_EVENT_NS 4096       // histogram czasu dekodera, 1 ns na przedział
+// Średni czas dekodera na zdarzenie na hoście. Przy ok. 30x wolniejszym RP2040 to 30 us,
+// mniej niż 200 us między zboczami enkodera w scenariuszu spin
+#define MAX_MEAN_EVENT_NS 1000
+#define BOUNCES 5
+#define BOUNCE_US 100
+
+// ========================================
+// PRZEBIEG WEJŚĆ
+// ========================================
+typedef struct {
+    uint64_t at_ns;
+    uint8_t pin;
+    bool level;
+} edge;
+
+typedef struct {
+    int32_t steps;              // suma kroków enkodera
+    uint32_t step_count;        // kroki bez względu na kierunek
+    uint32_t short_presses[INPUT_NUM_BUTTONS];
+    uint32_t long_presses[INPUT_NUM_BUTTONS];
+} input_totals;
+
+static edge edges[MAX_EDGES];
+static uint32_t edge_count;
+static uint32_t edge_next;
+static input_totals driven;
+static uint8_t enc_state = 3;   // podciągnięte do 1
+
+static void add_edge(uint64_t at_ns, uint8_t pin, bool level)
+{
+    if (edge_count == MAX_EDGES) {
+        fprintf(stderr, "too many edges\n");
+        exit(1);
+    }
+    edges[edge_count++] = (edge){at_ns, pin, level};
+}
+
+// Krok enkodera kodem Graya 00 -> 01 -> 11 -> 10, jak dekoder
+static void add_step(uint64_t at_ns, int direction)
+{
+    static const uint8_t gray[4] = {0, 1, 3, 2};
+    uint8_t phase = 0;
+    while (gray[phase] != enc_state) phase++;
+    const uint8_t next = gray[(phase + direction) & 3];
+    if ((next ^ enc_state) & 2) add_edge(at_ns, ENC_A_PIN, next & 2);
+    if ((next ^ enc_state) & 1) add_edge(at_ns, ENC_B_PIN, next & 1);
+    enc_state = next;
+
+    driven.steps += direction;
+    driven.step_count++;
+}
+
+// Wciśnięcie z drganiami styków na obu krawędziach
+static void add_press(uint64_t at_ns, uint8_t button, uint32_t hold_ms)
+{
+    const uint8_t pin = button == 0 ? BUTT1_PIN : BUTT2_PIN;
+    const uint64_t release_ns = at_ns + (uint64_t)hold_ms * 1000000;
+    for (int i = 0; i <= 2 * BOUNCES; i++) {
+        add_edge(at_ns + (uint64_t)i * BOUNCE_US * 1000, pin, i & 1);
+        add_edge(release_ns + (uint64_t)i * BOUNCE_US * 1000, pin, !(i & 1));
+    }
+
+    if (hold_ms >= LONG_PRESS_TIME_MS) {
+        driven.long_presses[button]++;
+    } else {
+        driven.short_presses[button]++;
+    }
+}
+
+static void add_spin(uint64_t from_ns, uint64_t to_ns)
+{
+    // 60 kroków w przód, 40 w tył, krawędź co 200 µs
+    int direction = 1, run = 0;
+    for (uint64_t t = from_ns; t < to_ns; t += 200000) {
+        add_step(t, direction);
+        if (++run == (direction > 0 ? 60 : 40)) {
+            direction = -direction;
+            run = 0;
+        }
+    }
+}
+
+static void add_clicks(uint64_t from_ns, uint64_t to_ns, bool long_presses)
+{
+    uint32_t n = 0;
+    for (uint64_t t = from_ns; t + 1200000000ull < to_ns; n++) {
+        const uint8_t button = n & 1;
+        if (long_presses && n % 8 == 7) {
+            add_press(t, button, LONG_PRESS_TIME_MS + 100);
+            t += (LONG_PRESS_TIME_MS + 140) * 1000000ull;
+        } else {
+            add_press(t, button, 20);
+            t += 40000000;
+        }
+    }
+}
+
+static int compare_edges(const void *a, const void *b)
+{
+    const edge *x = a, *y = b;
+    return x->at_ns < y->at_ns ? -1 : x->at_ns > y->at_ns;
+}
+
+// Jedno zdarzenie zegara na krawędź, następna planowana po bieżącej
+static void drive_next(void *ctx)
+{
+    (void)ctx;
+    const uint64_t now = host_time_ns();
+    while (edge_next < edge_count && edges[edge_next].at_ns <= now) {
+        host_gpio_drive(edges[edge_next].pin, edges[edge_next].level);
+        edge_next++;
+    }
+    if (edge_next < edge_count) {
+        host_schedule_ns(edges[edge_next].at_ns, drive_next, NULL);
+    }
+}
+
+// ========================================
+// PRZERWANIE I PĘTLA GŁÓWNA
+// ========================================
+static input_event_t ring_slots[INPUT_RING_CAPACITY];
+static spsc_queue_t ring;
+static uint32_t events_recorded;
+static uint32_t events_dropped;
+static uint32_t ring_peak;
+
+// Jak gpio_callback w main.c
+static void gpio_callback(uint gpio, uint32_t events)
+{
+    input_event_t event;
+    event.time_us = time_us_32();
+    event.pin = gpio;
+    event.edges = events & (GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL);
+    event.level = gpio_get(gpio);
+
+    if (!spsc_queue_push(&ring, &event)) {
+        events_dropped++;
+        return;
+    }
+    events_recorded++;
+    if (ring.head - ring.tail > ring_peak) ring_peak = ring.head - ring.tail;
+}
+
+static input_totals decoded;
+
+static void on_action(const input_action_t *action, void *ctx)
+{
+    (void)ctx;
+    switch (action->kind) {
+        case INPUT_TURN:
+            decoded.steps += action->steps;
+            decoded.step_count++;
+            break;
+        case INPUT_SHORT_PRESS:
+            decoded.short_presses[action->button]++;
+            break;
+        case INPUT_LONG_PRESS:
+            decoded.long_presses[action->button]++;
+            break;
+    }
+}
+
+static uint64_t wall_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+typedef struct {
+    uint32_t events;
+    uint64_t total_ns;          // czas hosta w dekoderze
+    uint64_t max_ns;            // najdłuższe pojedyncze zdarzenie, z wywłaszczeniami hosta
+    uint32_t histogram[MAX_EVENT_NS];
+} decode_stats;
+
+static decode_stats stats;
+
+static double percentile_ns(double fraction)
+{
+    const uint32_t target = (uint32_t)(stats.events * fraction);
+    uint32_t seen = 0;
+    for (uint32_t ns = 0; ns < MAX_EVENT_NS; ns++) {
+        seen += stats.histogram[ns];
+        if (seen > target) return ns;
+    }
+    return MAX_EVENT_NS;
+}
+
+static void drain(input_decoder_t *decoder)
+{
+    input_event_t event;
+    while (spsc_queue_pop(&ring, &event)) {
+        const uint64_t t0 = wall_ns();
+        input_decoder_event(decoder, &event, on_action, NULL);
+        const uint64_t t = wall_ns() - t0;
+
+        stats.events++;
+        stats.total_ns += t;
+        stats.histogram[t < MAX_EVENT_NS ? t : MAX_EVENT_NS - 1]++;
+        if (t > stats.max_ns) stats.max_ns = t;
+    }
+    input_decoder_poll(decoder, time_us_32(), on_action, NULL);
+}
+
+static const char *pair(char *buf, int a, int b)
+{
+    sprintf(buf, "%d/%d", a, b);
+    return buf;
+}
+
+// ========================================
+// SCENARIUSZE
+// ========================================
+typedef struct {
+    const char *name;
+    bool spin;
+    bool clicks;
+    bool long_presses;
+} scenario;
+
+static const scenario scenarios[] = {
+    {"spin", true, false, false},
+    {"clicks", false, true, false},
+    {"mixed", true, true, true},
+};
+
+static bool run(const scenario *sc, double seconds, double busy_ms)
+{
+    // Wejścia w stanie spoczynku między scenariuszami
+    host_gpio_release(ENC_A_PIN);
+    host_gpio_release(ENC_B_PIN);
+    host_gpio_release(BUTT1_PIN);
+    host_gpio_release(BUTT2_PIN);
+    host_advance_ns(2 * DEBOUNCE_TIME_MS * 1000000ull);
+
+    memset(&driven, 0, sizeof(driven));
+    memset(&decoded, 0, sizeof(decoded));
+    edge_count = edge_next = 0;
+    enc_state = 3;
+    events_recorded = events_dropped = ring_peak = 0;
+    spsc_queue_init(&ring, ring_slots, sizeof(input_event_t), INPUT_RING_CAPACITY);
+
+    static const uint8_t button_pins[INPUT_NUM_BUTTONS] = {BUTT1_PIN, BUTT2_PIN};
+    input_decoder_t decoder;
+    input_decoder_init(&decoder, ENC_A_PIN, ENC_B_PIN, enc_state, button_pins, DEBOUNCE_TIME_MS * 1000,
+                       LONG_PRESS_TIME_MS * 1000);
+
+    const uint64_t start_ns = host_time_ns() + 1000000;
+    const uint64_t end_ns = start_ns + (uint64_t)(seconds * 1e9);
+    if (sc->spin) add_spin(start_ns, end_ns);
+    if (sc->clicks) add_clicks(start_ns, end_ns, sc->long_presses);
+    qsort(edges, edge_count, sizeof(edge), compare_edges);
+    if (edge_count) host_schedule_ns(edges[0].at_ns, drive_next, NULL);
+
+    // Pętla główna: opróżnienie kolejki, potem praca bez czytania wejść
+    memset(&stats, 0, sizeof(stats));
+    const uint64_t busy_ns = (uint64_t)(busy_ms * 1e6);
+    while (host_time_ns() < end_ns + (LONG_PRESS_TIME_MS + 2 * DEBOUNCE_TIME_MS) * 1000000ull) {
+        drain(&decoder);
+        host_advance_ns(busy_ns > 0 ? busy_ns : 1000);
+    }
+    drain(&decoder);
+
+    const double mean_ns = stats.events ? (double)stats.total_ns / stats.events : 0.0;
+    const bool ok = events_dropped == 0 && memcmp(&driven, &decoded, sizeof(driven)) == 0 &&
+                    mean_ns <= MAX_MEAN_EVENT_NS;
+    char b[5][32];
+    printf("%-8s %7u %7u %7u %9s %13s %13s %9s %7s %8.1f %8.0f %8.0f  %s\n", sc->name, (unsigned)edge_count,
+           (unsigned)events_recorded, (unsigned)events_dropped, pair(b[0], ring_peak, INPUT_RING_CAPACITY),
+           pair(b[1], decoded.steps, driven.steps), pair(b[2], decoded.step_count, driven.step_count),
+           pair(b[3], decoded.short_presses[0] + decoded.short_presses[1], driven.short_presses[0] + driven.short_presses[1]),
+           pair(b[4], decoded.long_presses[0] + decoded.long_presses[1], driven.long_presses[0] + driven.long_presses[1]),
+           mean_ns, percentile_ns(0.999), (double)stats.max_ns,
+           ok ? "ok" : "FAIL");
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    const char *only = NULL;
+    double seconds = 10, busy_ms = 35;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--scenario") == 0) {
+            only = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--busy-ms") == 0) {
+            busy_ms = atof(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--seconds") == 0) {
+            seconds = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--scenario name] [--busy-ms ms] [--seconds s]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Wejścia jak init_gpio() w main.c
+    host_board_init();
+    const uint pins[] = {ENC_A_PIN, ENC_B_PIN, BUTT1_PIN, BUTT2_PIN};
+    for (size_t i = 0; i < sizeof(pins) / sizeof(pins[0]); i++) {
+        gpio_init(pins[i]);
+        gpio_set_dir(pins[i], GPIO_IN);
+        gpio_pull_up(pins[i]);
+    }
+    gpio_set_irq_enabled_with_callback(ENC_A_PIN, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true, &gpio_callback);
+    gpio_set_irq_enabled(ENC_B_PIN, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true);
+    gpio_set_irq_enabled(BUTT1_PIN, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true);
+    gpio_set_irq_enabled(BUTT2_PIN, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true);
+
+    printf("main loop busy %.1f ms between drains, %.1f s per scenario, debounce %u ms, long press %u ms\n",
+           busy_ms, seconds, DEBOUNCE_TIME_MS, LONG_PRESS_TIME_MS);
+    printf("(decoded/driven), fails above %u ns/event\n", MAX_MEAN_EVENT_NS);
+    printf("%-8s %7s %7s %7s %9s %13s %13s %9s %7s %8s %8s %8s  %s\n", "scenario", "edges", "events", "dropped",
+           "ring peak", "net steps", "steps", "short", "long", "ns/event", "ns 99.9%", "ns max", "check");
+
+    bool ok = true, found = false;
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        if (only && strcmp(only, scenarios[i].name) != 0) continue;
+        found = true;
+        ok &= run(&scenarios[i], seconds, busy_ms);
+    }
+    if (!found) {
+        fprintf(stderr, "unknown scenario %s\n", only);
+        return 2;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,1012 @@
+// LCD driver checks of the host build: DMA flushes through the emulated panel
+//
+//     lcd_bench [--scenario name]
+//
+// Every scenario drives the LCD driver like the firmware does and then reads the
+// emulated panel back. Bytes, transactions and command bytes are what the panel
+// saw, time is the virtual clock with the CPU costs of host_cpu_costs. The
+// program exits with 1 when any check fails.
+//
+// Scenarios:
+//     pingpong    a full screen in 40-line bands from two draw buffers like
+//                 my_disp_flush, the next band starts while the previous one is
+//                 on the wire; every done callback must come once, with CS high
+//                 and its band already on the panel
+//     commands    init and one window with a recorder in place of the panel, the
+//                 command and parameter bytes must match the original driver,
+//                 one command per transaction, DISPON 120 ms after SLPOUT
+//     window_cache  an LVGL flush trace (full screen, then countdown label and arc
+//                 ticks) with the window cache and again with it invalidated
+//                 before every flush; command bytes saved must match the axes
+//                 that repeat, the panel must be the same
+//     strided     sub-rectangles of a framebuffer wider than the screen through
+//                 DisplayWindows and DisplayWindows_DMA, vertical and horizontal
+//                 in RGB565 and vertical in RGB444; corners in any order and
+//                 windows past the edge are clipped, the panel must match
+//                 pixel for pixel
+//     pack444     LCD_1IN69_PackRGB444 on odd pixel counts and from odd halfword
+//                 addresses, then DisplayArea, DisplayArea_DMA and DisplayWindows
+//                 in 12-bit mode (odd areas, odd widths whose last pixel is paired
+//                 with the next row, a full frame over many staging halves); the
+//                 bytes after RAMWR must equal a packer written channel by channel
+//                 and the panel must match. Reports the frame in RGB565 and
+//                 RGB444 (bytes, virtual ms) and the packer in host MB/s
+//     fillrect    FillRect and FillRect_DMA over a patterned screen in RGB565 and
+//                 RGB444: odd sizes, corners in any order, rectangles past each
+//                 edge and one fully off screen; the panel and the pixel bytes
+//                 must equal DisplayArea of a solid buffer on the clipped
+//                 rectangles and every DMA call must call back once.
+//                 LCD_1IN69_IsSolid on odd and even lengths must reject one
+//                 differing pixel first, in the middle and last
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "LCD_1in69.h"
+#include "host.h"
+#include "hardware/sync.h"
+
+// Jak w main.c
+#define BUF_LINES 40
+#define BUF_SIZE (LCD_1IN69_WIDTH * BUF_LINES)
+
+#define MAX_TRANSFERS 16
+#define MAX_TOKENS 512
+#define FB_PADDING 8            // framebuffer szerszy od ekranu, krok wiersza różny od szerokości
+
+// ========================================
+// OBRAZ I PANEL
+// ========================================
+// Niejednolity wzór zależny od ziarna, żeby pomylone pasy lub bufory były widoczne
+static UWORD pattern(int x, int y, uint32_t seed)
+{
+    const uint32_t h = ((uint32_t)x * 2654435761u) ^ ((uint32_t)y * 40503u) ^ (seed * 9973u);
+    return (UWORD)(h ^ h >> 16);
+}
+
+static UWORD swap_bytes(UWORD c)
+{
+    return (UWORD)(c >> 8 | c << 8);
+}
+
+static uint32_t expand(uint32_t value, uint bits)
+{
+    value <<= 8 - bits;
+    return value | (value >> bits);
+}
+
+// Piksel RGB565 tak, jak pokaże go panel, obcięty do formatu interfejsu
+static uint32_t panel_rgb(UWORD c)
+{
+    uint32_t r = expand(c >> 11, 5), g = expand((c >> 5) & 0x3F, 6), b = expand(c & 0x1F, 5);
+    if (LCD_1IN69.COLOR_MODE == LCD_1IN69_COLOR_RGB444) {
+        r = expand(c >> 12, 4);
+        g = expand((c >> 7) & 0x0F, 4);
+        b = expand((c >> 1) & 0x0F, 4);
+    }
+    return r << 16 | g << 8 | b;
+}
+
+// Punkt w układzie bieżącego kierunku skanowania; w poziomie x biegnie w górę szkła
+static bool panel_has(int x, int y, UWORD want)
+{
+    const uint32_t got = LCD_1IN69.SCAN_DIR == HORIZONTAL ? host_panel_pixel(y, LCD_1IN69_HEIGHT - 1 - x)
+                                                          : host_panel_pixel(x, y);
+    return got == panel_rgb(want);
+}
+
+// Obszar w kolejności bajtów panelu, wiersz po wierszu z podanym krokiem
+static uint32_t panel_differs(int x0, int y0, int w, int h, const UWORD *px, int stride)
+{
+    uint32_t wrong = 0;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            if (!panel_has(x0 + x, y0 + y, swap_bytes(px[y * stride + x]))) wrong++;
+        }
+    }
+    return wrong;
+}
+
+// ========================================
+// POMIAR
+// ========================================
+typedef struct {
+    uint64_t start_ns;
+    uint64_t bytes;
+    host_panel_stats bus;
+} meter;
+
+typedef struct {
+    uint64_t time_ns;
+    uint64_t bytes;
+    host_panel_stats bus;
+    uint32_t wrong;             // piksele lub bajty niezgodne z oczekiwanymi
+    char note[64];
+    bool ok;
+} result;
+
+static meter meter_start(void)
+{
+    return (meter){host_time_ns(), host_spi_bytes(spi_get_index(SPI_PORT)), host_panel_get_stats()};
+}
+
+// Pomiar kończy się, gdy ostatni bajt jest na magistrali
+static void meter_stop(const meter *m, result *res)
+{
+    while (DEV_SPI_DMA_Busy()) __wfe();
+
+    const host_panel_stats after = host_panel_get_stats();
+    res->time_ns = host_time_ns() - m->start_ns;
+    res->bytes = host_spi_bytes(spi_get_index(SPI_PORT)) - m->bytes;
+    res->bus.transactions = after.transactions - m->bus.transactions;
+    res->bus.commands = after.commands - m->bus.commands;
+    res->bus.parameter_bytes = after.parameter_bytes - m->bus.parameter_bytes;
+    res->bus.pixel_bytes = after.pixel_bytes - m->bus.pixel_bytes;
+    res->bus.dc_switches = after.dc_switches - m->bus.dc_switches;
+}
+
+// ========================================
+// PINGPONG: DWA BUFORY RYSOWANIA JAK W MY_DISP_FLUSH
+// ========================================
+static UWORD draw_buf[2][BUF_SIZE] __attribute__((aligned(4)));
+
+typedef struct {
+    int16_t y1, y2;             // pas ekranu, włącznie
+    uint8_t buf;
+    bool solid;
+} band;
+
+static band bands[MAX_TRANSFERS];
+static uint32_t band_count;
+static volatile bool flushing[2];
+static volatile int32_t in_flight[2] = {-1, -1};   // pas wysyłany z bufora
+static uint32_t done_calls[MAX_TRANSFERS];
+static uint32_t done_early;     // callback przed końcem transakcji lub z niepełnym pasem na panelu
+
+// Jak my_disp_flush_done: lv_disp_flush_ready z przerwania DMA
+static void band_done(uint8_t buf)
+{
+    const int32_t index = in_flight[buf];
+    if (index < 0) {
+        done_early++;
+        return;
+    }
+    const band *b = &bands[index];
+    done_calls[index]++;
+    if (!gpio_get(LCD_CS_PIN) ||
+        panel_differs(0, b->y1, LCD_1IN69_WIDTH, b->y2 - b->y1 + 1, draw_buf[buf], LCD_1IN69_WIDTH) != 0) {
+        done_early++;
+    }
+    in_flight[buf] = -1;
+    flushing[buf] = false;
+}
+
+static void buf0_done(void)
+{
+    band_done(0);
+}
+
+static void buf1_done(void)
+{
+    band_done(1);
+}
+
+static void run_pingpong(result *res)
+{
+    const meter m = meter_start();
+    memset(done_calls, 0, sizeof(done_calls));
+    done_early = 0;
+    band_count = 0;
+
+    for (int16_t y = 0; y < LCD_1IN69_HEIGHT; y += BUF_LINES) {
+        const uint8_t buf = band_count & 1;
+        band *b = &bands[band_count];
+        *b = (band){y, y + BUF_LINES - 1, buf, band_count == 3};
+
+        // LVGL rysuje do bufora dopiero po lv_disp_flush_ready, drugi bufor jest w tym czasie wysyłany
+        while (flushing[buf]) __wfe();
+        UWORD *px = draw_buf[buf];
+        for (int py = b->y1; py <= b->y2; py++) {
+            for (int x = 0; x < LCD_1IN69_WIDTH; x++) {
+                *px++ = swap_bytes(b->solid ? 0x781F : pattern(x, py, band_count));
+            }
+        }
+
+        // Jednolity pas idzie wypełnieniem bez bufora, który wraca od razu do LVGL
+        if (b->solid) {
+            LCD_1IN69_FillRect_DMA(0, b->y1, LCD_1IN69_WIDTH - 1, b->y2, 0x781F, NULL);
+            done_calls[band_count]++;
+        } else {
+            flushing[buf] = true;
+            in_flight[buf] = (int32_t)band_count;
+            LCD_1IN69_DisplayArea_DMA(0, b->y1, LCD_1IN69_WIDTH - 1, b->y2, draw_buf[buf], buf ? buf1_done : buf0_done);
+        }
+        band_count++;
+    }
+    while (flushing[0] || flushing[1]) __wfe();
+    meter_stop(&m, res);
+
+    // Cały ekran po ostatnim pasie
+    for (uint32_t i = 0; i < band_count; i++) {
+        const band *b = &bands[i];
+        for (int y = b->y1; y <= b->y2; y++) {
+            for (int x = 0; x < LCD_1IN69_WIDTH; x++) {
+                if (!panel_has(x, y, b->solid ? 0x781F : pattern(x, y, i))) res->wrong++;
+            }
+        }
+    }
+
+    uint32_t once = 0;
+    for (uint32_t i = 0; i < band_count; i++) once += done_calls[i] == 1;
+    snprintf(res->note, sizeof(res->note), "%u/%u bands done once, %u early", (unsigned)once, (unsigned)band_count,
+             (unsigned)done_early);
+    res->ok = once == band_count && done_early == 0 && res->wrong == 0;
+}
+
+// ========================================
+// COMMANDS: STRUMIEŃ JAK W PIERWOTNYM STEROWNIKU
+// ========================================
+// Pierwotny sterownik wysyłał każdy bajt w osobnej transakcji, tu liczy się kolejność i DC
+typedef struct {
+    UBYTE Cmd;
+    UBYTE Len;
+    UBYTE Params[14];
+} baseline_cmd;
+
+// LCD_1IN69_SetAttributes(VERTICAL) i LCD_1IN69_InitReg sprzed tablicy inicjalizacji, bez
+// powtórzonego w InitReg MADCTL 0x00, który w poziomie kasował kierunek skanowania
+static const baseline_cmd baseline_init[] = {
+    {0x36, 1, {0x00}},
+    {0x3A, 1, {0x05}},
+    {0xB2, 5, {0x0B, 0x0B, 0x00, 0x33, 0x35}},
+    {0xB7, 1, {0x11}},
+    {0xBB, 1, {0x35}},
+    {0xC0, 1, {0x2C}},
+    {0xC2, 1, {0x01}},
+    {0xC3, 1, {0x0D}},
+    {0xC4, 1, {0x20}},
+    {0xC6, 1, {0x13}},
+    {0xD0, 2, {0xA4, 0xA1}},
+    {0xD6, 1, {0xA1}},
+    {0xE0, 14, {0xF0, 0x06, 0x0B, 0x0A, 0x09, 0x26, 0x29, 0x33, 0x41, 0x18, 0x16, 0x15, 0x29, 0x2D}},
+    {0xE1, 14, {0xF0, 0x04, 0x08, 0x08, 0x07, 0x03, 0x28, 0x32, 0x40, 0x3B, 0x19, 0x18, 0x2A, 0x2E}},
+    {0xE4, 3, {0x25, 0x00, 0x00}},
+    {0x21, 0, {0}},
+    {0x11, 0, {0}},
+    {0x29, 0, {0}},
+};
+
+// LCD_1IN69_SetWindows(10, 20, 100, 200) w pionie, GRAM przesunięty o 20 wierszy
+static const baseline_cmd baseline_window[] = {
+    {0x2A, 4, {0x00, 0x0A, 0x00, 0x64}},
+    {0x2B, 4, {0x00, 0x28, 0x00, 0xDC}},
+    {0x2C, 0, {0}},
+};
+
+typedef struct {
+    uint8_t byte;
+    bool data;                  // DC wysoko
+    uint32_t transaction;
+    uint64_t at_ns;
+} token;
+
+static token tokens[MAX_TOKENS];
+static uint32_t token_count;
+static uint32_t transaction_count;
+
+static void record(void *ctx, const uint8_t *data, size_t len)
+{
+    (void)ctx;
+    if (gpio_get(LCD_CS_PIN)) return;
+    const bool dc = gpio_get(LCD_DC_PIN);
+    for (size_t i = 0; i < len && token_count < MAX_TOKENS; i++) {
+        tokens[token_count++] = (token){data[i], dc, transaction_count, host_time_ns()};
+    }
+}
+
+static void record_cs(void *ctx, uint gpio, bool level)
+{
+    (void)ctx;
+    (void)gpio;
+    if (level) transaction_count++;
+}
+
+// Niezgodne bajty od tokenu first; każda transakcja zaczyna się komendą i ma tylko jedną
+static uint32_t compare_stream(uint32_t first, const baseline_cmd *cmds, size_t count, uint32_t *next)
+{
+    uint32_t wrong = 0, t = first;
+    for (size_t i = 0; i < count; i++) {
+        const token *cmd = t < token_count ? &tokens[t] : NULL;
+        if (cmd == NULL || cmd->data || cmd->byte != cmds[i].Cmd) wrong++;
+        if (cmd != NULL && t > first && tokens[t - 1].transaction == cmd->transaction) wrong++;
+        t++;
+        for (UBYTE p = 0; p < cmds[i].Len; p++, t++) {
+            if (t >= token_count || !tokens[t].data || tokens[t].byte != cmds[i].Params[p] ||
+                (cmd != NULL && tokens[t].transaction != cmd->transaction)) {
+                wrong++;
+            }
+        }
+    }
+    *next = t;
+    return wrong;
+}
+
+static uint32_t count_bytes(const baseline_cmd *cmds, size_t count)
+{
+    uint32_t bytes = 0;
+    for (size_t i = 0; i < count; i++) bytes += 1 + cmds[i].Len;
+    return bytes;
+}
+
+static const token *find_command(uint8_t cmd)
+{
+    for (uint32_t i = 0; i < token_count; i++) {
+        if (!tokens[i].data && tokens[i].byte == cmd) return &tokens[i];
+    }
+    return NULL;
+}
+
+static void run_commands(result *res)
+{
+    const uint32_t spi = spi_get_index(SPI_PORT);
+    token_count = 0;
+    transaction_count = 0;
+    host_spi_attach(spi, record, NULL);
+    host_gpio_watch(LCD_CS_PIN, record_cs, NULL);
+
+    // Reset i inicjalizacja, potem czyszczenie: porównanie do pierwszego CASET
+    const uint64_t start_ns = host_time_ns();
+    LCD_1IN69_Init(VERTICAL);
+    uint32_t init_end = 0;
+    res->wrong = compare_stream(0, baseline_init, sizeof(baseline_init) / sizeof(baseline_init[0]), &init_end);
+    const uint32_t init_transactions = tokens[init_end - 1].transaction + 1;
+
+    const token *slpout = find_command(0x11), *dispon = find_command(0x29);
+    const bool delay_ok = slpout && dispon && dispon->at_ns - slpout->at_ns >= 120000000ull;
+
+    // Okno po unieważnieniu pamięci okna wysyła oba zakresy jak pierwotne SetWindows
+    token_count = 0;
+    const uint32_t window_first = transaction_count;
+    LCD_1IN69_InvalidateWindow();
+    LCD_1IN69_SetWindows(10, 20, 100, 200);
+    uint32_t window_end = 0;
+    res->wrong += compare_stream(0, baseline_window, sizeof(baseline_window) / sizeof(baseline_window[0]), &window_end);
+    const uint32_t window_transactions = transaction_count - window_first;
+
+    const uint32_t init_bytes = count_bytes(baseline_init, sizeof(baseline_init) / sizeof(baseline_init[0]));
+    const uint32_t window_bytes = count_bytes(baseline_window, sizeof(baseline_window) / sizeof(baseline_window[0]));
+    res->time_ns = host_time_ns() - start_ns;
+    res->bytes = init_bytes + window_bytes;
+    res->bus.transactions = init_transactions + window_transactions;
+    res->bus.commands = sizeof(baseline_init) / sizeof(baseline_init[0]) +
+                        sizeof(baseline_window) / sizeof(baseline_window[0]);
+    res->bus.parameter_bytes = init_bytes + window_bytes - res->bus.commands;
+    snprintf(res->note, sizeof(res->note), "init %u+window %u trans, was %u", (unsigned)init_transactions,
+             (unsigned)window_transactions, (unsigned)(init_bytes + window_bytes));
+    res->ok = res->wrong == 0 && delay_ok && window_end == token_count;
+
+    // Panel z powrotem na magistrali, z obrazem jak po starcie
+    host_board_init();
+    LCD_1IN69_Init(VERTICAL);
+    LCD_1IN69_Clear(0xFFFF);
+}
+
+// ========================================
+// WINDOW_CACHE: ŚLAD FLUSHY LVGL Z PAMIĘCIĄ OKNA I BEZ
+// ========================================
+typedef struct {
+    int16_t x1, y1, x2, y2;     // włącznie, jak lv_area_t
+} area;
+
+#define MAX_TRACE 64
+
+static area flush_trace[MAX_TRACE];
+static uint32_t flush_trace_count;
+static UWORD shadow[LCD_1IN69_HEIGHT][LCD_1IN69_WIDTH];
+
+static void trace_add(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+    flush_trace[flush_trace_count++] = (area){x1, y1, x2, y2};
+}
+
+// Pełny ekran w pasach bufora, potem 10 kroków odliczania: etykieta czasu i wycinek arcu
+static void build_trace(void)
+{
+    flush_trace_count = 0;
+    for (int16_t y = 0; y < LCD_1IN69_HEIGHT; y += BUF_LINES) trace_add(0, y, LCD_1IN69_WIDTH - 1, y + BUF_LINES - 1);
+    for (int16_t tick = 0; tick < 10; tick++) {
+        trace_add(72, 112, 151, 139);
+        const int16_t ax = (int16_t)(30 + tick / 3 * 6);
+        trace_add(ax, 40, ax + 11, 61);
+    }
+}
+
+static void trace_buf0_done(void)
+{
+    flushing[0] = false;
+}
+
+static void trace_buf1_done(void)
+{
+    flushing[1] = false;
+}
+
+static void replay_trace(bool cached, uint32_t seed)
+{
+    for (uint32_t i = 0; i < flush_trace_count; i++) {
+        const area *a = &flush_trace[i];
+        const uint8_t buf = i & 1;
+        while (flushing[buf]) __wfe();
+
+        UWORD *px = draw_buf[buf];
+        for (int y = a->y1; y <= a->y2; y++) {
+            for (int x = a->x1; x <= a->x2; x++) {
+                shadow[y][x] = pattern(x, y, seed + i);
+                *px++ = swap_bytes(shadow[y][x]);
+            }
+        }
+
+        if (!cached) LCD_1IN69_InvalidateWindow();
+        flushing[buf] = true;
+        LCD_1IN69_DisplayArea_DMA(a->x1, a->y1, a->x2, a->y2, draw_buf[buf], buf ? trace_buf1_done : trace_buf0_done);
+    }
+    while (flushing[0] || flushing[1]) __wfe();
+}
+
+// CASET i RASET po 5 bajtów, wysyłane tylko gdy zakres osi różni się od poprzedniego okna
+static uint32_t expected_command_bytes(bool cached)
+{
+    uint32_t bytes = 0;
+    for (uint32_t i = 0; i < flush_trace_count; i++) {
+        const area *a = &flush_trace[i], *prev = i > 0 ? &flush_trace[i - 1] : NULL;
+        const bool same_x = cached && prev && prev->x1 == a->x1 && prev->x2 == a->x2;
+        const bool same_y = cached && prev && prev->y1 == a->y1 && prev->y2 == a->y2;
+        bytes += 1 + (same_x ? 0 : 5) + (same_y ? 0 : 5);
+    }
+    return bytes;
+}
+
+static uint32_t shadow_differs(void)
+{
+    uint32_t wrong = 0;
+    for (int y = 0; y < LCD_1IN69_HEIGHT; y++) {
+        for (int x = 0; x < LCD_1IN69_WIDTH; x++) {
+            if (!panel_has(x, y, shadow[y][x])) wrong++;
+        }
+    }
+    return wrong;
+}
+
+static void run_window_cache(result *res)
+{
+    build_trace();
+
+    // Bez pamięci okna jak przed jej dodaniem, potem ten sam ślad z nią
+    LCD_1IN69_InvalidateWindow();
+    result uncached;
+    memset(&uncached, 0, sizeof(uncached));
+    meter m = meter_start();
+    replay_trace(false, 1000);
+    meter_stop(&m, &uncached);
+    uncached.wrong = shadow_differs();
+
+    LCD_1IN69_InvalidateWindow();
+    m = meter_start();
+    replay_trace(true, 2000);
+    meter_stop(&m, res);
+    res->wrong = uncached.wrong + shadow_differs();
+
+    const uint64_t cmd = res->bus.commands + res->bus.parameter_bytes;
+    const uint64_t cmd_uncached = uncached.bus.commands + uncached.bus.parameter_bytes;
+    snprintf(res->note, sizeof(res->note), "uncached %llu cmd B %llu trans, %.1f%% saved",
+             (unsigned long long)cmd_uncached, (unsigned long long)uncached.bus.transactions,
+             100.0 * (double)(cmd_uncached - cmd) / (double)cmd_uncached);
+    res->ok = res->wrong == 0 && cmd == expected_command_bytes(true) && cmd_uncached == expected_command_bytes(false);
+}
+
+// ========================================
+// STRIDED: WYCINKI FRAMEBUFFERA W OBU KIERUNKACH SKANOWANIA
+// ========================================
+static UWORD framebuffer[(LCD_1IN69_HEIGHT + FB_PADDING) * LCD_1IN69_HEIGHT];   // dość na oba kierunki
+static uint32_t window_done_calls;
+
+static void window_done(void)
+{
+    window_done_calls++;
+}
+
+typedef struct {
+    int32_t xs, ys, xe, ye;     // względem szerokości i wysokości ekranu, ujemne od prawej i dołu
+} window;
+
+static const window windows[] = {
+    {10, 20, 100, 60},
+    {200, 150, 120, 100},       // narożniki odwrotnie
+    {-40, -30, 1000, 1000},     // poza ekranem, przycięte
+    {5, 0, 5, -1},              // jedna kolumna
+    {0, 7, -1, 7},              // jeden wiersz
+    {33, 170, 69, 230},         // nieparzysta szerokość, w RGB444 piksel przechodzi do następnego wiersza
+    {0, 0, -1, -1},             // cały ekran
+    {1000, 0, 1005, 5},         // całkiem poza ekranem
+};
+
+static UWORD window_coord(int32_t v, UWORD size)
+{
+    return (UWORD)(v < 0 ? size + v : v);
+}
+
+static uint32_t strided_pass(UBYTE scan_dir, UBYTE color_mode, result *res)
+{
+    LCD_1IN69_Init(scan_dir);
+    if (color_mode != LCD_1IN69_COLOR_RGB565) LCD_1IN69_SetColorMode(color_mode);
+
+    const UWORD width = LCD_1IN69.WIDTH, height = LCD_1IN69.HEIGHT, stride = width + FB_PADDING;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < stride; x++) framebuffer[y * stride + x] = swap_bytes(pattern(x, y, scan_dir));
+    }
+    memset(shadow, 0, sizeof(shadow));
+
+    const meter m = meter_start();
+    for (size_t i = 0; i < sizeof(windows) / sizeof(windows[0]); i++) {
+        const window *w = &windows[i];
+        UWORD xs = window_coord(w->xs, width), ys = window_coord(w->ys, height);
+        UWORD xe = window_coord(w->xe, width), ye = window_coord(w->ye, height);
+        if (i & 1) {
+            LCD_1IN69_DisplayWindows_DMA(xs, ys, xe, ye, framebuffer, stride, window_done);
+        } else {
+            LCD_1IN69_DisplayWindows(xs, ys, xe, ye, framebuffer, stride);
+        }
+
+        // Oczekiwany obraz w układzie kierunku skanowania, wiersze shadow po width
+        if (xs > xe) {
+            const UWORD t = xs;
+            xs = xe;
+            xe = t;
+        }
+        if (ys > ye) {
+            const UWORD t = ys;
+            ys = ye;
+            ye = t;
+        }
+        for (int y = ys; y <= ye && y < height; y++) {
+            for (int x = xs; x <= xe && x < width; x++) {
+                (&shadow[0][0])[y * width + x] = pattern(x, y, scan_dir);
+            }
+        }
+    }
+    result pass;
+    memset(&pass, 0, sizeof(pass));
+    meter_stop(&m, &pass);
+    res->time_ns += pass.time_ns;
+    res->bytes += pass.bytes;
+    res->bus.transactions += pass.bus.transactions;
+    res->bus.commands += pass.bus.commands;
+    res->bus.parameter_bytes += pass.bus.parameter_bytes;
+
+    uint32_t wrong = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (!panel_has(x, y, (&shadow[0][0])[y * width + x])) wrong++;
+        }
+    }
+    return wrong;
+}
+
+static void run_strided(result *res)
+{
+    window_done_calls = 0;
+    res->wrong = strided_pass(VERTICAL, LCD_1IN69_COLOR_RGB565, res);
+    res->wrong += strided_pass(HORIZONTAL, LCD_1IN69_COLOR_RGB565, res);
+    res->wrong += strided_pass(VERTICAL, LCD_1IN69_COLOR_RGB444, res);
+
+    const uint32_t dma_windows = 3 * (sizeof(windows) / sizeof(windows[0]) / 2);
+    snprintf(res->note, sizeof(res->note), "3 modes x %u windows, %u/%u DMA done",
+             (unsigned)(sizeof(windows) / sizeof(windows[0])), (unsigned)window_done_calls, (unsigned)dma_windows);
+    res->ok = res->wrong == 0 && window_done_calls == dma_windows;
+
+    // Jak po starcie
+    LCD_1IN69_Init(VERTICAL);
+    LCD_1IN69_Clear(0xFFFF);
+}
+
+// ========================================
+// PACK444: STRUMIEŃ 12-BITOWY KONTRA WZORZEC KANAŁ PO KANALE
+// ========================================
+#define WIRE_BYTES (LCD_1IN69_WIDTH * LCD_1IN69_HEIGHT * 2)
+#define PACK_REPEAT 50
+
+static UWORD pack_src[LCD_1IN69_WIDTH * LCD_1IN69_HEIGHT + 2] __attribute__((aligned(4)));
+static UBYTE pack_out[WIRE_BYTES + 4];
+static UBYTE pack_want[WIRE_BYTES + 4];
+static UBYTE wire[WIRE_BYTES];
+static uint32_t wire_len;
+static bool wire_ramwr;         // po RAMWR, do następnej komendy (dane idą w osobnej transakcji)
+static uint32_t pack_done_calls;
+
+// Po 4 bity z każdego kanału, półbajty kolejno R G B, nieparzysty ostatni piksel dopełniony zerem
+static uint32_t reference_pack(const UWORD *px, uint32_t count, UBYTE *out)
+{
+    const uint32_t bytes = (count * 3 + 1) / 2;
+    memset(out, 0, bytes);
+    for (uint32_t i = 0; i < count; i++) {
+        const UWORD c = swap_bytes(px[i]);
+        const UBYTE nibbles[3] = {(UBYTE)(c >> 12), (UBYTE)((c >> 7) & 0x0F), (UBYTE)((c >> 1) & 0x0F)};
+        for (uint32_t n = 0; n < 3; n++) {
+            const uint32_t at = i * 3 + n;
+            out[at / 2] |= at & 1 ? nibbles[n] : (UBYTE)(nibbles[n] << 4);
+        }
+    }
+    return bytes;
+}
+
+static void wire_record(void *ctx, const uint8_t *data, size_t len)
+{
+    (void)ctx;
+    if (gpio_get(LCD_CS_PIN)) return;
+    if (!gpio_get(LCD_DC_PIN)) {
+        wire_ramwr = len > 0 && data[len - 1] == 0x2C;
+        return;
+    }
+    for (size_t i = 0; i < len && wire_ramwr && wire_len < WIRE_BYTES; i++) wire[wire_len++] = data[i];
+}
+
+static void pack_done(void)
+{
+    pack_done_calls++;
+}
+
+typedef struct {
+    UWORD xs, ys, xe, ye;       // włącznie
+    UWORD offset;               // początek źródła, nieparzysty to adres niewyrównany do słowa
+    UWORD stride;               // 0: DisplayArea, inaczej DisplayWindows z tym krokiem
+    bool dma;
+} pack_area;
+
+static const pack_area pack_areas[] = {
+    {0, 0, 0, 0, 0, 0, false},                  // jeden piksel
+    {3, 5, 9, 7, 1, 0, true},                   // 21 pikseli z nieparzystego adresu
+    {0, 10, 238, 12, 0, 0, false},              // 717 pikseli, kilka połówek bufora
+    {11, 40, 47, 52, 1, 241, false},            // 37 kolumn, piksel przechodzi do następnego wiersza
+    {100, 60, 100, 200, 0, 33, true},           // jedna kolumna, każdy wiersz nieparzysty
+    {50, 90, 176, 98, 3, 200, true},            // 127 kolumn z nieparzystego adresu
+    {0, 0, LCD_1IN69_WIDTH - 1, LCD_1IN69_HEIGHT - 1, 1, 0, true},   // cała ramka
+};
+
+// Pierwszy piksel okna; DisplayWindows dostaje punkt (0, 0) framebuffera
+static const UWORD *pack_first(const pack_area *a)
+{
+    return pack_src + a->offset + (a->stride ? a->ys * a->stride + a->xs : 0);
+}
+
+static void pack_send(const pack_area *a)
+{
+    UWORD *src = pack_src + a->offset;
+    if (a->stride == 0 && a->dma) {
+        LCD_1IN69_DisplayArea_DMA(a->xs, a->ys, a->xe, a->ye, src, pack_done);
+    } else if (a->stride == 0) {
+        LCD_1IN69_DisplayArea(a->xs, a->ys, a->xe, a->ye, src);
+    } else if (a->dma) {
+        LCD_1IN69_DisplayWindows_DMA(a->xs, a->ys, a->xe, a->ye, src, a->stride, pack_done);
+    } else {
+        LCD_1IN69_DisplayWindows(a->xs, a->ys, a->xe, a->ye, src, a->stride);
+    }
+    DEV_SPI_DMA_Wait();
+}
+
+// Piksele okna wiersz po wierszu, tak jak wychodzą na magistralę
+static uint32_t pack_gather(const pack_area *a, UWORD *out)
+{
+    const uint32_t width = a->xe - a->xs + 1, height = a->ye - a->ys + 1;
+    const uint32_t stride = a->stride ? a->stride : width;
+    for (uint32_t y = 0; y < height; y++) {
+        memcpy(out + y * width, pack_first(a) + y * stride, width * sizeof(UWORD));
+    }
+    return width * height;
+}
+
+// Sam pakowacz: nieparzyste liczby pikseli i adresy, bajt za wynikiem nietknięty
+static uint32_t pack_direct(void)
+{
+    static const UDOUBLE counts[] = {1, 2, 3, 5, 7, 239, 240, 241};
+    uint32_t wrong = 0;
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        for (UWORD offset = 0; offset < 2; offset++) {
+            const uint32_t bytes = reference_pack(pack_src + offset, counts[i], pack_want);
+            memset(pack_out, 0xA5, bytes + 1);
+            const UDOUBLE got = LCD_1IN69_PackRGB444(pack_src + offset, pack_out, counts[i]);
+            wrong += got != bytes || memcmp(pack_out, pack_want, bytes) != 0 || pack_out[bytes] != 0xA5;
+        }
+    }
+    return wrong;
+}
+
+static uint64_t host_wall_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Cała ramka przez DisplayArea w danym formacie, bajty i czas wirtualny
+static void pack_frame(UBYTE color_mode, result *pass)
+{
+    LCD_1IN69_Init(VERTICAL);
+    if (color_mode != LCD_1IN69_COLOR_RGB565) LCD_1IN69_SetColorMode(color_mode);
+    memset(pass, 0, sizeof(*pass));
+    const meter m = meter_start();
+    LCD_1IN69_DisplayArea(0, 0, LCD_1IN69_WIDTH - 1, LCD_1IN69_HEIGHT - 1, pack_src);
+    meter_stop(&m, pass);
+}
+
+static void run_pack444(result *res)
+{
+    const size_t area_count = sizeof(pack_areas) / sizeof(pack_areas[0]);
+    for (size_t i = 0; i < sizeof(pack_src) / sizeof(pack_src[0]); i++) {
+        pack_src[i] = swap_bytes(pattern((int)(i % 257), (int)(i / 257), 4));
+    }
+    res->wrong = pack_direct();
+
+    // Bajty na magistrali: rejestrator zamiast panelu
+    const uint32_t spi = spi_get_index(SPI_PORT);
+    host_spi_attach(spi, wire_record, NULL);
+    LCD_1IN69_Init(VERTICAL);
+    LCD_1IN69_SetColorMode(LCD_1IN69_COLOR_RGB444);
+    pack_done_calls = 0;
+    for (size_t i = 0; i < area_count; i++) {
+        wire_len = 0;
+        pack_send(&pack_areas[i]);
+        const uint32_t count = pack_gather(&pack_areas[i], (UWORD *)pack_out);
+        const uint32_t bytes = reference_pack((const UWORD *)pack_out, count, pack_want);
+        res->wrong += wire_len != bytes || memcmp(wire, pack_want, bytes) != 0;
+    }
+
+    // Te same okna na panelu; każde okno zapisane po kolei w shadow
+    host_board_init();
+    LCD_1IN69_Init(VERTICAL);
+    LCD_1IN69_SetColorMode(LCD_1IN69_COLOR_RGB444);
+    uint32_t panel_wrong = 0;
+    for (size_t i = 0; i < area_count; i++) {
+        const pack_area *a = &pack_areas[i];
+        pack_send(a);
+        const uint32_t width = a->xe - a->xs + 1, stride = a->stride ? a->stride : width;
+        panel_wrong += panel_differs(a->xs, a->ys, width, a->ye - a->ys + 1, pack_first(a), stride);
+    }
+    res->wrong += panel_wrong;
+
+    // Ramka w obu formatach na wirtualnym zegarze i sam pakowacz na hoście
+    result frame565, frame444;
+    pack_frame(LCD_1IN69_COLOR_RGB565, &frame565);
+    pack_frame(LCD_1IN69_COLOR_RGB444, &frame444);
+    const UDOUBLE pixels = LCD_1IN69_WIDTH * LCD_1IN69_HEIGHT;
+    const uint64_t t0 = host_wall_ns();
+    for (int i = 0; i < PACK_REPEAT; i++) {
+        LCD_1IN69_PackRGB444(pack_src + (i & 1), pack_out, pixels);
+    }
+    const double seconds = (host_wall_ns() - t0) / 1e9;
+
+    res->bytes = frame444.bytes;
+    res->time_ns = frame444.time_ns;
+    res->bus = frame444.bus;
+    snprintf(res->note, sizeof(res->note), "565 %llu B %.2f ms, pack %.0f MB/s in",
+             (unsigned long long)frame565.bytes, frame565.time_ns / 1e6, PACK_REPEAT * pixels * 2.0 / seconds / 1e6);
+    // Każde okno DMA dwa razy: na magistrali i na panelu
+    uint32_t dma_areas = 0;
+    for (size_t i = 0; i < area_count; i++) dma_areas += pack_areas[i].dma;
+    res->ok = res->wrong == 0 && pack_done_calls == 2 * dma_areas && frame444.bytes * 4 < frame565.bytes * 3 + 64;
+
+    // Jak po starcie
+    LCD_1IN69_Init(VERTICAL);
+    LCD_1IN69_Clear(0xFFFF);
+}
+
+// ========================================
+// FILLRECT: WYPEŁNIENIE KONTRA JEDNOLITY BUFOR
+// ========================================
+static uint32_t fill_done_calls;
+static uint32_t fill_panel[LCD_1IN69_HEIGHT][LCD_1IN69_WIDTH];
+
+static void fill_done(void)
+{
+    fill_done_calls++;
+}
+
+static const window fill_rects[] = {
+    {10, 20, 100, 60},
+    {77, 131, 33, 90},          // narożniki odwrotnie, nieparzyste wymiary
+    {0, 0, 0, 0},               // jeden piksel
+    {3, 250, 3, -1},            // jedna kolumna do dołu
+    {-17, 5, -1, 5},            // jeden wiersz do prawej krawędzi
+    {-13, -9, 1000, 1000},      // za prawą i dolną krawędzią, przycięte
+    {0, 100, 1000, 102},        // od lewej krawędzi za prawą
+    {1000, 10, 1005, 20},       // całkiem poza ekranem, tylko callback DMA
+    {120, 0, 124, 1000},        // od górnej krawędzi za dolną
+    {0, 0, -1, -1},             // cały ekran, wiele porcji w RGB444
+    {101, 201, 201, 222},       // nieparzysta liczba pikseli po pełnym ekranie
+};
+
+static UWORD fill_color(size_t i)
+{
+    return (UWORD)(0x1234 + i * 0x3B5D);
+}
+
+// Tło z wzoru, żeby wyjście poza prostokąt było widoczne
+static void fill_background(UBYTE color_mode)
+{
+    LCD_1IN69_Init(VERTICAL);
+    if (color_mode != LCD_1IN69_COLOR_RGB565) LCD_1IN69_SetColorMode(color_mode);
+    for (int y = 0; y < LCD_1IN69_HEIGHT; y++) {
+        for (int x = 0; x < LCD_1IN69_WIDTH; x++) framebuffer[y * LCD_1IN69_WIDTH + x] = swap_bytes(pattern(x, y, 8));
+    }
+    LCD_1IN69_Display(framebuffer);
+}
+
+// Prostokąt w kolejności narożników i przycięty jak w sterowniku; false, gdy cały poza ekranem
+static bool fill_clip(const window *w, UWORD *xs, UWORD *ys, UWORD *xe, UWORD *ye)
+{
+    UWORD x0 = window_coord(w->xs, LCD_1IN69_WIDTH), y0 = window_coord(w->ys, LCD_1IN69_HEIGHT);
+    UWORD x1 = window_coord(w->xe, LCD_1IN69_WIDTH), y1 = window_coord(w->ye, LCD_1IN69_HEIGHT);
+    *xs = x0 < x1 ? x0 : x1;
+    *xe = x0 < x1 ? x1 : x0;
+    *ys = y0 < y1 ? y0 : y1;
+    *ye = y0 < y1 ? y1 : y0;
+    if (*xs >= LCD_1IN69_WIDTH || *ys >= LCD_1IN69_HEIGHT) return false;
+    if (*xe >= LCD_1IN69_WIDTH) *xe = LCD_1IN69_WIDTH - 1;
+    if (*ye >= LCD_1IN69_HEIGHT) *ye = LCD_1IN69_HEIGHT - 1;
+    return true;
+}
+
+static uint32_t fill_pass(UBYTE color_mode, result *res)
+{
+    const size_t count = sizeof(fill_rects) / sizeof(fill_rects[0]);
+
+    // FillRect i FillRect_DMA na przemian, z nieprzyciętymi współrzędnymi
+    fill_background(color_mode);
+    const meter m = meter_start();
+    for (size_t i = 0; i < count; i++) {
+        const window *w = &fill_rects[i];
+        const UWORD xs = window_coord(w->xs, LCD_1IN69_WIDTH), ys = window_coord(w->ys, LCD_1IN69_HEIGHT);
+        const UWORD xe = window_coord(w->xe, LCD_1IN69_WIDTH), ye = window_coord(w->ye, LCD_1IN69_HEIGHT);
+        if (i & 1) {
+            LCD_1IN69_FillRect_DMA(xs, ys, xe, ye, fill_color(i), fill_done);
+        } else {
+            LCD_1IN69_FillRect(xs, ys, xe, ye, fill_color(i));
+        }
+    }
+    result pass;
+    memset(&pass, 0, sizeof(pass));
+    meter_stop(&m, &pass);
+    res->time_ns += pass.time_ns;
+    res->bytes += pass.bytes;
+    res->bus.transactions += pass.bus.transactions;
+    res->bus.commands += pass.bus.commands;
+    res->bus.parameter_bytes += pass.bus.parameter_bytes;
+    for (int y = 0; y < LCD_1IN69_HEIGHT; y++) {
+        for (int x = 0; x < LCD_1IN69_WIDTH; x++) fill_panel[y][x] = host_panel_pixel(x, y);
+    }
+
+    // To samo przez DisplayArea jednolitego bufora na przyciętym prostokącie
+    fill_background(color_mode);
+    const host_panel_stats before = host_panel_get_stats();
+    for (size_t i = 0; i < count; i++) {
+        UWORD xs, ys, xe, ye;
+        if (!fill_clip(&fill_rects[i], &xs, &ys, &xe, &ye)) continue;
+        const UDOUBLE pixels = (UDOUBLE)(xe - xs + 1) * (ye - ys + 1);
+        for (UDOUBLE p = 0; p < pixels; p++) framebuffer[p] = swap_bytes(fill_color(i));
+        LCD_1IN69_DisplayArea(xs, ys, xe, ye, framebuffer);
+    }
+
+    // Piksele spoza ekranu panel by odrzucił, więc liczą się też bajty na magistrali
+    const uint64_t want_bytes = host_panel_get_stats().pixel_bytes - before.pixel_bytes;
+    uint32_t wrong = pass.bus.pixel_bytes != want_bytes;
+    for (int y = 0; y < LCD_1IN69_HEIGHT; y++) {
+        for (int x = 0; x < LCD_1IN69_WIDTH; x++) wrong += fill_panel[y][x] != host_panel_pixel(x, y);
+    }
+    return wrong;
+}
+
+// LCD_1IN69_IsSolid na parzystych i nieparzystych długościach, inny piksel na początku, w środku i na końcu
+static uint32_t solid_checks(uint32_t *checked)
+{
+    static const UDOUBLE lengths[] = {1, 2, 3, 7, 8, 241, BUF_SIZE};
+    UWORD *buf = framebuffer;
+    uint32_t wrong = 0;
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        const UDOUBLE n = lengths[i];
+        const UDOUBLE where[] = {0, n / 2, n - 1};
+        for (UDOUBLE p = 0; p < n; p++) buf[p] = 0xEDFF;
+        wrong += LCD_1IN69_IsSolid(buf, n) != 1;
+        (*checked)++;
+        if (n == 1) continue;
+        for (size_t k = 0; k < 3; k++) {
+            buf[where[k]] = 0xEDFE;
+            wrong += LCD_1IN69_IsSolid(buf, n) != 0;
+            buf[where[k]] = 0xEDFF;
+            (*checked)++;
+        }
+    }
+    return wrong;
+}
+
+static void run_fillrect(result *res)
+{
+    uint32_t checked = 0;
+    fill_done_calls = 0;
+    res->wrong = fill_pass(LCD_1IN69_COLOR_RGB565, res);
+    res->wrong += fill_pass(LCD_1IN69_COLOR_RGB444, res);
+    res->wrong += solid_checks(&checked);
+
+    // Każde wywołanie DMA kończy się callbackiem, także prostokąt całkiem poza ekranem
+    const uint32_t dma_rects = 2 * (sizeof(fill_rects) / sizeof(fill_rects[0]) / 2);
+    snprintf(res->note, sizeof(res->note), "2 modes x %u rects, %u/%u DMA done, %u solid",
+             (unsigned)(sizeof(fill_rects) / sizeof(fill_rects[0])), (unsigned)fill_done_calls, (unsigned)dma_rects,
+             (unsigned)checked);
+    res->ok = res->wrong == 0 && fill_done_calls == dma_rects;
+
+    // Jak po starcie
+    LCD_1IN69_Init(VERTICAL);
+    LCD_1IN69_Clear(0xFFFF);
+}
+
+// ========================================
+// SCENARIUSZE
+// ========================================
+typedef struct {
+    const char *name;
+    void (*run)(result *res);
+} scenario;
+
+static const scenario scenarios[] = {
+    {"pingpong", run_pingpong},
+    {"commands", run_commands},
+    {"window_cache", run_window_cache},
+    {"strided", run_strided},
+    {"pack444", run_pack444},
+    {"fillrect", run_fillrect},
+};
+
+int main(int argc, char **argv)
+{
+    const char *only = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--scenario") == 0) {
+            only = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--scenario name]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Start jak init_hardware() w main.c
+    host_board_init();
+    if (DEV_Module_Init() != 0) return 1;
+    LCD_1IN69_Init(VERTICAL);
+    LCD_1IN69_Clear(0xFFFF);   // WHITE z GUI_Paint.h
+
+    printf("SPI %.3f MHz, RGB565\n", spi_get_baudrate(SPI_PORT) / 1e6);
+    printf("%-12s %9s %6s %6s %9s %7s  %-42s %s\n", "scenario", "bytes", "trans", "cmd B", "ms", "wrong", "",
+           "check");
+
+    bool ok = true, found = false;
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        const scenario *sc = &scenarios[i];
+        if (only && strcmp(only, sc->name) != 0) continue;
+        found = true;
+
+        result res;
+        memset(&res, 0, sizeof(res));
+        sc->run(&res);
+        printf("%-12s %9llu %6llu %6llu %9.3f %7u  %-42s %s\n", sc->name, (unsigned long long)res.bytes,
+               (unsigned long long)res.bus.transactions,
+               (unsigned long long)(res.bus.commands + res.bus.parameter_bytes), res.time_ns / 1e6,
+               (unsigned)res.wrong, res.note, res.ok ? "ok" : "FAIL");
+        ok &= res.ok;
+    }
+    if (!found) {
+        fprintf(stderr, "unknown scenario %s\n", only);
+        return 2;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,227 @@
+// Queue checks of the host build: src/spsc_queue.h with the producer and consumer on two threads
+//
+//     queue_bench [--scenario name] [--items n]
+//
+// The queue is used between the GPIO interrupt and the main loop and between
+// core0 and core1 in main.c. Here both sides are real std::threads that run at
+// the same time, so a missing acquire or release shows up as a torn or
+// reordered item. Every item carries its sequence number several times and the
+// consumer checks that items arrive complete, in order and without gaps.
+// Counters start just below 2^32 so they wrap around while the threads run.
+// A side that finds the queue full or empty yields its CPU, so the check also
+// runs on a single core host. Reports items per second of host time and how
+// often the producer found the queue full and the consumer found it empty. The
+// program exits with 1 when any check fails.
+//
+// Scenarios:
+//     single      one thread: pop from an empty queue, push until full, the
+//                 push into a full queue must fail and leave the queue as it
+//                 was, then pop everything in order; repeated with the
+//                 counters crossing 2^32 and for capacities 1, 2, 16 and 256
+//     threads     --items items (default 2000000) through queues of capacity
+//                 1, 2, 16 (ui_queue in main.c) and 256 (input_ring) with the
+//                 producer and the consumer on their own threads
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "spsc_queue.h"
+
+#define MAX_CAPACITY 256
+
+namespace {
+
+// Numer kolejny zapisany kilka razy - rozerwany element ma różne słowa
+struct Item {
+    uint32_t seq;
+    uint32_t inverted;
+    uint32_t mixed;
+    uint32_t again;
+};
+
+Item makeItem(uint32_t seq) {
+    return Item{seq, ~seq, seq * 2654435761u, seq};
+}
+
+bool sameItem(const Item& item, uint32_t seq) {
+    const Item want = makeItem(seq);
+    return memcmp(&item, &want, sizeof(Item)) == 0;
+}
+
+Item slots[MAX_CAPACITY];
+uint64_t items = 2000000;
+
+bool report(const char* scenario, const char* what, double mitems, uint64_t full, uint64_t empty, uint64_t checked,
+            uint64_t wrong) {
+    const bool ok = wrong == 0 && checked > 0;
+    printf("%-10s %-22s %9.2f %11llu %11llu %11llu %8llu  %s\n", scenario, what, mitems, (unsigned long long)full,
+           (unsigned long long)empty, (unsigned long long)checked, (unsigned long long)wrong, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+// Kolejka z licznikami ustawionymi tuż pod 2^32, żeby przeszły przez zero w trakcie
+void initQueue(spsc_queue_t* q, uint32_t capacity, uint32_t start) {
+    spsc_queue_init(q, slots, sizeof(Item), capacity);
+    q->head = start;
+    q->tail = start;
+}
+
+// ========================================
+// SINGLE: PUSTA I PEŁNA KOLEJKA W JEDNYM WĄTKU
+// ========================================
+uint64_t checkSingle(uint32_t capacity, uint32_t start, uint64_t& checked) {
+    spsc_queue_t q;
+    Item item;
+    uint64_t wrong = 0;
+    uint32_t pushed = 0, popped = 0;
+
+    initQueue(&q, capacity, start);
+    // Kilka obrotów bufora, za każdym razem do pełna i do pusta
+    for (int round = 0; round < 4; round++) {
+        wrong += spsc_queue_pop(&q, &item) || !spsc_queue_empty(&q);
+        for (uint32_t i = 0; i < capacity; i++) {
+            const Item in = makeItem(pushed);
+            wrong += !spsc_queue_push(&q, &in);
+            pushed++;
+        }
+        const Item extra = makeItem(0xDEADBEEF);
+        wrong += spsc_queue_push(&q, &extra) || spsc_queue_empty(&q);
+        wrong += q.head - q.tail != capacity;
+
+        for (uint32_t i = 0; i < capacity; i++) {
+            wrong += !spsc_queue_pop(&q, &item) || !sameItem(item, popped);
+            popped++;
+        }
+        wrong += spsc_queue_pop(&q, &item) || !spsc_queue_empty(&q);
+        checked += 2 * capacity + 4;
+
+        // Przesunięcie o pół bufora, żeby następny obrót zaczynał się w środku slotów
+        for (uint32_t i = 0; i < capacity / 2; i++) {
+            const Item in = makeItem(pushed++);
+            wrong += !spsc_queue_push(&q, &in);
+            wrong += !spsc_queue_pop(&q, &item) || !sameItem(item, popped++);
+            checked += 2;
+        }
+    }
+    return wrong;
+}
+
+bool runSingle() {
+    const uint32_t capacities[] = {1, 2, 16, MAX_CAPACITY};
+    bool ok = true;
+    char what[40];
+
+    for (uint32_t capacity : capacities) {
+        uint64_t checked = 0;
+        uint64_t wrong = checkSingle(capacity, 0, checked);
+        wrong += checkSingle(capacity, 0xFFFFFFFFu - capacity, checked);
+        snprintf(what, sizeof(what), "capacity %u", capacity);
+        ok &= report("single", what, 0, 0, 0, checked, wrong);
+    }
+    return ok;
+}
+
+// ========================================
+// THREADS: PRODUCENT I KONSUMENT NA OSOBNYCH WĄTKACH
+// ========================================
+bool runThreads() {
+    const uint32_t capacities[] = {1, 2, 16, MAX_CAPACITY};
+    bool ok = true;
+    char what[40];
+
+    for (uint32_t capacity : capacities) {
+        spsc_queue_t q;
+        // Przejście przez 2^32 mniej więcej w połowie
+        initQueue(&q, capacity, static_cast<uint32_t>(0u - items / 2));
+
+        std::atomic<bool> go{false};
+        uint64_t full = 0, empty = 0, wrong = 0;
+
+        std::thread producer([&] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (uint64_t i = 0; i < items; i++) {
+                const Item in = makeItem(static_cast<uint32_t>(i));
+                while (!spsc_queue_push(&q, &in)) {
+                    full++;
+                    std::this_thread::yield();
+                }
+            }
+        });
+        std::thread consumer([&] {
+            Item item;
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (uint64_t i = 0; i < items; i++) {
+                while (!spsc_queue_pop(&q, &item)) {
+                    empty++;
+                    std::this_thread::yield();
+                }
+                wrong += !sameItem(item, static_cast<uint32_t>(i));
+            }
+        });
+
+        const auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        producer.join();
+        consumer.join();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Na końcu kolejka pusta, a liczniki przeszły przez zero
+        wrong += !spsc_queue_empty(&q) || q.head != static_cast<uint32_t>(0u - items / 2 + items);
+
+        snprintf(what, sizeof(what), "capacity %u", capacity);
+        ok &= report("threads", what, items / seconds / 1e6, full, empty, items, wrong);
+    }
+    return ok;
+}
+
+struct Scenario {
+    const char* name;
+    bool (*run)();
+};
+
+const Scenario scenarios[] = {
+    {"single", runSingle},
+    {"threads", runThreads},
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* only = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--scenario") == 0) {
+            only = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--items") == 0) {
+            items = strtoull(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--scenario name] [--items n]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (items == 0) {
+        fprintf(stderr, "--items must be above 0\n");
+        return 2;
+    }
+
+    printf("%u hardware threads\n", std::thread::hardware_concurrency());
+    printf("%-10s %-22s %9s %11s %11s %11s %8s  %s\n", "scenario", "case", "Mitem/s", "full", "empty", "checked", "wrong",
+           "check");
+
+    bool ok = true, found = false;
+    for (const Scenario& sc : scenarios) {
+        if (only && strcmp(only, sc.name) != 0) continue;
+        found = true;
+        ok &= sc.run();
+    }
+    if (!found) {
+        fprintf(stderr, "unknown scenario %s\n", only);
+        return 2;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,300 @@
+// LVGL tick checks of the host build: lv_tick_get from time_us_64 against the old 1 ms timer
+//
+//     tick_bench [--scenario name]
+//
+// LV_TICK_CUSTOM in lv_conf.h makes LVGL read its millisecond tick from
+// time_us_64(). Before, a repeating 1 ms timer called lv_tick_inc(1). Here the
+// old tick is a counter bumped by the same repeating timer on the virtual clock,
+// with no interrupt cost so it keeps exact time, and the LVGL timer rule is
+// applied to it next to the real LVGL running on the new tick. Every scenario
+// starts 3 s before a 2^32 ms boundary, so the 32-bit tick wraps during it. The
+// program exits with 1 when any check fails.
+//
+// Scenarios:
+//     tick        lv_tick_get() against time_us_64() / 1000 and the old counter
+//                 after steps of 1 us to 7 ms, lv_tick_elaps from the start,
+//                 6 s across the wrap
+//     timers      lv_timers of 1, 30 and 100 ms run by lv_timer_handler at
+//                 irregular wake-ups; each must fire at the virtual times at
+//                 which the old counter would have fired it
+//     countdown   a 5 s countdown label that changes at every whole second and
+//                 a refresh timer of LV_DISP_DEF_REFR_PERIOD; the loop sleeps
+//                 until the next LVGL timer or label change like main_loop and
+//                 every change must be refreshed at the same time as with the
+//                 old counter
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lvgl.h"
+#include "host.h"
+#include "pico/time.h"
+
+#define WRAP_MS 0x100000000ull
+#define LEAD_MS 3000            // start przed przejściem tiku przez zero
+#define MAX_FIRES 8192
+
+// ========================================
+// STARY TIK
+// ========================================
+static volatile uint32_t old_tick;
+static repeating_timer_t old_timer;
+static uint32_t wraps;          // które przejście przez 2^32 ms, każdy scenariusz ma swoje
+
+static bool old_tick_callback(repeating_timer_t *t)
+{
+    (void)t;
+    old_tick++;
+    return true;
+}
+
+// Zegar 3 s przed kolejnym przejściem tiku przez zero, stary licznik od tej chwili
+static void start_near_wrap(void)
+{
+    cancel_repeating_timer(&old_timer);
+    wraps++;
+    host_advance_to_ns((wraps * WRAP_MS - LEAD_MS) * 1000000ull);
+    old_tick = (uint32_t)(time_us_64() / 1000);
+    add_repeating_timer_ms(1, old_tick_callback, NULL, &old_timer);
+}
+
+static uint32_t next_random(uint32_t *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return *seed >> 8;
+}
+
+typedef struct {
+    uint64_t checked;
+    uint32_t wrong;
+    char note[48];
+} result;
+
+// ========================================
+// TICK: ODCZYT TIKU PO KROKACH CZASU
+// ========================================
+static void run_tick(result *res)
+{
+    uint32_t seed = 1;
+    start_near_wrap();
+    const uint32_t first = lv_tick_get();
+    const uint64_t first_ms = time_us_64() / 1000;
+    res->wrong += first != old_tick;
+
+    while (time_us_64() / 1000 < first_ms + 2 * LEAD_MS) {
+        // Od 1 us do 7 ms, także dokładnie na granicy milisekundy
+        const uint32_t r = next_random(&seed);
+        uint64_t step_ns = (r % 7000 + 1) * 1000ull;
+        if ((r & 7) == 0) step_ns = 1000000 - time_us_64() % 1000 * 1000;
+        host_advance_ns(step_ns);
+
+        const uint64_t now_ms = time_us_64() / 1000;
+        res->wrong += lv_tick_get() != (uint32_t)now_ms;
+        res->wrong += old_tick != (uint32_t)now_ms;
+        res->wrong += lv_tick_elaps(first) != (uint32_t)(now_ms - first_ms);
+        res->checked += 3;
+    }
+    // Tik przeszedł przez zero
+    res->wrong += lv_tick_get() >= first;
+    snprintf(res->note, sizeof(res->note), "tick %08x to %08x", (unsigned)first, (unsigned)lv_tick_get());
+}
+
+// ========================================
+// TIMERS: TIMERY LVGL KONTRA STARY LICZNIK
+// ========================================
+typedef struct {
+    uint32_t period;
+    uint32_t fires;
+    uint64_t at_us[MAX_FIRES];
+} fire_log;
+
+// Reguła lv_timer_exec z LVGL v8 na starym liczniku
+typedef struct {
+    uint32_t period;
+    uint32_t last_run;
+    fire_log log;
+} old_timer_model;
+
+static fire_log new_logs[3];
+static old_timer_model old_models[3];
+
+static void log_fire(fire_log *log)
+{
+    if (log->fires < MAX_FIRES) log->at_us[log->fires] = time_us_64();
+    log->fires++;
+}
+
+static void new_timer_fired(lv_timer_t *t)
+{
+    log_fire(t->user_data);
+}
+
+static void old_timers_step(old_timer_model *models, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        if ((uint32_t)(old_tick - models[i].last_run) >= models[i].period) {
+            models[i].last_run = old_tick;
+            log_fire(&models[i].log);
+        }
+    }
+}
+
+static uint32_t logs_differ(const fire_log *got, const fire_log *want)
+{
+    uint32_t wrong = got->fires != want->fires || got->fires == 0 || got->fires > MAX_FIRES;
+    const uint32_t fires = got->fires < want->fires ? got->fires : want->fires;
+    for (uint32_t i = 0; i < fires && i < MAX_FIRES; i++) wrong += got->at_us[i] != want->at_us[i];
+    return wrong;
+}
+
+static void run_timers(result *res)
+{
+    static const uint32_t periods[3] = {1, 30, 100};
+    lv_timer_t *timers[3];
+    uint32_t seed = 2;
+
+    start_near_wrap();
+    memset(new_logs, 0, sizeof(new_logs));
+    memset(old_models, 0, sizeof(old_models));
+    for (int i = 0; i < 3; i++) {
+        timers[i] = lv_timer_create(new_timer_fired, periods[i], &new_logs[i]);
+        old_models[i].period = periods[i];
+        old_models[i].last_run = old_tick;
+    }
+
+    const uint64_t end_us = time_us_64() + 2 * LEAD_MS * 1000;
+    while (time_us_64() < end_us) {
+        lv_timer_handler();
+        old_timers_step(old_models, 3);
+        // Nieregularne przebudzenia jak od przerwań, od 50 us do 2.5 ms
+        host_advance_ns((50 + next_random(&seed) % 2450) * 1000ull);
+    }
+
+    uint32_t fires = 0;
+    for (int i = 0; i < 3; i++) {
+        lv_timer_del(timers[i]);
+        res->wrong += logs_differ(&new_logs[i], &old_models[i].log);
+        res->checked += new_logs[i].fires;
+        fires += new_logs[i].fires;
+    }
+    snprintf(res->note, sizeof(res->note), "1/30/100 ms, %u fires", (unsigned)fires);
+}
+
+// ========================================
+// COUNTDOWN: ETYKIETA ODLICZANIA I ODŚWIEŻANIE
+// ========================================
+#define COUNTDOWN_MS 5000
+
+static bool label_dirty;
+static fire_log new_refresh;
+
+// Jak odświeżanie ekranu w LVGL: rysuje tylko, gdy coś zostało unieważnione
+static void refresh_fired(lv_timer_t *t)
+{
+    (void)t;
+    if (label_dirty) log_fire(&new_refresh);
+    label_dirty = false;
+}
+
+static void run_countdown(result *res)
+{
+    old_timer_model old_refresh;
+    bool old_dirty = false;
+
+    start_near_wrap();
+    memset(&new_refresh, 0, sizeof(new_refresh));
+    memset(&old_refresh, 0, sizeof(old_refresh));
+    label_dirty = false;
+    lv_timer_t *refresh = lv_timer_create(refresh_fired, LV_DISP_DEF_REFR_PERIOD, NULL);
+    old_refresh.period = LV_DISP_DEF_REFR_PERIOD;
+    old_refresh.last_run = old_tick;
+
+    // Koniec odliczania od time_us_64 jak w main.c; etykieta pokazuje sekundy w górę,
+    // zmiany wypadają 700 us przed pełną milisekundą tiku
+    const uint64_t end_us = time_us_64() + COUNTDOWN_MS * 1000 - 700;
+    uint32_t shown = UINT32_MAX, changes = 0;
+    while (time_us_64() < end_us + 100000) {
+        const uint64_t now_us = time_us_64();
+        const uint64_t left_us = now_us < end_us ? end_us - now_us : 0;
+        const uint32_t seconds = (uint32_t)((left_us + 999999) / 1000000);
+        if (seconds != shown) {
+            shown = seconds;
+            label_dirty = old_dirty = true;
+            changes++;
+        }
+
+        const uint32_t wait_ms = lv_timer_handler();
+        const uint32_t before = old_refresh.log.fires;
+        old_timers_step(&old_refresh, 1);
+        if (old_refresh.log.fires != before && !old_dirty) old_refresh.log.fires--;
+        if (old_refresh.log.fires != before) old_dirty = false;
+
+        // Sen do najbliższego timera LVGL albo zmiany etykiety
+        uint64_t sleep_us = (uint64_t)wait_ms * 1000;
+        const uint64_t change_us = left_us % 1000000 ? left_us % 1000000 : 1000000;
+        if (left_us > 0 && change_us < sleep_us) sleep_us = change_us;
+        host_advance_ns((sleep_us ? sleep_us : 1) * 1000);
+    }
+    lv_timer_del(refresh);
+
+    res->wrong = logs_differ(&new_refresh, &old_refresh.log);
+    res->wrong += new_refresh.fires != changes;
+    res->checked = new_refresh.fires;
+    snprintf(res->note, sizeof(res->note), "%u label changes, %u refreshes", (unsigned)changes,
+             (unsigned)new_refresh.fires);
+}
+
+// ========================================
+// SCENARIUSZE
+// ========================================
+typedef struct {
+    const char *name;
+    void (*run)(result *res);
+} scenario;
+
+static const scenario scenarios[] = {
+    {"tick", run_tick},
+    {"timers", run_timers},
+    {"countdown", run_countdown},
+};
+
+int main(int argc, char **argv)
+{
+    const char *only = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--scenario") == 0) {
+            only = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--scenario name]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Stary tik bez kosztu przerwania - idealny przypadek, bez dryfu
+    host_cpu_costs costs = host_get_cpu_costs();
+    costs.irq_entry_ns = 0;
+    host_set_cpu_costs(&costs);
+    lv_init();
+
+    printf("%-10s %11s %7s  %-36s %s\n", "scenario", "checked", "wrong", "", "check");
+    bool ok = true, found = false;
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        const scenario *sc = &scenarios[i];
+        if (only && strcmp(only, sc->name) != 0) continue;
+        found = true;
+
+        result res;
+        memset(&res, 0, sizeof(res));
+        sc->run(&res);
+        const bool passed = res.wrong == 0 && res.checked > 0;
+        printf("%-10s %11llu %7u  %-36s %s\n", sc->name, (unsigned long long)res.checked, (unsigned)res.wrong, res.note,
+               passed ? "ok" : "FAIL");
+        ok &= passed;
+    }
+    if (!found) {
+        fprintf(stderr, "unknown scenario %s\n", only);
+        return 2;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,28 @@
+// Stand-in for hardware/sync.h: interrupt masking and events of the host build
+#ifndef _HOST_HARDWARE_SYNC_H
+#define _HOST_HARDWARE_SYNC_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// While interrupts are off, due events wait and run on restore
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+// Waits for the event flag or the next interrupt, whichever comes first
+void __wfe(void);
+void __wfi(void);
+void __sev(void);
+
+static inline void __dmb(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __mem_fence_acquire(void) { __atomic_thread_fence(__ATOMIC_ACQUIRE); }
+static inline void __mem_fence_release(void) { __atomic_thread_fence(__ATOMIC_RELEASE); }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
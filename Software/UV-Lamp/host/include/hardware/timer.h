@@ -0,0 +1,18 @@
+// Stand-in for hardware/timer.h, reads the virtual clock of the host build
+#ifndef _HOST_HARDWARE_TIMER_H
+#define _HOST_HARDWARE_TIMER_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,129 @@
+// Host build runtime: virtual clock, emulated board and panel (UV_LAMP_HOST)
+#ifndef _HOST_H
+#define _HOST_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ---------------------------------------------------------------------------
+// Virtual clock and event queue. Time only moves in sleeps, busy waits and
+// explicit advances; due events run there as interrupts.
+// ---------------------------------------------------------------------------
+typedef void (*host_event_fn)(void *ctx);
+
+uint64_t host_time_ns(void);
+uint32_t host_schedule_ns(uint64_t at_ns, host_event_fn fn, void *ctx);
+bool host_cancel(uint32_t id);
+uint64_t host_next_event_ns(void);
+void host_advance_to_ns(uint64_t target_ns);
+void host_advance_ns(uint64_t ns);
+
+// Interrupt context: events run only with interrupts enabled and never nest
+bool host_in_irq(void);
+bool host_irqs_enabled(void);
+void host_irq_raise(uint num);
+
+// CPU time charged to the clock on top of the bus time, estimates for 125 MHz
+typedef struct {
+    uint32_t gpio_put_ns;       // one pin write, e.g. CS or DC around a transfer
+    uint32_t spi_call_ns;       // entry and drain of one spi_write_blocking
+    uint32_t dma_start_ns;      // channel setup and trigger
+    uint32_t irq_entry_ns;      // exception entry, shared handler dispatch and exit
+    uint32_t render_byte_ns;    // drawing one byte sent by DMA to SPI, charged before the transfer; 0 by default
+} host_cpu_costs;
+
+host_cpu_costs host_get_cpu_costs(void);
+void host_set_cpu_costs(const host_cpu_costs *costs);
+
+// ---------------------------------------------------------------------------
+// Board
+// ---------------------------------------------------------------------------
+// Wires the panel to the LCD pins of DEV_Config.h
+void host_board_init(void);
+
+// External level on an input pin, edges raise the GPIO interrupt
+void host_gpio_drive(uint gpio, bool level);
+void host_gpio_release(uint gpio);
+bool host_gpio_level(uint gpio);
+
+// Called on every level change of the pin, e.g. chip select of a device
+typedef void (*host_gpio_watch_fn)(void *ctx, uint gpio, bool level);
+void host_gpio_watch(uint gpio, host_gpio_watch_fn watch, void *ctx);
+
+// SPI device, sees every frame together with the pin levels at that time
+typedef void (*host_spi_sink_fn)(void *ctx, const uint8_t *data, size_t len);
+void host_spi_attach(uint index, host_spi_sink_fn sink, void *ctx);
+uint64_t host_spi_bytes(uint index);
+
+// PWM output of one channel: enabled and above zero
+bool host_pwm_active(uint slice, uint chan);
+uint16_t host_pwm_level(uint slice, uint chan);
+uint64_t host_pwm_changed_ns(uint slice);
+
+// Periods with any output of the slice active, the first HOST_PWM_MAX_PERIODS are kept
+#define HOST_PWM_MAX_PERIODS 16
+
+typedef struct {
+    uint64_t on_ns;
+    uint64_t off_ns;            // 0 while still on
+} host_pwm_period;
+
+uint32_t host_pwm_periods(uint slice, const host_pwm_period **periods);
+
+bool host_flash_load(const char *path);
+bool host_flash_save(const char *path);
+
+// ---------------------------------------------------------------------------
+// ST7789 panel on the LCD pins of DEV_Config.h, 240x280 window of 240x320 GRAM
+// ---------------------------------------------------------------------------
+#define HOST_PANEL_WIDTH 240
+#define HOST_PANEL_HEIGHT 280
+
+void host_panel_attach(uint spi_index, uint cs_pin, uint dc_pin, uint rst_pin);
+uint32_t host_panel_pixel(uint x, uint y);   // 0xRRGGBB of visible pixel
+uint64_t host_panel_pixels_written(void);
+
+// Traffic seen by the panel since attach, counters only grow
+typedef struct {
+    uint64_t transactions;      // CS low to CS high
+    uint64_t commands;          // bytes with DC low
+    uint64_t parameter_bytes;   // DC high outside a memory write
+    uint64_t pixel_bytes;       // DC high inside RAMWR/RAMWRC
+    uint64_t dc_switches;
+} host_panel_stats;
+
+host_panel_stats host_panel_get_stats(void);
+bool host_panel_dump_ppm(const char *path);
+
+// ---------------------------------------------------------------------------
+// Input script, commands are listed in host/src/script.c
+// ---------------------------------------------------------------------------
+bool host_script_load(const char *path);
+uint64_t host_script_end_ns(void);
+bool host_script_failed(void);      // an expect command did not hold, the run exits with 1
+
+// ---------------------------------------------------------------------------
+// Input to panel latency: from a script input to the first pixel written after
+// it. An input followed by another one before any pixel counts as unanswered.
+// host_latency_reset starts over, e.g. after a long press whose hold is not latency.
+// ---------------------------------------------------------------------------
+typedef struct {
+    uint32_t answered;
+    uint32_t unanswered;
+    uint64_t total_ns;
+    uint64_t max_ns;
+} host_latency_stats;
+
+void host_latency_input(void);
+void host_latency_output(void);
+void host_latency_reset(void);
+host_latency_stats host_latency_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
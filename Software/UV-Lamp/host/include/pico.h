@@ -0,0 +1,38 @@
+// Stand-in for the Pico SDK base header, host build only (UV_LAMP_HOST)
+#ifndef _HOST_PICO_H
+#define _HOST_PICO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef unsigned int uint;
+
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+
+// Flash is mapped at a RAM image, see host_flash_base()
+#define XIP_BASE ((uintptr_t)host_flash_base())
+uint8_t *host_flash_base(void);
+
+#define __not_in_flash_func(func_name) func_name
+#define __time_critical_func(func_name) func_name
+#define __no_inline_not_in_flash_func(func_name) func_name
+#define __unused __attribute__((unused))
+
+// Busy wait body, advances the virtual clock so polling loops terminate
+void tight_loop_contents(void);
+
+void panic(const char *fmt, ...);
+
+// Core running the calling code, 0 or 1
+uint get_core_num(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,26 @@
+// Stand-in for pico/multicore.h: core1 as a host thread sharing the virtual clock
+#ifndef _HOST_PICO_MULTICORE_H
+#define _HOST_PICO_MULTICORE_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Core1 starts at entry once core0 next waits; core1 halts if entry returns
+void multicore_launch_core1(void (*entry)(void));
+
+// Core1 must call this before core0 can pause it with multicore_lockout_start_blocking
+void multicore_lockout_victim_init(void);
+bool multicore_lockout_victim_is_initialized(uint core_num);
+
+// While locked out core1 does not run, e.g. during flash erase and program
+void multicore_lockout_start_blocking(void);
+void multicore_lockout_end_blocking(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
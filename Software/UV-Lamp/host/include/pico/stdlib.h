@@ -0,0 +1,22 @@
+// Stand-in for pico/stdlib.h, host build only (UV_LAMP_HOST)
+#ifndef _HOST_PICO_STDLIB_H
+#define _HOST_PICO_STDLIB_H
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool stdio_init_all(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
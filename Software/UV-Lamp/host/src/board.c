@@ -0,0 +1,33 @@
+// Board of the host build: clocks, stdio and the panel on the LCD pins
+#include "host.h"
+#include "DEV_Config.h"
+#include "hardware/clocks.h"
+
+bool stdio_init_all(void)
+{
+    return true;
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index)
+{
+    // Zegary domyślne SDK: clk_sys i clk_peri 125 MHz, clk_ref 12 MHz, USB/ADC 48 MHz
+    switch (clk_index) {
+        case clk_sys:
+        case clk_peri:
+            return 125000000;
+        case clk_ref:
+            return 12000000;
+        case clk_usb:
+        case clk_adc:
+            return 48000000;
+        case clk_rtc:
+            return 46875;
+        default:
+            return 0;
+    }
+}
+
+void host_board_init(void)
+{
+    host_panel_attach(spi_get_index(SPI_PORT), LCD_CS_PIN, LCD_DC_PIN, LCD_RST_PIN);
+}
@@ -0,0 +1,565 @@
+// Virtual clock of the host build: event queue, interrupts, sleeps and alarms
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "internal.h"
+#include "pico/time.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+#define HOST_MAX_EVENTS 1024
+#define HOST_MAX_HANDLERS 4
+
+typedef struct {
+    uint64_t at_ns;
+    uint32_t id;
+    host_event_fn fn;
+    void *ctx;
+} host_event;
+
+static uint64_t now_ns;
+static host_event queue[HOST_MAX_EVENTS];
+static uint32_t queue_len;
+static uint32_t next_id = 1;
+
+// Stan jednego rdzenia. Kod rdzeni wykonuje się na przemian (wątki hosta
+// z multicore.cpp), przełączenie następuje tylko w wait().
+typedef struct {
+    bool started;
+    bool irqs_enabled;
+    bool in_irq;
+    bool event_flag;
+    bool irq_enabled[NUM_IRQS];
+    bool irq_pending[NUM_IRQS];
+    bool waiting;           // rdzeń stoi w wait()
+    bool wake_on_event;     // WFE - budzi też flaga zdarzenia
+    uint64_t wake_ns;       // koniec czekania, UINT64_MAX bez terminu
+} host_core;
+
+static host_core cores[HOST_NUM_CORES] = {{.started = true, .irqs_enabled = true}};
+static uint current_core;
+static bool in_event;
+static bool core1_locked_out;
+
+// Szacunki dla 125 MHz: wywołanie gpio_put ~6 cykli, koniec spi_write_blocking
+// (opróżnienie RX, czekanie na BSY) ~40, konfiguracja kanału DMA ~25,
+// wejście i wyjście z przerwania ze wspólnym handlerem ~50
+static host_cpu_costs cpu_costs = {48, 320, 200, 400, 0};
+
+static irq_handler_t irq_handlers[NUM_IRQS][HOST_MAX_HANDLERS];
+static uint8_t irq_handler_count[NUM_IRQS];
+
+// ========================================
+// KOLEJKA ZDARZEŃ
+// ========================================
+uint64_t host_time_ns(void)
+{
+    return now_ns;
+}
+
+uint32_t host_schedule_ns(uint64_t at_ns, host_event_fn fn, void *ctx)
+{
+    if (queue_len == HOST_MAX_EVENTS) {
+        panic("host: event queue full");
+    }
+
+    // Kolejka posortowana po czasie, równe czasy w kolejności dodania
+    uint32_t i = queue_len;
+    while (i > 0 && queue[i - 1].at_ns > at_ns) {
+        queue[i] = queue[i - 1];
+        i--;
+    }
+    queue[i] = (host_event){at_ns, next_id, fn, ctx};
+    queue_len++;
+
+    uint32_t id = next_id++;
+    if (next_id == 0) next_id = 1;
+    return id;
+}
+
+bool host_cancel(uint32_t id)
+{
+    for (uint32_t i = 0; i < queue_len; i++) {
+        if (queue[i].id == id) {
+            for (; i + 1 < queue_len; i++) {
+                queue[i] = queue[i + 1];
+            }
+            queue_len--;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t host_next_event_ns(void)
+{
+    return queue_len > 0 ? queue[0].at_ns : UINT64_MAX;
+}
+
+// Zdarzenia to sprzęt (DMA, piny, skrypt) - działają niezależnie od rdzeni,
+// a ich przerwania czekają w irq_pending na rdzeń, który je obsłuży
+static void run_due_events(void)
+{
+    if (in_event) return;
+
+    while (queue_len > 0 && queue[0].at_ns <= now_ns) {
+        host_event event = queue[0];
+        for (uint32_t i = 1; i < queue_len; i++) {
+            queue[i - 1] = queue[i];
+        }
+        queue_len--;
+
+        in_event = true;
+        event.fn(event.ctx);
+        in_event = false;
+    }
+}
+
+// ========================================
+// PRZERWANIA RDZENI
+// ========================================
+static bool irq_deliverable(const host_core *core)
+{
+    if (!core->irqs_enabled || core->in_irq) return false;
+    for (uint num = 0; num < NUM_IRQS; num++) {
+        if (core->irq_pending[num] && core->irq_enabled[num]) return true;
+    }
+    return false;
+}
+
+// Obsługa zgłoszonych przerwań bieżącego rdzenia, bez zagnieżdżeń
+static void take_irqs(void)
+{
+    host_core *core = &cores[current_core];
+    while (!in_event && irq_deliverable(core)) {
+        for (uint num = 0; num < NUM_IRQS; num++) {
+            if (!core->irq_pending[num] || !core->irq_enabled[num]) continue;
+            core->irq_pending[num] = false;
+
+            core->in_irq = true;
+            host_advance_ns(cpu_costs.irq_entry_ns);
+            for (uint8_t i = 0; i < irq_handler_count[num]; i++) {
+                irq_handlers[num][i]();
+            }
+            core->in_irq = false;
+
+            // Wejście w przerwanie budzi WFE
+            core->event_flag = true;
+        }
+    }
+}
+
+// ========================================
+// SZEREGOWANIE RDZENI
+// ========================================
+static bool core_ready(uint num)
+{
+    const host_core *core = &cores[num];
+    if (!core->started || !core->waiting) return false;
+    if (num == 1 && core1_locked_out) return false;
+    return now_ns >= core->wake_ns || (core->wake_on_event && core->event_flag) || irq_deliverable(core);
+}
+
+static void switch_to(uint num)
+{
+    const uint self = current_core;
+    host_core_switch(self, num);
+    current_core = self;
+}
+
+// Bieżący rdzeń czeka do wake_ns (albo zdarzenia przy WFE). W tym czasie
+// mijają zdarzenia, przychodzą przerwania i pracuje drugi rdzeń.
+static void wait(uint64_t wake_ns, bool wake_on_event)
+{
+    host_core *self = &cores[current_core];
+
+    // Handler przerwania wzięty w trakcie czekania może sam czekać - po nim wraca stan zewnętrzny
+    const bool outer_waiting = self->waiting;
+    const bool outer_wake_on_event = self->wake_on_event;
+    const uint64_t outer_wake_ns = self->wake_ns;
+
+    self->waiting = true;
+    self->wake_ns = wake_ns;
+    self->wake_on_event = wake_on_event;
+
+    for (;;) {
+        run_due_events();
+        take_irqs();
+        if (core_ready(current_core)) break;
+
+        // Drugi rdzeń gotowy - pracuje, dopóki sam nie zacznie czekać
+        const uint other = current_core ^ 1;
+        if (core_ready(other)) {
+            switch_to(other);
+            continue;
+        }
+
+        // Nikt nie może działać - czas do najbliższego zdarzenia lub terminu
+        uint64_t next_ns = host_next_event_ns();
+        for (uint num = 0; num < HOST_NUM_CORES; num++) {
+            const host_core *core = &cores[num];
+            if (core->started && core->waiting && core->wake_ns < next_ns && !(num == 1 && core1_locked_out)) {
+                next_ns = core->wake_ns;
+            }
+        }
+        if (next_ns == UINT64_MAX) {
+            panic("host: core %u waits with nothing to wake it", current_core);
+        }
+        if (next_ns > now_ns) now_ns = next_ns;
+    }
+    self->waiting = outer_waiting;
+    self->wake_on_event = outer_wake_on_event;
+    self->wake_ns = outer_wake_ns;
+}
+
+void host_advance_to_ns(uint64_t target_ns)
+{
+    if (in_event) {
+        // Zdarzenie nie czeka, tylko przesuwa czas
+        if (target_ns > now_ns) now_ns = target_ns;
+        return;
+    }
+    // Także w handlerze: czas płynie dla zdarzeń i drugiego rdzenia, przerwania tego rdzenia czekają
+    wait(target_ns, false);
+}
+
+void host_advance_ns(uint64_t ns)
+{
+    host_advance_to_ns(now_ns + ns);
+}
+
+void host_core_launch(uint num)
+{
+    cores[num] = (host_core){.started = true, .irqs_enabled = true, .waiting = true, .wake_ns = now_ns};
+}
+
+void host_core_enter(uint num)
+{
+    current_core = num;
+    cores[num].waiting = false;
+}
+
+void host_core_halt(void)
+{
+    // Rdzeń po powrocie z funkcji wejściowej już nigdy nie działa
+    cores[current_core].started = false;
+    wait(UINT64_MAX, false);
+}
+
+void host_core_lockout(bool locked_out)
+{
+    core1_locked_out = locked_out;
+}
+
+uint get_core_num(void)
+{
+    return current_core;
+}
+
+// ========================================
+// PRZERWANIA
+// ========================================
+bool host_in_irq(void)
+{
+    return in_event || cores[current_core].in_irq;
+}
+
+bool host_irqs_enabled(void)
+{
+    return cores[current_core].irqs_enabled;
+}
+
+host_cpu_costs host_get_cpu_costs(void)
+{
+    return cpu_costs;
+}
+
+void host_set_cpu_costs(const host_cpu_costs *costs)
+{
+    cpu_costs = *costs;
+}
+
+void host_irq_raise(uint num)
+{
+    if (num >= NUM_IRQS) return;
+
+    // Linia przerwania dochodzi do NVIC obu rdzeni, obsługuje ten, który ją włączył
+    for (uint core = 0; core < HOST_NUM_CORES; core++) {
+        cores[core].irq_pending[num] = true;
+    }
+    take_irqs();
+}
+
+void irq_set_enabled(uint num, bool enabled)
+{
+    if (num >= NUM_IRQS) return;
+    cores[current_core].irq_enabled[num] = enabled;
+    if (enabled) take_irqs();
+}
+
+bool irq_is_enabled(uint num)
+{
+    return num < NUM_IRQS && cores[current_core].irq_enabled[num];
+}
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler)
+{
+    if (num >= NUM_IRQS) return;
+    irq_handlers[num][0] = handler;
+    irq_handler_count[num] = 1;
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority)
+{
+    (void)order_priority;
+    if (num >= NUM_IRQS || irq_handler_count[num] == HOST_MAX_HANDLERS) {
+        panic("host: no room for handler of IRQ %u", num);
+    }
+    irq_handlers[num][irq_handler_count[num]++] = handler;
+}
+
+void irq_remove_handler(uint num, irq_handler_t handler)
+{
+    if (num >= NUM_IRQS) return;
+    for (uint8_t i = 0; i < irq_handler_count[num]; i++) {
+        if (irq_handlers[num][i] == handler) {
+            for (; i + 1 < irq_handler_count[num]; i++) {
+                irq_handlers[num][i] = irq_handlers[num][i + 1];
+            }
+            irq_handler_count[num]--;
+            return;
+        }
+    }
+}
+
+void irq_set_priority(uint num, uint8_t hardware_priority)
+{
+    (void)num;
+    (void)hardware_priority;
+}
+
+uint32_t save_and_disable_interrupts(void)
+{
+    uint32_t status = cores[current_core].irqs_enabled;
+    cores[current_core].irqs_enabled = false;
+    return status;
+}
+
+void restore_interrupts(uint32_t status)
+{
+    cores[current_core].irqs_enabled = status != 0;
+
+    // Przerwania zgłoszone w sekcji krytycznej
+    take_irqs();
+}
+
+void __sev(void)
+{
+    // Zdarzenie dochodzi do obu rdzeni
+    for (uint core = 0; core < HOST_NUM_CORES; core++) {
+        cores[core].event_flag = true;
+    }
+}
+
+void __wfe(void)
+{
+    if (!cores[current_core].event_flag) {
+        wait(UINT64_MAX, true);
+    }
+    cores[current_core].event_flag = false;
+}
+
+void __wfi(void)
+{
+    cores[current_core].event_flag = false;
+    __wfe();
+}
+
+void tight_loop_contents(void)
+{
+    // Jedna iteracja pętli oczekiwania to 1 µs
+    host_advance_ns(1000);
+}
+
+void panic(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "*** PANIC at %.3f ms: ", now_ns / 1e6);
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+    exit(1);
+}
+
+// ========================================
+// CZAS I USYPIANIE
+// ========================================
+uint64_t time_us_64(void)
+{
+    return now_ns / 1000;
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t)(now_ns / 1000);
+}
+
+void sleep_until(absolute_time_t target)
+{
+    host_advance_to_ns(target * 1000);
+}
+
+void sleep_us(uint64_t us)
+{
+    host_advance_ns(us * 1000);
+}
+
+void sleep_ms(uint32_t ms)
+{
+    host_advance_ns((uint64_t)ms * 1000000);
+}
+
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp)
+{
+    const uint64_t timeout_ns = timeout_timestamp * 1000;
+    if (now_ns >= timeout_ns) return true;
+
+    // Budzi pierwsze przerwanie, __sev albo koniec czasu
+    if (!cores[current_core].event_flag) {
+        wait(timeout_ns, true);
+    }
+    cores[current_core].event_flag = false;
+    return now_ns >= timeout_ns;
+}
+
+// ========================================
+// ALARMY I TIMERY POWTARZALNE
+// ========================================
+// Domyślna pula alarmów SDK: przerwanie TIMER_IRQ_3 na rdzeniu 0
+#define HOST_MAX_ALARMS 16
+#define HOST_ALARM_IRQ TIMER_IRQ_3
+
+typedef struct {
+    alarm_id_t id;
+    uint32_t event;
+    uint64_t at_ns;
+    bool due;
+    alarm_callback_t callback;
+    void *user_data;
+} host_alarm;
+
+static host_alarm alarms[HOST_MAX_ALARMS];
+static alarm_id_t next_alarm_id = 1;
+
+static void alarm_fire(void *ctx);
+
+static void alarm_irq_handler(void)
+{
+    for (uint32_t i = 0; i < HOST_MAX_ALARMS; i++) {
+        host_alarm *alarm = &alarms[i];
+        if (alarm->id == 0 || !alarm->due) continue;
+        alarm->due = false;
+
+        const alarm_id_t id = alarm->id;
+        int64_t again = alarm->callback(id, alarm->user_data);
+
+        // Callback mógł anulować alarm
+        if (alarm->id != id) continue;
+        if (again == 0) {
+            alarm->id = 0;
+            continue;
+        }
+
+        // Ujemny wynik liczony od planowanego czasu, dodatni od teraz (jak w SDK)
+        alarm->at_ns = again < 0 ? alarm->at_ns + (uint64_t)(-again) * 1000 : now_ns + (uint64_t)again * 1000;
+        alarm->event = host_schedule_ns(alarm->at_ns, alarm_fire, alarm);
+    }
+}
+
+static void alarm_fire(void *ctx)
+{
+    host_alarm *alarm = ctx;
+    alarm->event = 0;
+    alarm->due = true;
+    host_irq_raise(HOST_ALARM_IRQ);
+}
+
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    if (time * 1000 <= now_ns && !fire_if_past) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < HOST_MAX_ALARMS; i++) {
+        if (alarms[i].id == 0) {
+            if (irq_handler_count[HOST_ALARM_IRQ] == 0) {
+                irq_set_exclusive_handler(HOST_ALARM_IRQ, alarm_irq_handler);
+                cores[0].irq_enabled[HOST_ALARM_IRQ] = true;
+            }
+            alarms[i] = (host_alarm){next_alarm_id++, 0, time * 1000, false, callback, user_data};
+            if (next_alarm_id <= 0) next_alarm_id = 1;
+            alarms[i].event = host_schedule_ns(alarms[i].at_ns, alarm_fire, &alarms[i]);
+            return alarms[i].id;
+        }
+    }
+    return -1;
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    return add_alarm_at(time_us_64() + us, callback, user_data, fire_if_past);
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    return add_alarm_at(time_us_64() + (uint64_t)ms * 1000, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t alarm_id)
+{
+    for (uint32_t i = 0; i < HOST_MAX_ALARMS; i++) {
+        if (alarm_id > 0 && alarms[i].id == alarm_id) {
+            // Alarm czekający już na przerwanie też się nie wykona
+            const bool due = alarms[i].due;
+            alarms[i].id = 0;
+            alarms[i].due = false;
+            return host_cancel(alarms[i].event) || due;
+        }
+    }
+    return false;
+}
+
+static int64_t repeating_timer_fire(alarm_id_t id, void *user_data)
+{
+    repeating_timer_t *rt = user_data;
+    (void)id;
+    if (!rt->callback(rt)) {
+        rt->alarm_id = 0;
+        return 0;
+    }
+    return rt->delay_us;
+}
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out)
+{
+    if (delay_us == 0) delay_us = 1;
+    out->delay_us = delay_us;
+    out->pool = NULL;
+    out->callback = callback;
+    out->user_data = user_data;
+    out->alarm_id = add_alarm_in_us((uint64_t)(delay_us < 0 ? -delay_us : delay_us), repeating_timer_fire, out, true);
+    return out->alarm_id > 0;
+}
+
+bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out)
+{
+    return add_repeating_timer_us((int64_t)delay_ms * 1000, callback, user_data, out);
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer)
+{
+    bool cancelled = timer->alarm_id > 0 && cancel_alarm(timer->alarm_id);
+    timer->alarm_id = 0;
+    return cancelled;
+}
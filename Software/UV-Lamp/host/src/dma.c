@@ -0,0 +1,191 @@
+// DMA of the host build: data moves when triggered, completion comes on the virtual clock
+#include "internal.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+typedef struct {
+    bool claimed;
+    dma_channel_config config;
+    volatile void *write_addr;
+    const volatile void *read_addr;
+    uint32_t count;
+    bool busy;
+    bool irq0_enabled;
+    bool irq0_status;
+    uint32_t event;
+} host_dma;
+
+static host_dma channels[NUM_DMA_CHANNELS];
+
+int dma_claim_unused_channel(bool required)
+{
+    for (uint i = 0; i < NUM_DMA_CHANNELS; i++) {
+        if (!channels[i].claimed) {
+            channels[i].claimed = true;
+            return (int)i;
+        }
+    }
+    if (required) panic("host: no free DMA channel");
+    return -1;
+}
+
+void dma_channel_claim(uint channel)
+{
+    channels[channel].claimed = true;
+}
+
+void dma_channel_unclaim(uint channel)
+{
+    channels[channel].claimed = false;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel)
+{
+    (void)channel;
+    dma_channel_config c = {DMA_SIZE_32, true, false, 0x3f};
+    return c;
+}
+
+static void transfer_done(void *ctx)
+{
+    host_dma *dma = ctx;
+    dma->busy = false;
+    dma->event = 0;
+    dma->irq0_status = true;
+    if (dma->irq0_enabled) {
+        host_irq_raise(DMA_IRQ_0);
+    }
+}
+
+static uint32_t read_item(const volatile uint8_t *src, uint8_t size)
+{
+    switch (size) {
+        case DMA_SIZE_8: return *src;
+        case DMA_SIZE_16: return *(const volatile uint16_t *)src;
+        default: return *(const volatile uint32_t *)src;
+    }
+}
+
+static void start(host_dma *dma)
+{
+    const uint8_t size = dma->config.size;
+    const uint32_t step = 1u << size;
+    const volatile uint8_t *src = dma->read_addr;
+    spi_inst_t *spi = host_spi_of_dr(dma->write_addr);
+    uint64_t duration_ns = 0;
+
+    host_advance_ns(host_get_cpu_costs().dma_start_ns);
+
+    if (spi != NULL) {
+        // Rysowanie danych przed transferem, dla symulacji ciężkich ekranów
+        host_advance_ns((uint64_t)dma->count * step * host_get_cpu_costs().render_byte_ns);
+
+        // Ramki do SPI od razu, zakończenie po czasie ich wysłania
+        const uint bits = host_spi_data_bits(spi);
+        uint8_t chunk[256];
+        size_t used = 0;
+        for (uint32_t i = 0; i < dma->count; i++) {
+            const uint32_t item = read_item(src, size);
+            if (bits > 8) chunk[used++] = (uint8_t)(item >> 8);
+            chunk[used++] = (uint8_t)item;
+            if (used >= sizeof(chunk) - 1) {
+                host_spi_emit(spi, chunk, used);
+                used = 0;
+            }
+            if (dma->config.read_increment) src += step;
+        }
+        host_spi_emit(spi, chunk, used);
+        duration_ns = dma->count * host_spi_frame_ns(spi);
+        host_spi_hold(spi, host_time_ns() + duration_ns);
+    } else {
+        volatile uint8_t *dst = dma->write_addr;
+        for (uint32_t i = 0; i < dma->count; i++) {
+            const uint32_t item = read_item(src, size);
+            switch (size) {
+                case DMA_SIZE_8: *dst = (uint8_t)item; break;
+                case DMA_SIZE_16: *(volatile uint16_t *)dst = (uint16_t)item; break;
+                default: *(volatile uint32_t *)dst = item; break;
+            }
+            if (dma->config.read_increment) src += step;
+            if (dma->config.write_increment) dst += step;
+        }
+    }
+
+    dma->read_addr = src;
+    dma->busy = true;
+    dma->event = host_schedule_ns(host_time_ns() + duration_ns, transfer_done, dma);
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger)
+{
+    host_dma *dma = &channels[channel];
+    dma->config = *config;
+    dma->write_addr = write_addr;
+    dma->read_addr = read_addr;
+    dma->count = transfer_count;
+    if (trigger) start(dma);
+}
+
+void dma_channel_set_config(uint channel, const dma_channel_config *config, bool trigger)
+{
+    channels[channel].config = *config;
+    if (trigger) start(&channels[channel]);
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger)
+{
+    channels[channel].read_addr = read_addr;
+    if (trigger) start(&channels[channel]);
+}
+
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger)
+{
+    channels[channel].write_addr = write_addr;
+    if (trigger) start(&channels[channel]);
+}
+
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger)
+{
+    channels[channel].count = trans_count;
+    if (trigger) start(&channels[channel]);
+}
+
+void dma_channel_start(uint channel)
+{
+    start(&channels[channel]);
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count)
+{
+    channels[channel].read_addr = read_addr;
+    channels[channel].count = transfer_count;
+    start(&channels[channel]);
+}
+
+bool dma_channel_is_busy(uint channel)
+{
+    return channels[channel].busy;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel)
+{
+    while (channels[channel].busy) {
+        tight_loop_contents();
+    }
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled)
+{
+    channels[channel].irq0_enabled = enabled;
+}
+
+bool dma_channel_get_irq0_status(uint channel)
+{
+    return channels[channel].irq0_status;
+}
+
+void dma_channel_acknowledge_irq0(uint channel)
+{
+    channels[channel].irq0_status = false;
+}
@@ -0,0 +1,63 @@
+// Flash of the host build: NOR semantics on a RAM image, with erase and program times
+#include <stdio.h>
+#include <string.h>
+
+#include "host.h"
+#include "hardware/flash.h"
+
+// Typowe czasy W25Q16: kasowanie sektora 45 ms, programowanie strony 0,7 ms
+#define FLASH_ERASE_SECTOR_NS 45000000ull
+#define FLASH_PROGRAM_PAGE_NS 700000ull
+
+static uint8_t image[PICO_FLASH_SIZE_BYTES];
+static bool erased;
+
+uint8_t *host_flash_base(void)
+{
+    if (!erased) {
+        memset(image, 0xFF, sizeof(image));
+        erased = true;
+    }
+    return image;
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count)
+{
+    if (flash_offs % FLASH_SECTOR_SIZE || count % FLASH_SECTOR_SIZE || flash_offs + count > sizeof(image)) {
+        panic("host: flash_range_erase(0x%x, %zu) not sector aligned", flash_offs, count);
+    }
+    memset(host_flash_base() + flash_offs, 0xFF, count);
+    host_advance_ns(count / FLASH_SECTOR_SIZE * FLASH_ERASE_SECTOR_NS);
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count)
+{
+    if (flash_offs % FLASH_PAGE_SIZE || count % FLASH_PAGE_SIZE || flash_offs + count > sizeof(image)) {
+        panic("host: flash_range_program(0x%x, %zu) not page aligned", flash_offs, count);
+    }
+
+    // Programowanie tylko zeruje bity
+    uint8_t *dst = host_flash_base() + flash_offs;
+    for (size_t i = 0; i < count; i++) {
+        dst[i] &= data[i];
+    }
+    host_advance_ns(count / FLASH_PAGE_SIZE * FLASH_PROGRAM_PAGE_NS);
+}
+
+bool host_flash_load(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return false;
+    const size_t read = fread(host_flash_base(), 1, sizeof(image), file);
+    fclose(file);
+    return read > 0;
+}
+
+bool host_flash_save(const char *path)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) return false;
+    const size_t written = fwrite(host_flash_base(), 1, sizeof(image), file);
+    fclose(file);
+    return written == sizeof(image);
+}
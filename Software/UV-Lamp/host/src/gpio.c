@@ -0,0 +1,176 @@
+// GPIO of the host build: outputs, pulls, external drive and edge interrupts
+#include "host.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+
+typedef struct {
+    enum gpio_function function;
+    bool out;
+    bool out_level;
+    bool pull_up;
+    bool pull_down;
+    bool driven;        // poziom wymuszony z zewnątrz (skrypt)
+    bool drive_level;
+    uint32_t irq_mask;
+} host_gpio;
+
+static host_gpio pins[NUM_BANK0_GPIOS];
+static host_gpio_watch_fn watches[NUM_BANK0_GPIOS];
+static void *watch_ctx[NUM_BANK0_GPIOS];
+static gpio_irq_callback_t irq_callback;
+static uint32_t irq_events[NUM_BANK0_GPIOS];
+
+static bool level_of(const host_gpio *pin)
+{
+    if (pin->function == GPIO_FUNC_SIO && pin->out) return pin->out_level;
+    if (pin->driven) return pin->drive_level;
+    return pin->pull_up;
+}
+
+static void gpio_irq_handler(void)
+{
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++) {
+        uint32_t events = irq_events[gpio];
+        if (events == 0) continue;
+        irq_events[gpio] = 0;
+        if (irq_callback) irq_callback(gpio, events);
+    }
+}
+
+// Zbocze zapisane jak w rejestrze INTR, zgłoszenie przez IO_IRQ_BANK0
+static void level_changed(uint gpio, bool before)
+{
+    const bool after = level_of(&pins[gpio]);
+    if (before == after) return;
+    if (watches[gpio]) watches[gpio](watch_ctx[gpio], gpio, after);
+
+    const uint32_t edge = after ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+    if (pins[gpio].irq_mask & edge) {
+        irq_events[gpio] |= edge;
+        host_irq_raise(IO_IRQ_BANK0);
+    }
+}
+
+void gpio_init(uint gpio)
+{
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    const bool before = level_of(&pins[gpio]);
+    pins[gpio].function = GPIO_FUNC_SIO;
+    pins[gpio].out = false;
+    pins[gpio].out_level = false;
+    level_changed(gpio, before);
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn)
+{
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    pins[gpio].function = fn;
+}
+
+void gpio_set_dir(uint gpio, bool out)
+{
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    const bool before = level_of(&pins[gpio]);
+    pins[gpio].out = out;
+    level_changed(gpio, before);
+}
+
+void gpio_put(uint gpio, bool value)
+{
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    const bool before = level_of(&pins[gpio]);
+    pins[gpio].out_level = value;
+    level_changed(gpio, before);
+    host_advance_ns(host_get_cpu_costs().gpio_put_ns);
+}
+
+bool gpio_get(uint gpio)
+{
+    return gpio < NUM_BANK0_GPIOS && level_of(&pins[gpio]);
+}
+
+void gpio_pull_up(uint gpio)
+{
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    const bool before = level_of(&pins[gpio]);
+    pins[gpio].pull_up = true;
+    pins[gpio].pull_down = false;
+    level_changed(gpio, before);
+}
+
+void gpio_pull_down(uint gpio)
+{
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    const bool before = level_of(&pins[gpio]);
+    pins[gpio].pull_up = false;
+    pins[gpio].pull_down = true;
+    level_changed(gpio, before);
+}
+
+void gpio_disable_pulls(uint gpio)
+{
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    const bool before = level_of(&pins[gpio]);
+    pins[gpio].pull_up = false;
+    pins[gpio].pull_down = false;
+    level_changed(gpio, before);
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled)
+{
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    if (enabled) {
+        pins[gpio].irq_mask |= event_mask;
+    } else {
+        pins[gpio].irq_mask &= ~event_mask;
+    }
+}
+
+void gpio_set_irq_callback(gpio_irq_callback_t callback)
+{
+    static bool installed = false;
+    if (!installed) {
+        irq_add_shared_handler(IO_IRQ_BANK0, gpio_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        installed = true;
+    }
+    irq_callback = callback;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback)
+{
+    gpio_set_irq_enabled(gpio, event_mask, enabled);
+    gpio_set_irq_callback(callback);
+    if (enabled) irq_set_enabled(IO_IRQ_BANK0, true);
+}
+
+// ========================================
+// STEROWANIE Z ZEWNĄTRZ
+// ========================================
+void host_gpio_drive(uint gpio, bool level)
+{
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    const bool before = level_of(&pins[gpio]);
+    pins[gpio].driven = true;
+    pins[gpio].drive_level = level;
+    level_changed(gpio, before);
+}
+
+void host_gpio_release(uint gpio)
+{
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    const bool before = level_of(&pins[gpio]);
+    pins[gpio].driven = false;
+    level_changed(gpio, before);
+}
+
+bool host_gpio_level(uint gpio)
+{
+    return gpio_get(gpio);
+}
+
+void host_gpio_watch(uint gpio, host_gpio_watch_fn watch, void *ctx)
+{
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    watches[gpio] = watch;
+    watch_ctx[gpio] = ctx;
+}
@@ -0,0 +1,46 @@
+// Shared between the stand-in peripherals of the host build
+#ifndef _HOST_INTERNAL_H
+#define _HOST_INTERNAL_H
+
+#include "host.h"
+#include "hardware/spi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Rdzenie RP2040. Kod rdzeni działa w osobnych wątkach, ale zawsze tylko jeden
+// naraz - wirtualny zegar przekazuje wykonanie w miejscach, gdzie rdzeń czeka.
+#define HOST_NUM_CORES 2
+
+// Oddaje wykonanie rdzeniowi to i wraca, gdy rdzeń from znów je dostanie (multicore.cpp)
+void host_core_switch(uint from, uint to);
+
+// Rdzeń gotowy do startu od bieżącej chwili, pierwsze wykonanie w host_core_enter()
+void host_core_launch(uint num);
+void host_core_enter(uint num);
+
+// Koniec funkcji wejściowej rdzenia, nie wraca
+void host_core_halt(void);
+
+// Rdzeń 1 wstrzymany przez multicore_lockout
+void host_core_lockout(bool locked_out);
+
+// SPI whose data register is at addr, NULL for memory
+spi_inst_t *host_spi_of_dr(const volatile void *addr);
+
+// Time of one frame at the current format and rate
+uint64_t host_spi_frame_ns(const spi_inst_t *spi);
+uint host_spi_data_bits(const spi_inst_t *spi);
+
+// Hands bytes to the attached device, the caller accounts for the time
+void host_spi_emit(spi_inst_t *spi, const uint8_t *data, size_t len);
+
+// Shift register busy until the given time
+void host_spi_hold(spi_inst_t *spi, uint64_t until_ns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
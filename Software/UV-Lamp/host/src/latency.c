@@ -0,0 +1,37 @@
+// Input to panel latency of the host build
+#include <string.h>
+
+#include "host.h"
+
+static host_latency_stats stats;
+static uint64_t input_ns;
+static bool waiting;
+
+void host_latency_input(void)
+{
+    // Poprzednie wejście bez zmiany na ekranie nie wlicza się do średniej
+    if (waiting) stats.unanswered++;
+    input_ns = host_time_ns();
+    waiting = true;
+}
+
+void host_latency_output(void)
+{
+    if (!waiting) return;
+    const uint64_t latency_ns = host_time_ns() - input_ns;
+    waiting = false;
+    stats.answered++;
+    stats.total_ns += latency_ns;
+    if (latency_ns > stats.max_ns) stats.max_ns = latency_ns;
+}
+
+void host_latency_reset(void)
+{
+    memset(&stats, 0, sizeof(stats));
+    waiting = false;
+}
+
+host_latency_stats host_latency_get(void)
+{
+    return stats;
+}
@@ -0,0 +1,101 @@
+// Entry point of the host build, runs main() of the firmware on the virtual clock
+//
+//     UV-Lamp [--script file] [--run-ms ms] [--dump file.ppm] [--flash file] [--render-ms ms]
+//
+// The run ends at --run-ms (default: one second after the last script command,
+// or 5 s without a script) or at a 'quit' in the script. The panel is then
+// written to --dump and the flash image to --flash, which is also loaded at start.
+// --render-ms charges CPU time for drawing, as ms per full frame sent to the panel,
+// to replay heavy scenes; the PWM periods at the end show how the lamp kept time.
+// A failed expect command of the script makes the exit status 1.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host.h"
+#include "hardware/pwm.h"
+
+// main() z main.c, przemianowana przy budowaniu na hosta
+int firmware_main(void);
+
+static const char *dump_path;
+static const char *flash_path;
+
+static void finish(void)
+{
+    fprintf(stderr, "host: %.3f ms, %llu SPI bytes, %llu pixels written\n", host_time_ns() / 1e6,
+            (unsigned long long)host_spi_bytes(0), (unsigned long long)host_panel_pixels_written());
+
+    const host_latency_stats latency = host_latency_get();
+    if (latency.answered + latency.unanswered > 0) {
+        fprintf(stderr, "host: input to panel %.3f ms avg, %.3f ms max over %u inputs, %u without a change\n",
+                latency.answered ? latency.total_ns / 1e6 / latency.answered : 0.0, latency.max_ns / 1e6,
+                (unsigned)latency.answered, (unsigned)latency.unanswered);
+    }
+    for (uint slice = 0; slice < NUM_PWM_SLICES; slice++) {
+        const host_pwm_period *periods;
+        const uint32_t count = host_pwm_periods(slice, &periods);
+        for (uint32_t i = 0; i < count; i++) {
+            if (periods[i].off_ns == 0) {
+                fprintf(stderr, "host: PWM slice %u on at %.3f ms, still on\n", slice, periods[i].on_ns / 1e6);
+            } else {
+                fprintf(stderr, "host: PWM slice %u on at %.3f ms for %.3f ms\n", slice, periods[i].on_ns / 1e6,
+                        (periods[i].off_ns - periods[i].on_ns) / 1e6);
+            }
+        }
+    }
+    if (dump_path && !host_panel_dump_ppm(dump_path)) {
+        fprintf(stderr, "host: cannot write %s\n", dump_path);
+    }
+    if (flash_path && !host_flash_save(flash_path)) {
+        fprintf(stderr, "host: cannot write %s\n", flash_path);
+    }
+}
+
+static void end_of_run(void *ctx)
+{
+    (void)ctx;
+    exit(host_script_failed() ? 1 : 0);
+}
+
+int main(int argc, char **argv)
+{
+    const char *script_path = NULL;
+    double run_ms = 0;
+    double render_ms = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--script") == 0) {
+            script_path = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--run-ms") == 0) {
+            run_ms = atof(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--dump") == 0) {
+            dump_path = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--flash") == 0) {
+            flash_path = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--render-ms") == 0) {
+            render_ms = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--script file] [--run-ms ms] [--dump file.ppm] [--flash file] [--render-ms ms]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    host_board_init();
+    if (render_ms > 0) {
+        // Ramka RGB565 to dwa bajty na piksel
+        host_cpu_costs costs = host_get_cpu_costs();
+        costs.render_byte_ns = (uint32_t)(render_ms * 1e6 / (HOST_PANEL_WIDTH * HOST_PANEL_HEIGHT * 2));
+        host_set_cpu_costs(&costs);
+    }
+    if (flash_path) host_flash_load(flash_path);
+    if (script_path && !host_script_load(script_path)) return 2;
+
+    uint64_t end_ns = script_path ? host_script_end_ns() + 1000000000ull : 5000000000ull;
+    if (run_ms > 0) end_ns = (uint64_t)(run_ms * 1e6);
+    host_schedule_ns(end_ns, end_of_run, NULL);
+
+    atexit(finish);
+    return firmware_main();
+}
@@ -0,0 +1,84 @@
+// Core1 of the host build: a std::thread that takes turns with core0 on the virtual clock
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "internal.h"
+#include "pico/multicore.h"
+
+namespace {
+
+// Rdzeń, który ma teraz wykonanie; pozostałe wątki czekają na zmiennej warunkowej.
+// Obiekty nigdy nie są niszczone - exit() może przyjść z dowolnego wątku.
+std::mutex *baton_lock = new std::mutex;
+std::condition_variable *baton_changed = new std::condition_variable;
+uint baton = 0;
+
+bool core1_launched;
+bool core1_victim;
+bool locked_out;
+
+void wait_for_baton(uint core)
+{
+    std::unique_lock<std::mutex> guard(*baton_lock);
+    baton_changed->wait(guard, [core] { return baton == core; });
+}
+
+} // namespace
+
+extern "C" {
+
+void host_core_switch(uint from, uint to)
+{
+    {
+        std::lock_guard<std::mutex> guard(*baton_lock);
+        baton = to;
+    }
+    baton_changed->notify_all();
+    wait_for_baton(from);
+}
+
+void multicore_launch_core1(void (*entry)(void))
+{
+    if (core1_launched) {
+        panic("host: core1 already launched");
+    }
+    core1_launched = true;
+
+    std::thread([entry] {
+        wait_for_baton(1);
+        host_core_enter(1);
+        entry();
+        host_core_halt();
+    }).detach();
+    host_core_launch(1);
+}
+
+void multicore_lockout_victim_init(void)
+{
+    if (get_core_num() == 1) core1_victim = true;
+}
+
+bool multicore_lockout_victim_is_initialized(uint core_num)
+{
+    return core_num == 1 && core1_victim;
+}
+
+void multicore_lockout_start_blocking(void)
+{
+    // Na płytce rdzeń 0 czekałby w nieskończoność na odpowiedź z FIFO
+    if (get_core_num() != 0 || !core1_victim) {
+        panic("host: lockout of core1 without multicore_lockout_victim_init");
+    }
+    locked_out = true;
+    host_core_lockout(true);
+}
+
+void multicore_lockout_end_blocking(void)
+{
+    if (!locked_out) return;
+    locked_out = false;
+    host_core_lockout(false);
+}
+
+} // extern "C"
@@ -0,0 +1,269 @@
+// ST7789V2 of the 1.69" module, rebuilt from the SPI stream of the host build
+#include <stdio.h>
+#include <string.h>
+
+#include "host.h"
+#include "hardware/gpio.h"
+
+#define GRAM_WIDTH 240
+#define GRAM_HEIGHT 320
+#define GLASS_OFFSET 20     // 280 widocznych wierszy zaczyna się 20 wierszy w GRAM
+
+#define MADCTL_MY 0x80
+#define MADCTL_MX 0x40
+#define MADCTL_MV 0x20
+#define MADCTL_BGR 0x08
+
+typedef struct {
+    uint cs_pin;
+    uint dc_pin;
+    uint rst_pin;
+
+    uint8_t cmd;
+    uint8_t params[8];
+    uint8_t param_count;
+    bool writing;
+
+    uint8_t madctl;
+    uint8_t colmod;
+    bool inverted;
+    bool display_on;
+    bool sleeping;
+
+    uint16_t xs, xe, ys, ye;    // okno w adresach logicznych
+    uint16_t cx, cy;            // kursor zapisu
+    uint8_t pending[3];         // niepełny piksel (lub para w 12 bitach)
+    uint8_t pending_count;
+
+    uint64_t pixels_written;
+    host_panel_stats stats;
+    uint32_t gram[GRAM_HEIGHT][GRAM_WIDTH];     // 0xRRGGBB
+} host_panel;
+
+static host_panel panel;
+
+static void reset(void)
+{
+    panel.madctl = 0;
+    panel.colmod = 0x66;
+    panel.inverted = false;
+    panel.display_on = false;
+    panel.sleeping = true;
+    panel.xs = 0;
+    panel.xe = GRAM_WIDTH - 1;
+    panel.ys = 0;
+    panel.ye = GRAM_HEIGHT - 1;
+    panel.writing = false;
+    panel.param_count = 0;
+    panel.pending_count = 0;
+}
+
+// ========================================
+// ZAPIS PIKSELI
+// ========================================
+static void put_pixel(uint32_t rgb)
+{
+    // Adres logiczny -> fizyczny według MADCTL: lustra, potem zamiana osi
+    const bool mv = panel.madctl & MADCTL_MV;
+    uint32_t c = panel.cx, r = panel.cy;
+    if (panel.madctl & MADCTL_MX) c = (mv ? GRAM_HEIGHT : GRAM_WIDTH) - 1 - c;
+    if (panel.madctl & MADCTL_MY) r = (mv ? GRAM_WIDTH : GRAM_HEIGHT) - 1 - r;
+    const uint32_t px = mv ? r : c, py = mv ? c : r;
+
+    if (panel.madctl & MADCTL_BGR) {
+        rgb = ((rgb & 0xFF) << 16) | (rgb & 0xFF00) | (rgb >> 16);
+    }
+    if (px < GRAM_WIDTH && py < GRAM_HEIGHT) {
+        panel.gram[py][px] = rgb;
+    }
+    panel.pixels_written++;
+
+    // Kursor biegnie wierszami w obrębie okna i zawija się na początek
+    if (++panel.cx > panel.xe) {
+        panel.cx = panel.xs;
+        if (++panel.cy > panel.ye) panel.cy = panel.ys;
+    }
+}
+
+static uint32_t expand(uint32_t value, uint bits)
+{
+    value <<= 8 - bits;
+    return value | (value >> bits);
+}
+
+static void write_data(uint8_t byte)
+{
+    panel.pending[panel.pending_count++] = byte;
+
+    switch (panel.colmod & 0x07) {
+        case 0x03:  // RRRRGGGG BBBBRRRR GGGGBBBB
+            // Pierwszy piksel pary jest pełny po 12 bitach - nieparzysty ostatni piksel
+            // przychodzi w 2 bajtach i też trafia do GRAM
+            if (panel.pending_count == 2) {
+                put_pixel(expand(panel.pending[0] >> 4, 4) << 16 | expand(panel.pending[0] & 0x0F, 4) << 8 | expand(panel.pending[1] >> 4, 4));
+            }
+            if (panel.pending_count < 3) return;
+            put_pixel(expand(panel.pending[1] & 0x0F, 4) << 16 | expand(panel.pending[2] >> 4, 4) << 8 | expand(panel.pending[2] & 0x0F, 4));
+            break;
+        case 0x06:  // RRRRRR-- GGGGGG-- BBBBBB--
+            if (panel.pending_count < 3) return;
+            put_pixel(expand(panel.pending[0] >> 2, 6) << 16 | expand(panel.pending[1] >> 2, 6) << 8 | expand(panel.pending[2] >> 2, 6));
+            break;
+        default: {  // RRRRRGGG GGGBBBBB
+            if (panel.pending_count < 2) return;
+            const uint32_t v = panel.pending[0] << 8 | panel.pending[1];
+            put_pixel(expand(v >> 11, 5) << 16 | expand((v >> 5) & 0x3F, 6) << 8 | expand(v & 0x1F, 5));
+            break;
+        }
+    }
+    panel.pending_count = 0;
+}
+
+// ========================================
+// KOMENDY
+// ========================================
+static void command(uint8_t cmd)
+{
+    panel.cmd = cmd;
+    panel.param_count = 0;
+    panel.writing = false;
+    panel.pending_count = 0;
+
+    switch (cmd) {
+        case 0x01: reset(); break;                      // SWRESET
+        case 0x10: panel.sleeping = true; break;        // SLPIN
+        case 0x11: panel.sleeping = false; break;       // SLPOUT
+        case 0x20: panel.inverted = false; break;       // INVOFF
+        case 0x21: panel.inverted = true; break;        // INVON
+        case 0x28: panel.display_on = false; break;     // DISPOFF
+        case 0x29: panel.display_on = true; break;      // DISPON
+        case 0x2C:                                      // RAMWR
+            panel.cx = panel.xs;
+            panel.cy = panel.ys;
+            panel.writing = true;
+            break;
+        case 0x3C:                                      // RAMWRC
+            panel.writing = true;
+            break;
+        default: break;
+    }
+}
+
+static void parameter(uint8_t byte)
+{
+    if (panel.param_count < sizeof(panel.params)) {
+        panel.params[panel.param_count] = byte;
+    }
+    panel.param_count++;
+    const uint8_t *p = panel.params;
+
+    switch (panel.cmd) {
+        case 0x2A:  // CASET
+            if (panel.param_count == 4) {
+                panel.xs = p[0] << 8 | p[1];
+                panel.xe = p[2] << 8 | p[3];
+            }
+            break;
+        case 0x2B:  // RASET
+            if (panel.param_count == 4) {
+                panel.ys = p[0] << 8 | p[1];
+                panel.ye = p[2] << 8 | p[3];
+            }
+            break;
+        case 0x36:  // MADCTL
+            if (panel.param_count == 1) panel.madctl = byte;
+            break;
+        case 0x3A:  // COLMOD
+            if (panel.param_count == 1) panel.colmod = byte;
+            break;
+        default:
+            break;
+    }
+}
+
+static void receive(void *ctx, const uint8_t *data, size_t len)
+{
+    (void)ctx;
+    if (gpio_get(panel.cs_pin) || !gpio_get(panel.rst_pin)) return;
+
+    if (!gpio_get(panel.dc_pin)) {
+        panel.stats.commands += len;
+        for (size_t i = 0; i < len; i++) command(data[i]);
+    } else if (panel.writing) {
+        panel.stats.pixel_bytes += len;
+        host_latency_output();
+        for (size_t i = 0; i < len; i++) write_data(data[i]);
+    } else {
+        panel.stats.parameter_bytes += len;
+        for (size_t i = 0; i < len; i++) parameter(data[i]);
+    }
+}
+
+static void pin_changed(void *ctx, uint gpio, bool level)
+{
+    (void)ctx;
+    if (gpio == panel.cs_pin && level) {
+        // Koniec transakcji przerywa parametry i niepełny piksel, kursor zostaje
+        panel.param_count = 0;
+        panel.pending_count = 0;
+        panel.stats.transactions++;
+    } else if (gpio == panel.dc_pin) {
+        panel.stats.dc_switches++;
+    } else if (gpio == panel.rst_pin && !level) {
+        reset();
+    }
+}
+
+void host_panel_attach(uint spi_index, uint cs_pin, uint dc_pin, uint rst_pin)
+{
+    panel.cs_pin = cs_pin;
+    panel.dc_pin = dc_pin;
+    panel.rst_pin = rst_pin;
+    reset();
+    host_spi_attach(spi_index, receive, NULL);
+    host_gpio_watch(cs_pin, pin_changed, NULL);
+    host_gpio_watch(dc_pin, pin_changed, NULL);
+    host_gpio_watch(rst_pin, pin_changed, NULL);
+}
+
+// ========================================
+// ODCZYT OBRAZU
+// ========================================
+uint32_t host_panel_pixel(uint x, uint y)
+{
+    if (x >= HOST_PANEL_WIDTH || y >= HOST_PANEL_HEIGHT) return 0;
+    if (!panel.display_on || panel.sleeping) return 0;
+
+    // Matryca IPS odwraca kolory, poprawny obraz daje dopiero INVON
+    const uint32_t rgb = panel.gram[y + GLASS_OFFSET][x];
+    return panel.inverted ? rgb : ~rgb & 0xFFFFFF;
+}
+
+uint64_t host_panel_pixels_written(void)
+{
+    return panel.pixels_written;
+}
+
+host_panel_stats host_panel_get_stats(void)
+{
+    return panel.stats;
+}
+
+bool host_panel_dump_ppm(const char *path)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) return false;
+
+    fprintf(file, "P6\n%d %d\n255\n", HOST_PANEL_WIDTH, HOST_PANEL_HEIGHT);
+    for (uint y = 0; y < HOST_PANEL_HEIGHT; y++) {
+        uint8_t row[HOST_PANEL_WIDTH * 3];
+        for (uint x = 0; x < HOST_PANEL_WIDTH; x++) {
+            const uint32_t rgb = host_panel_pixel(x, y);
+            row[x * 3] = rgb >> 16;
+            row[x * 3 + 1] = rgb >> 8;
+            row[x * 3 + 2] = rgb;
+        }
+        fwrite(row, 1, sizeof(row), file);
+    }
+    return fclose(file) == 0;
+}
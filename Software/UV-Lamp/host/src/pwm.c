@@ -0,0 +1,112 @@
+// PWM of the host build, records when the output of a slice changes
+#include "host.h"
+#include "hardware/pwm.h"
+
+typedef struct {
+    bool enabled;
+    uint16_t top;
+    float div;
+    uint16_t level[2];
+    uint64_t changed_ns;
+    host_pwm_period periods[HOST_PWM_MAX_PERIODS];
+    uint32_t period_count;
+} host_pwm;
+
+static host_pwm slices[NUM_PWM_SLICES];
+
+static uint8_t output_of(const host_pwm *pwm)
+{
+    return (pwm->enabled && pwm->level[0] > 0) | (pwm->enabled && pwm->level[1] > 0) << 1;
+}
+
+// Zapis czasu każdej zmiany stanu wyjść
+static void note_change(host_pwm *pwm, uint8_t before)
+{
+    const uint8_t after = output_of(pwm);
+    if (after == before) return;
+    pwm->changed_ns = host_time_ns();
+
+    // Okresy włączenia: od pierwszego aktywnego kanału do wyłączenia obu
+    if (before == 0 && pwm->period_count < HOST_PWM_MAX_PERIODS) {
+        pwm->periods[pwm->period_count++] = (host_pwm_period){pwm->changed_ns, 0};
+    } else if (after == 0 && pwm->period_count > 0 && pwm->periods[pwm->period_count - 1].off_ns == 0) {
+        pwm->periods[pwm->period_count - 1].off_ns = pwm->changed_ns;
+    }
+}
+
+void pwm_init(uint slice_num, pwm_config *c, bool start)
+{
+    host_pwm *pwm = &slices[slice_num & 7];
+    const uint8_t before = output_of(pwm);
+    pwm->top = c->top;
+    pwm->div = c->div;
+    pwm->level[0] = 0;
+    pwm->level[1] = 0;
+    pwm->enabled = start;
+    note_change(pwm, before);
+}
+
+void pwm_set_wrap(uint slice_num, uint16_t wrap)
+{
+    slices[slice_num & 7].top = wrap;
+}
+
+void pwm_set_clkdiv(uint slice_num, float divider)
+{
+    slices[slice_num & 7].div = divider;
+}
+
+void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level)
+{
+    host_pwm *pwm = &slices[slice_num & 7];
+    const uint8_t before = output_of(pwm);
+    pwm->level[chan & 1] = level;
+    note_change(pwm, before);
+}
+
+void pwm_set_both_levels(uint slice_num, uint16_t level_a, uint16_t level_b)
+{
+    pwm_set_chan_level(slice_num, PWM_CHAN_A, level_a);
+    pwm_set_chan_level(slice_num, PWM_CHAN_B, level_b);
+}
+
+void pwm_set_gpio_level(uint gpio, uint16_t level)
+{
+    pwm_set_chan_level(pwm_gpio_to_slice_num(gpio), pwm_gpio_to_channel(gpio), level);
+}
+
+void pwm_set_enabled(uint slice_num, bool enabled)
+{
+    host_pwm *pwm = &slices[slice_num & 7];
+    const uint8_t before = output_of(pwm);
+    pwm->enabled = enabled;
+    note_change(pwm, before);
+}
+
+void pwm_set_mask_enabled(uint32_t mask)
+{
+    for (uint slice = 0; slice < NUM_PWM_SLICES; slice++) {
+        pwm_set_enabled(slice, (mask >> slice) & 1);
+    }
+}
+
+bool host_pwm_active(uint slice, uint chan)
+{
+    return (output_of(&slices[slice & 7]) >> (chan & 1)) & 1;
+}
+
+uint16_t host_pwm_level(uint slice, uint chan)
+{
+    return slices[slice & 7].level[chan & 1];
+}
+
+uint64_t host_pwm_changed_ns(uint slice)
+{
+    return slices[slice & 7].changed_ns;
+}
+
+uint32_t host_pwm_periods(uint slice, const host_pwm_period **periods)
+{
+    *periods = slices[slice & 7].periods;
+    return slices[slice & 7].period_count;
+}
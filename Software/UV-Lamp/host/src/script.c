@@ -0,0 +1,233 @@
+// Input script of the host build
+//
+// One command per line, time in ms since boot, '#' starts a comment:
+//     <ms> press <input>              input pulled low (buttons are active low)
+//     <ms> release <input>            input back to its pull
+//     <ms> click <input> [hold_ms]    press, release after hold_ms (default 80); the
+//                                     firmware acts on the release, latency counts from it
+//     <ms> turn <steps> [step_ms]     encoder quadrature steps, negative turns back (default 2 ms apart)
+//     <ms> dump <file.ppm>            panel contents to PPM
+//     <ms> expect_pwm <slice> <on_ms> [tolerance_us]
+//                                     the slice is off and was on for on_ms in total
+//                                     (default tolerance 50 us), else the run fails
+//     <ms> latency_start              forget the input to panel latency measured so far
+//     <ms> expect_latency <max_ms>    some input since latency_start reached the panel and
+//                                     none took longer than max_ms, else the run fails
+//     <ms> quit                       end of run
+// Inputs: butt1, butt2 or a GPIO number; the encoder is on enc_a and enc_b.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host.h"
+
+// Wejścia jak w main.c
+#define ENC_A_PIN 10
+#define ENC_B_PIN 11
+
+typedef enum {
+    ACTION_PRESS,
+    ACTION_RELEASE,
+    ACTION_STEP,
+    ACTION_DUMP,
+    ACTION_EXPECT_PWM,
+    ACTION_LATENCY_START,
+    ACTION_EXPECT_LATENCY,
+    ACTION_QUIT
+} action_kind;
+
+typedef struct {
+    action_kind kind;
+    int value;          // pin, kierunek kroku albo slice PWM
+    uint64_t on_ns;     // oczekiwany łączny czas włączenia PWM albo największe opóźnienie
+    uint64_t tolerance_ns;
+    bool input;         // początek pomiaru opóźnienia (obrót liczy się raz)
+    char path[256];
+} action;
+
+static const struct {
+    const char *name;
+    uint pin;
+} inputs[] = {
+    {"butt1", 9},
+    {"butt2", 8},
+    {"enc_a", ENC_A_PIN},
+    {"enc_b", ENC_B_PIN},
+};
+
+static uint64_t end_ns;
+static bool failed;
+
+// Łączny czas włączenia slice; wyłączony w chwili sprawdzenia
+static void expect_pwm(const action *a)
+{
+    const host_pwm_period *periods;
+    const uint32_t count = host_pwm_periods(a->value, &periods);
+    uint64_t on_ns = 0;
+    bool off = true;
+    for (uint32_t i = 0; i < count; i++) {
+        if (periods[i].off_ns == 0) {
+            off = false;
+        } else {
+            on_ns += periods[i].off_ns - periods[i].on_ns;
+        }
+    }
+
+    const uint64_t error_ns = on_ns > a->on_ns ? on_ns - a->on_ns : a->on_ns - on_ns;
+    const bool ok = off && count > 0 && count < HOST_PWM_MAX_PERIODS && error_ns <= a->tolerance_ns;
+    fprintf(stderr, "host: expect PWM slice %u on for %.3f ms: %s %.3f ms in %u periods, off by %.3f us: %s\n",
+            (unsigned)a->value, a->on_ns / 1e6, off ? "off after" : "still on after", on_ns / 1e6, (unsigned)count,
+            error_ns / 1e3, ok ? "ok" : "FAIL");
+    if (!ok) failed = true;
+}
+
+// Najgorsze opóźnienie od latency_start; wejście bez zmiany na ekranie się nie liczy
+static void expect_latency(const action *a)
+{
+    const host_latency_stats latency = host_latency_get();
+    const bool ok = latency.answered > 0 && latency.max_ns <= a->on_ns;
+    fprintf(stderr, "host: expect input to panel within %.3f ms: %.3f ms max over %u inputs, %u without a change: %s\n",
+            a->on_ns / 1e6, latency.max_ns / 1e6, (unsigned)latency.answered, (unsigned)latency.unanswered,
+            ok ? "ok" : "FAIL");
+    if (!ok) failed = true;
+}
+
+static void run(void *ctx)
+{
+    action *a = ctx;
+    if (a->input) host_latency_input();
+    switch (a->kind) {
+        case ACTION_PRESS:
+            host_gpio_drive(a->value, false);
+            break;
+        case ACTION_RELEASE:
+            host_gpio_release(a->value);
+            break;
+        case ACTION_STEP: {
+            // Kod Graya w kolejności dekodera z main.c: 00 -> 01 -> 11 -> 10
+            static const uint8_t gray[4] = {0, 1, 3, 2};
+            const uint8_t state = host_gpio_level(ENC_A_PIN) << 1 | host_gpio_level(ENC_B_PIN);
+            uint8_t phase = 0;
+            while (gray[phase] != state) phase++;
+            const uint8_t next = gray[(phase + a->value) & 3];
+            if ((next ^ state) & 2) host_gpio_drive(ENC_A_PIN, next & 2);
+            if ((next ^ state) & 1) host_gpio_drive(ENC_B_PIN, next & 1);
+            break;
+        }
+        case ACTION_DUMP:
+            if (!host_panel_dump_ppm(a->path)) {
+                fprintf(stderr, "host: cannot write %s\n", a->path);
+            }
+            break;
+        case ACTION_EXPECT_PWM:
+            expect_pwm(a);
+            break;
+        case ACTION_LATENCY_START:
+            host_latency_reset();
+            break;
+        case ACTION_EXPECT_LATENCY:
+            expect_latency(a);
+            break;
+        case ACTION_QUIT:
+            exit(failed ? 1 : 0);
+    }
+    free(a);
+}
+
+static action *schedule(uint64_t at_ns, action_kind kind, int value, const char *path)
+{
+    action *a = calloc(1, sizeof(action));
+    a->kind = kind;
+    a->value = value;
+    a->input = kind == ACTION_PRESS || kind == ACTION_RELEASE || kind == ACTION_STEP;
+    if (path) snprintf(a->path, sizeof(a->path), "%s", path);
+    host_schedule_ns(at_ns, run, a);
+    if (at_ns > end_ns) end_ns = at_ns;
+    return a;
+}
+
+static bool parse_input(const char *name, int *pin)
+{
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        if (strcmp(name, inputs[i].name) == 0) {
+            *pin = inputs[i].pin;
+            return true;
+        }
+    }
+    char *end;
+    long value = strtol(name, &end, 10);
+    if (*end != '\0' || value < 0 || value >= 30) return false;
+    *pin = (int)value;
+    return true;
+}
+
+bool host_script_load(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "host: cannot open script %s\n", path);
+        return false;
+    }
+
+    char line[512];
+    unsigned number = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), file)) {
+        number++;
+        char *comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+
+        double ms, arg2 = -1, arg3 = -1;
+        char command[32], arg[256] = "";
+        const int fields = sscanf(line, "%lf %31s %255s %lf %lf", &ms, command, arg, &arg2, &arg3);
+        if (fields <= 0) continue;
+
+        const uint64_t at_ns = (uint64_t)(ms * 1e6);
+        int pin;
+        if (fields >= 3 && strcmp(command, "press") == 0 && parse_input(arg, &pin)) {
+            schedule(at_ns, ACTION_PRESS, pin, NULL);
+        } else if (fields >= 3 && strcmp(command, "release") == 0 && parse_input(arg, &pin)) {
+            schedule(at_ns, ACTION_RELEASE, pin, NULL);
+        } else if (fields >= 3 && strcmp(command, "click") == 0 && parse_input(arg, &pin)) {
+            const double hold = arg2 > 0 ? arg2 : 80;
+            action *press = schedule(at_ns, ACTION_PRESS, pin, NULL);
+            press->input = false;
+            schedule(at_ns + (uint64_t)(hold * 1e6), ACTION_RELEASE, pin, NULL);
+        } else if (fields >= 3 && strcmp(command, "turn") == 0) {
+            const int steps = atoi(arg);
+            const double spacing = arg2 > 0 ? arg2 : 2;
+            for (int i = 0; i < abs(steps); i++) {
+                action *step = schedule(at_ns + (uint64_t)(i * spacing * 1e6), ACTION_STEP, steps > 0 ? 1 : -1, NULL);
+                step->input = i == 0;
+            }
+        } else if (fields >= 3 && strcmp(command, "dump") == 0) {
+            schedule(at_ns, ACTION_DUMP, 0, arg);
+        } else if (fields >= 4 && strcmp(command, "expect_pwm") == 0 && atoi(arg) >= 0 && atoi(arg) < 8 && arg2 >= 0) {
+            action *expect = schedule(at_ns, ACTION_EXPECT_PWM, atoi(arg), NULL);
+            expect->on_ns = (uint64_t)(arg2 * 1e6);
+            expect->tolerance_ns = (uint64_t)((arg3 >= 0 ? arg3 : 50) * 1e3);
+        } else if (fields >= 2 && strcmp(command, "latency_start") == 0) {
+            schedule(at_ns, ACTION_LATENCY_START, 0, NULL);
+        } else if (fields >= 3 && strcmp(command, "expect_latency") == 0 && atof(arg) > 0) {
+            action *expect = schedule(at_ns, ACTION_EXPECT_LATENCY, 0, NULL);
+            expect->on_ns = (uint64_t)(atof(arg) * 1e6);
+        } else if (fields >= 2 && strcmp(command, "quit") == 0) {
+            schedule(at_ns, ACTION_QUIT, 0, NULL);
+        } else {
+            fprintf(stderr, "%s:%u: bad command\n", path, number);
+            ok = false;
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+uint64_t host_script_end_ns(void)
+{
+    return end_ns;
+}
+
+bool host_script_failed(void)
+{
+    return failed;
+}
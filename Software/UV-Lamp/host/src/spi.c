@@ -0,0 +1,139 @@
+// SPI of the host build: SDK baud divider, frames timed on the virtual clock
+#include "internal.h"
+#include "hardware/clocks.h"
+
+spi_inst_t host_spi_inst[2] = {{.index = 0}, {.index = 1}};
+
+typedef struct {
+    uint baudrate;
+    uint data_bits;
+    uint64_t busy_until_ns;
+    uint64_t bytes;
+    host_spi_sink_fn sink;
+    void *ctx;
+} host_spi;
+
+static host_spi buses[2] = {{.data_bits = 8}, {.data_bits = 8}};
+
+uint spi_set_baudrate(spi_inst_t *spi, uint baudrate)
+{
+    // Ten sam podział clk_peri co w SDK: preskaler parzysty 2..254, dzielnik 1..256
+    const uint32_t freq_in = clock_get_hz(clk_peri);
+    uint prescale, postdiv;
+    for (prescale = 2; prescale <= 254; prescale += 2) {
+        if (freq_in < (prescale + 2) * 256 * (uint64_t)baudrate) break;
+    }
+    if (prescale > 254) prescale = 254;
+    for (postdiv = 256; postdiv > 1; --postdiv) {
+        if (freq_in / (prescale * (postdiv - 1)) > baudrate) break;
+    }
+
+    buses[spi->index].baudrate = freq_in / (prescale * postdiv);
+    return buses[spi->index].baudrate;
+}
+
+uint spi_get_baudrate(const spi_inst_t *spi)
+{
+    return buses[spi->index].baudrate;
+}
+
+uint spi_init(spi_inst_t *spi, uint baudrate)
+{
+    buses[spi->index].data_bits = 8;
+    buses[spi->index].busy_until_ns = 0;
+    return spi_set_baudrate(spi, baudrate);
+}
+
+void spi_deinit(spi_inst_t *spi)
+{
+    buses[spi->index].baudrate = 0;
+}
+
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order)
+{
+    (void)cpol;
+    (void)cpha;
+    (void)order;
+    buses[spi->index].data_bits = data_bits;
+}
+
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len)
+{
+    host_spi_emit(spi, src, len);
+    host_advance_ns(len * host_spi_frame_ns(spi) + host_get_cpu_costs().spi_call_ns);
+    return (int)len;
+}
+
+int spi_write16_blocking(spi_inst_t *spi, const uint16_t *src, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        const uint8_t frame[2] = {(uint8_t)(src[i] >> 8), (uint8_t)src[i]};
+        host_spi_emit(spi, frame, 2);
+    }
+    host_advance_ns(len * host_spi_frame_ns(spi) + host_get_cpu_costs().spi_call_ns);
+    return (int)len;
+}
+
+bool spi_is_writable(const spi_inst_t *spi)
+{
+    (void)spi;
+    return true;
+}
+
+bool spi_is_readable(const spi_inst_t *spi)
+{
+    (void)spi;
+    return false;
+}
+
+bool spi_is_busy(const spi_inst_t *spi)
+{
+    return host_time_ns() < buses[spi->index].busy_until_ns;
+}
+
+// ========================================
+// DOSTĘP DLA DMA I PŁYTKI
+// ========================================
+spi_inst_t *host_spi_of_dr(const volatile void *addr)
+{
+    for (uint i = 0; i < 2; i++) {
+        if (addr == &host_spi_inst[i].hw.dr) return &host_spi_inst[i];
+    }
+    return NULL;
+}
+
+uint64_t host_spi_frame_ns(const spi_inst_t *spi)
+{
+    const host_spi *bus = &buses[spi->index];
+    if (bus->baudrate == 0) return 0;
+    return (bus->data_bits * 1000000000ull + bus->baudrate / 2) / bus->baudrate;
+}
+
+uint host_spi_data_bits(const spi_inst_t *spi)
+{
+    return buses[spi->index].data_bits;
+}
+
+void host_spi_emit(spi_inst_t *spi, const uint8_t *data, size_t len)
+{
+    host_spi *bus = &buses[spi->index];
+    bus->bytes += len;
+    if (bus->sink) bus->sink(bus->ctx, data, len);
+}
+
+void host_spi_hold(spi_inst_t *spi, uint64_t until_ns)
+{
+    buses[spi->index].busy_until_ns = until_ns;
+}
+
+void host_spi_attach(uint index, host_spi_sink_fn sink, void *ctx)
+{
+    if (index >= 2) return;
+    buses[index].sink = sink;
+    buses[index].ctx = ctx;
+}
+
+uint64_t host_spi_bytes(uint index)
+{
+    return index < 2 ? buses[index].bytes : 0;
+}
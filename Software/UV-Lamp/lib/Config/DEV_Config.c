@@ -30,6 +30,14 @@
 
 uint slice_num;
 
+static int dma_tx_channel = -1;
+static dma_channel_config dma_tx_config;
+static dma_channel_config dma_fill_config;
+static volatile bool dma_tx_busy = false;
+static volatile bool dma_tx_16bit = false;
+static volatile DEV_DMA_Callback dma_tx_done = NULL;
+static uint16_t dma_fill_value;
+
 /**
  * GPIO read and write
  **/
@@ -49,13 +57,131 @@ void DEV_IRQ_SET(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t c
  * SPI
  **/
 void DEV_SPI_WriteByte(uint8_t Value) {
+    DEV_SPI_DMA_Wait();
     spi_write_blocking(SPI_PORT, &Value, 1);
 }
 
-void DEV_SPI_Write_nByte(uint8_t pData[], uint32_t Len) {
+void DEV_SPI_Write_nByte(const uint8_t pData[], uint32_t Len) {
+    DEV_SPI_DMA_Wait();
     spi_write_blocking(SPI_PORT, pData, Len);
 }
 
+/**
+ * SPI DMA
+ **/
+static void DEV_SPI_DMA_IRQHandler(void) {
+    if (dma_tx_channel < 0 || !dma_channel_get_irq0_status(dma_tx_channel)) {
+        return;
+    }
+    dma_channel_acknowledge_irq0(dma_tx_channel);
+
+    // DMA is done once the last byte is in the TX FIFO, wait until it is on the wire
+    while (spi_is_busy(SPI_PORT)) {
+        tight_loop_contents();
+    }
+
+    // Drop what was clocked in during the transfer and clear the overrun flag
+    while (spi_is_readable(SPI_PORT)) {
+        (void)spi_get_hw(SPI_PORT)->dr;
+    }
+    spi_get_hw(SPI_PORT)->icr = SPI_SSPICR_RORIC_BITS;
+
+    // Back to byte frames after a 16-bit fill
+    if (dma_tx_16bit) {
+        spi_set_format(SPI_PORT, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+        dma_tx_16bit = false;
+    }
+
+    // The callback may start the next transfer right away
+    DEV_DMA_Callback done = dma_tx_done;
+    dma_tx_done = NULL;
+    dma_tx_busy = false;
+    if (done) {
+        done();
+    }
+}
+
+void DEV_SPI_DMA_Init(void) {
+    if (dma_tx_channel >= 0) {
+        return;
+    }
+    dma_tx_channel = dma_claim_unused_channel(true);
+
+    dma_tx_config = dma_channel_get_default_config(dma_tx_channel);
+    channel_config_set_transfer_data_size(&dma_tx_config, DMA_SIZE_8);
+    channel_config_set_read_increment(&dma_tx_config, true);
+    channel_config_set_write_increment(&dma_tx_config, false);
+    channel_config_set_dreq(&dma_tx_config, spi_get_dreq(SPI_PORT, true));
+    dma_channel_configure(dma_tx_channel, &dma_tx_config, &spi_get_hw(SPI_PORT)->dr, NULL, 0, false);
+
+    // Fills read the same halfword over and over into a 16-bit frame SPI
+    dma_fill_config = dma_tx_config;
+    channel_config_set_transfer_data_size(&dma_fill_config, DMA_SIZE_16);
+    channel_config_set_read_increment(&dma_fill_config, false);
+
+    dma_channel_set_irq0_enabled(dma_tx_channel, true);
+    irq_add_shared_handler(DMA_IRQ_0, DEV_SPI_DMA_IRQHandler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+void DEV_SPI_Write_nByte_DMA(const uint8_t *pData, uint32_t Len, DEV_DMA_Callback Done) {
+    DEV_SPI_DMA_Wait();
+
+    // Without a channel fall back to a blocking write, the callback still fires
+    if (dma_tx_channel < 0 || Len == 0) {
+        spi_write_blocking(SPI_PORT, pData, Len);
+        if (Done) {
+            Done();
+        }
+        return;
+    }
+
+    dma_tx_done = Done;
+    dma_tx_busy = true;
+    dma_channel_set_config(dma_tx_channel, &dma_tx_config, false);
+    dma_channel_transfer_from_buffer_now(dma_tx_channel, pData, Len);
+}
+
+void DEV_SPI_Fill16_DMA(uint16_t Value, uint32_t Count, DEV_DMA_Callback Done) {
+    DEV_SPI_DMA_Wait();
+
+    // Without a channel stream a small pattern, MSB first like a 16-bit frame
+    if (dma_tx_channel < 0 || Count == 0) {
+        uint8_t Pattern[32];
+        for (uint32_t i = 0; i < sizeof(Pattern); i += 2) {
+            Pattern[i] = Value >> 8;
+            Pattern[i + 1] = Value & 0xFF;
+        }
+        while (Count > 0) {
+            uint32_t n = Count < sizeof(Pattern) / 2 ? Count : sizeof(Pattern) / 2;
+            spi_write_blocking(SPI_PORT, Pattern, n * 2);
+            Count -= n;
+        }
+        if (Done) {
+            Done();
+        }
+        return;
+    }
+
+    dma_fill_value = Value;
+    spi_set_format(SPI_PORT, 16, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+    dma_tx_16bit = true;
+    dma_tx_done = Done;
+    dma_tx_busy = true;
+    dma_channel_set_config(dma_tx_channel, &dma_fill_config, false);
+    dma_channel_transfer_from_buffer_now(dma_tx_channel, &dma_fill_value, Count);
+}
+
+bool DEV_SPI_DMA_Busy(void) {
+    return dma_tx_busy;
+}
+
+void DEV_SPI_DMA_Wait(void) {
+    while (dma_tx_busy) {
+        tight_loop_contents();
+    }
+}
+
 /**
  * GPIO Mode
  **/
@@ -134,6 +260,7 @@ uint8_t DEV_Module_Init(void) {
     spi_init(SPI_PORT, 40000 * 1000);
     gpio_set_function(LCD_CLK_PIN, GPIO_FUNC_SPI);
     gpio_set_function(LCD_MOSI_PIN, GPIO_FUNC_SPI);
+    DEV_SPI_DMA_Init();
 
     printf("DEV_Module_Init OK \r\n");
     return 0;
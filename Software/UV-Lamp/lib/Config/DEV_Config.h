@@ -34,6 +34,8 @@
 #include "hardware/gpio.h"
 #include "hardware/spi.h"
 #include "hardware/pwm.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
 
 // Data types
 #define UBYTE uint8_t
@@ -51,6 +53,9 @@
 #define LCD_BL_PIN    (6)
 #define LCD_BL_PIN_PWM_CHANNEL PWM_CHAN_A
 
+// Called from the DMA IRQ once a transfer has left the SPI shift register
+typedef void (*DEV_DMA_Callback)(void);
+
 void DEV_Digital_Write(uint16_t Pin, uint8_t Value);
 uint8_t DEV_Digital_Read(uint16_t Pin);
 
@@ -62,7 +67,13 @@ void DEV_IRQ_SET(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t c
 uint16_t DEC_ADC_Read(void);
 
 void DEV_SPI_WriteByte(uint8_t Value);
-void DEV_SPI_Write_nByte(uint8_t *pData, uint32_t Len);
+void DEV_SPI_Write_nByte(const uint8_t *pData, uint32_t Len);
+
+void DEV_SPI_DMA_Init(void);
+void DEV_SPI_Write_nByte_DMA(const uint8_t *pData, uint32_t Len, DEV_DMA_Callback Done);
+void DEV_SPI_Fill16_DMA(uint16_t Value, uint32_t Count, DEV_DMA_Callback Done);
+bool DEV_SPI_DMA_Busy(void);
+void DEV_SPI_DMA_Wait(void);
 
 void DEV_Delay_ms(uint32_t xms);
 void DEV_Delay_us(uint32_t xus);
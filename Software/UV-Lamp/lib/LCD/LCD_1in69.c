@@ -15,14 +15,56 @@
 #include <stdlib.h> //itoa()
 #include <stdio.h>
 
+// Pixels packed per chunk in 12-bit mode, one chunk is packed while the other is sent
+#define LCD_1IN69_PACK_PIXELS 256
+
 LCD_1IN69_ATTRIBUTES LCD_1IN69;
 
+// Power-on register sequence, sent in order by LCD_1IN69_InitReg
+// MADCTL is left to LCD_1IN69_SetAttributes, a copy here would undo the scan direction
+typedef struct {
+    UBYTE Cmd;
+    UBYTE Len;
+    UBYTE Delay_ms;
+    UBYTE Params[14];
+} LCD_1IN69_INIT_CMD;
+
+static const LCD_1IN69_INIT_CMD LCD_1IN69_InitTable[] = {
+    {0x3A, 1,  0, {0x05}},
+    {0xB2, 5,  0, {0x0B, 0x0B, 0x00, 0x33, 0x35}},
+    {0xB7, 1,  0, {0x11}},
+    {0xBB, 1,  0, {0x35}},
+    {0xC0, 1,  0, {0x2C}},
+    {0xC2, 1,  0, {0x01}},
+    {0xC3, 1,  0, {0x0D}},
+    {0xC4, 1,  0, {0x20}},
+    {0xC6, 1,  0, {0x13}},
+    {0xD0, 2,  0, {0xA4, 0xA1}},
+    {0xD6, 1,  0, {0xA1}},
+    {0xE0, 14, 0, {0xF0, 0x06, 0x0B, 0x0A, 0x09, 0x26, 0x29,
+                   0x33, 0x41, 0x18, 0x16, 0x15, 0x29, 0x2D}},
+    {0xE1, 14, 0, {0xF0, 0x04, 0x08, 0x08, 0x07, 0x03, 0x28,
+                   0x32, 0x40, 0x3B, 0x19, 0x18, 0x2A, 0x2E}},
+    {0xE4, 3,  0, {0x25, 0x00, 0x00}},
+    {0x21, 0,  0, {0}},
+    {0x11, 0,  120, {0}},
+    {0x29, 0,  0, {0}},
+};
+
+// User callback of the DMA transfer in flight
+static volatile DEV_DMA_Callback LCD_1IN69_TransferDone = NULL;
+
+// Staging for RGB444 transfers (2 pixels -> 3 bytes)
+static UBYTE LCD_1IN69_PackBuf[2][LCD_1IN69_PACK_PIXELS * 3 / 2];
+static UBYTE LCD_1IN69_PackHalf = 0;
+
 /******************************************************************************
 function :  Hardware reset
 parameter:
 ******************************************************************************/
 static void LCD_1IN69_Reset(void)
 {
+    LCD_1IN69_InvalidateWindow();
     DEV_Digital_Write(LCD_RST_PIN, 1);
     DEV_Delay_ms(100);
     DEV_Digital_Write(LCD_RST_PIN, 0);
@@ -32,134 +74,42 @@ static void LCD_1IN69_Reset(void)
 }
 
 /******************************************************************************
-function :  send command
+function :  Send a command with its parameters in one transaction
 parameter:
-     Reg : Command register
+     Cmd    : Command register
+     Params : Parameter bytes, may be NULL when Len is 0
+     Len    : Number of parameter bytes
+Info     :  CS is taken once and DC switched once, the parameters go out
+            as a single SPI burst
 ******************************************************************************/
-static void LCD_1IN69_SendCommand(UBYTE Reg)
+void LCD_1IN69_WriteCmd(UBYTE Cmd, const UBYTE *Params, UWORD Len)
 {
+    DEV_SPI_DMA_Wait();
     DEV_Digital_Write(LCD_DC_PIN, 0);
     DEV_Digital_Write(LCD_CS_PIN, 0);
-    DEV_SPI_WriteByte(Reg);
-    DEV_Digital_Write(LCD_CS_PIN, 1);
-}
-
-/******************************************************************************
-function :  send data
-parameter:
-    Data : Write data
-******************************************************************************/
-static void LCD_1IN69_SendData_8Bit(UBYTE Data)
-{
-    DEV_Digital_Write(LCD_DC_PIN, 1);
-    DEV_Digital_Write(LCD_CS_PIN, 0);
-    DEV_SPI_WriteByte(Data);
-    DEV_Digital_Write(LCD_CS_PIN, 1);
-}
-
-/******************************************************************************
-function :  send data
-parameter:
-    Data : Write data
-******************************************************************************/
-static void LCD_1IN69_SendData_16Bit(UWORD Data)
-{
-    DEV_Digital_Write(LCD_DC_PIN, 1);
-    DEV_Digital_Write(LCD_CS_PIN, 0);
-    DEV_SPI_WriteByte((Data >> 8) & 0xFF);
-    DEV_SPI_WriteByte(Data & 0xFF);
+    DEV_SPI_WriteByte(Cmd);
+    if (Len > 0) {
+        DEV_Digital_Write(LCD_DC_PIN, 1);
+        DEV_SPI_Write_nByte(Params, Len);
+    }
     DEV_Digital_Write(LCD_CS_PIN, 1);
 }
 
 /******************************************************************************
 function :  Initialize the lcd register
 parameter:
+Info     :  Walks LCD_1IN69_InitTable, one transaction per command
 ******************************************************************************/
 static void LCD_1IN69_InitReg(void)
 {
-    LCD_1IN69_SendCommand(0x36);
-    LCD_1IN69_SendData_8Bit(0x00);
-
-    LCD_1IN69_SendCommand(0x3A);
-    LCD_1IN69_SendData_8Bit(0x05);
-
-    LCD_1IN69_SendCommand(0xB2);
-    LCD_1IN69_SendData_8Bit(0x0B);
-    LCD_1IN69_SendData_8Bit(0x0B);
-    LCD_1IN69_SendData_8Bit(0x00);
-    LCD_1IN69_SendData_8Bit(0x33);
-    LCD_1IN69_SendData_8Bit(0x35);
-
-    LCD_1IN69_SendCommand(0xB7);
-    LCD_1IN69_SendData_8Bit(0x11);
-
-    LCD_1IN69_SendCommand(0xBB);
-    LCD_1IN69_SendData_8Bit(0x35);
-
-    LCD_1IN69_SendCommand(0xC0);
-    LCD_1IN69_SendData_8Bit(0x2C);
-
-    LCD_1IN69_SendCommand(0xC2);
-    LCD_1IN69_SendData_8Bit(0x01);
-
-    LCD_1IN69_SendCommand(0xC3);
-    LCD_1IN69_SendData_8Bit(0x0D);
-
-    LCD_1IN69_SendCommand(0xC4);
-    LCD_1IN69_SendData_8Bit(0x20);
-
-    LCD_1IN69_SendCommand(0xC6);
-    LCD_1IN69_SendData_8Bit(0x13);
-
-    LCD_1IN69_SendCommand(0xD0);
-    LCD_1IN69_SendData_8Bit(0xA4);
-    LCD_1IN69_SendData_8Bit(0xA1);
-
-    LCD_1IN69_SendCommand(0xD6);
-    LCD_1IN69_SendData_8Bit(0xA1);
-
-    LCD_1IN69_SendCommand(0xE0);
-    LCD_1IN69_SendData_8Bit(0xF0);
-    LCD_1IN69_SendData_8Bit(0x06);
-    LCD_1IN69_SendData_8Bit(0x0B);
-    LCD_1IN69_SendData_8Bit(0x0A);
-    LCD_1IN69_SendData_8Bit(0x09);
-    LCD_1IN69_SendData_8Bit(0x26);
-    LCD_1IN69_SendData_8Bit(0x29);
-    LCD_1IN69_SendData_8Bit(0x33);
-    LCD_1IN69_SendData_8Bit(0x41);
-    LCD_1IN69_SendData_8Bit(0x18);
-    LCD_1IN69_SendData_8Bit(0x16);
-    LCD_1IN69_SendData_8Bit(0x15);
-    LCD_1IN69_SendData_8Bit(0x29);
-    LCD_1IN69_SendData_8Bit(0x2D);
-
-    LCD_1IN69_SendCommand(0xE1);
-    LCD_1IN69_SendData_8Bit(0xF0);
-    LCD_1IN69_SendData_8Bit(0x04);
-    LCD_1IN69_SendData_8Bit(0x08);
-    LCD_1IN69_SendData_8Bit(0x08);
-    LCD_1IN69_SendData_8Bit(0x07);
-    LCD_1IN69_SendData_8Bit(0x03);
-    LCD_1IN69_SendData_8Bit(0x28);
-    LCD_1IN69_SendData_8Bit(0x32);
-    LCD_1IN69_SendData_8Bit(0x40);
-    LCD_1IN69_SendData_8Bit(0x3B);
-    LCD_1IN69_SendData_8Bit(0x19);
-    LCD_1IN69_SendData_8Bit(0x18);
-    LCD_1IN69_SendData_8Bit(0x2A);
-    LCD_1IN69_SendData_8Bit(0x2E);
-
-    LCD_1IN69_SendCommand(0xE4);
-    LCD_1IN69_SendData_8Bit(0x25);
-    LCD_1IN69_SendData_8Bit(0x00);
-    LCD_1IN69_SendData_8Bit(0x00);
-
-    LCD_1IN69_SendCommand(0x21);
-
-    LCD_1IN69_SendCommand(0x11);
-    DEV_Delay_ms(120);
-    LCD_1IN69_SendCommand(0x29);
+    UWORD i;
+    for (i = 0; i < sizeof(LCD_1IN69_InitTable) / sizeof(LCD_1IN69_InitTable[0]); i++) {
+        const LCD_1IN69_INIT_CMD *Entry = &LCD_1IN69_InitTable[i];
+        LCD_1IN69_WriteCmd(Entry->Cmd, Entry->Params, Entry->Len);
+        if (Entry->Delay_ms) {
+            DEV_Delay_ms(Entry->Delay_ms);
+        }
+    }
 }
 
 /********************************************************************************
@@ -171,13 +121,14 @@ static void LCD_1IN69_SetAttributes(UBYTE Scan_dir)
 {
     // Get the screen scan direction
     LCD_1IN69.SCAN_DIR = Scan_dir;
+    LCD_1IN69_InvalidateWindow();
     UBYTE MemoryAccessReg = 0x00;
 
     // Get GRAM and LCD width and height
     if (Scan_dir == HORIZONTAL) {
         LCD_1IN69.HEIGHT = LCD_1IN69_WIDTH;
         LCD_1IN69.WIDTH = LCD_1IN69_HEIGHT;
-        MemoryAccessReg = 0X78;
+        MemoryAccessReg = 0X70;
     }
     else {
         LCD_1IN69.HEIGHT = LCD_1IN69_HEIGHT;
@@ -186,8 +137,7 @@ static void LCD_1IN69_SetAttributes(UBYTE Scan_dir)
     }
 
     // Set the read / write scan direction of the frame memory
-    LCD_1IN69_SendCommand(0x36); // MX, MY, RGB mode
-    LCD_1IN69_SendData_8Bit(MemoryAccessReg); // 0x08 set RGB
+    LCD_1IN69_WriteCmd(0x36, &MemoryAccessReg, 1); // MX, MY, MV, RGB order like the vertical 0x00
 }
 
 /********************************************************************************
@@ -202,8 +152,9 @@ void LCD_1IN69_Init(UBYTE Scan_dir)
     // Set the resolution and scanning method of the screen
     LCD_1IN69_SetAttributes(Scan_dir);
 
-    // Set the initialization register
+    // Set the initialization register, the table programs RGB565
     LCD_1IN69_InitReg();
+    LCD_1IN69.COLOR_MODE = LCD_1IN69_COLOR_RGB565;
     LCD_1IN69_Clear(0x0000);
 }
 
@@ -249,62 +200,414 @@ parameter:
 //     }
 //     LCD_1IN69_SendCommand(0x2C);   
 // }
+/********************************************************************************
+function:   Forget the cached window, the next SetWindows sends CASET and RASET
+parameter:
+Info    :   Needed whenever the panel may have lost its window (reset, MADCTL)
+********************************************************************************/
+void LCD_1IN69_InvalidateWindow(void)
+{
+    LCD_1IN69.WIN_VALID = 0;
+}
+
+static void LCD_1IN69_SetAddress(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend)
+{
+    UBYTE Params[4];
+    UBYTE Valid;
+
+    // The 240x280 glass sits 20 lines into the 240x320 GRAM
+    if (LCD_1IN69.SCAN_DIR == VERTICAL) {
+        Ystart += 20;
+        Yend += 20;
+    }
+    else {
+        Xstart += 20;
+        Xend += 20;
+    }
+
+    // Only the axis that changed since the last window is sent again
+    Valid = LCD_1IN69.WIN_VALID && LCD_1IN69.WIN_SCAN_DIR == LCD_1IN69.SCAN_DIR;
+
+    // set the X coordinates
+    if (!Valid || LCD_1IN69.WIN_XSTART != Xstart || LCD_1IN69.WIN_XEND != Xend) {
+        Params[0] = Xstart >> 8;
+        Params[1] = Xstart & 0xFF;
+        Params[2] = Xend >> 8;
+        Params[3] = Xend & 0xFF;
+        LCD_1IN69_WriteCmd(0x2A, Params, 4);
+        LCD_1IN69.WIN_XSTART = Xstart;
+        LCD_1IN69.WIN_XEND = Xend;
+    }
+
+    // set the Y coordinates
+    if (!Valid || LCD_1IN69.WIN_YSTART != Ystart || LCD_1IN69.WIN_YEND != Yend) {
+        Params[0] = Ystart >> 8;
+        Params[1] = Ystart & 0xFF;
+        Params[2] = Yend >> 8;
+        Params[3] = Yend & 0xFF;
+        LCD_1IN69_WriteCmd(0x2B, Params, 4);
+        LCD_1IN69.WIN_YSTART = Ystart;
+        LCD_1IN69.WIN_YEND = Yend;
+    }
+
+    LCD_1IN69.WIN_SCAN_DIR = LCD_1IN69.SCAN_DIR;
+    LCD_1IN69.WIN_VALID = 1;
+}
+
 void LCD_1IN69_SetWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend)
-{    
-    if (LCD_1IN69.SCAN_DIR == VERTICAL) { 
-        // set the X coordinates
-        LCD_1IN69_SendCommand(0x2A);
-        LCD_1IN69_SendData_8Bit(Xstart >> 8);
-        LCD_1IN69_SendData_8Bit(Xstart & 0xFF);
-        LCD_1IN69_SendData_8Bit(Xend >> 8);
-        LCD_1IN69_SendData_8Bit(Xend & 0xFF);
-
-        // set the Y coordinates
-        LCD_1IN69_SendCommand(0x2B);
-        LCD_1IN69_SendData_8Bit((Ystart + 20) >> 8);
-        LCD_1IN69_SendData_8Bit((Ystart + 20) & 0xFF);
-        LCD_1IN69_SendData_8Bit((Yend + 20) >> 8);
-        LCD_1IN69_SendData_8Bit((Yend + 20) & 0xFF);
+{
+    // RAMWR is always sent, it restarts writing at the window origin
+    LCD_1IN69_SetAddress(Xstart, Ystart, Xend, Yend);
+    LCD_1IN69_WriteCmd(0x2C, NULL, 0);
+}
+
+/******************************************************************************
+function :  Select the interface pixel format
+parameter:
+    Mode : LCD_1IN69_COLOR_RGB565 or LCD_1IN69_COLOR_RGB444
+Info     :  Image buffers stay RGB565, in RGB444 mode they are packed while
+            being sent, which cuts the SPI bytes per pixel from 2 to 1.5
+******************************************************************************/
+void LCD_1IN69_SetColorMode(UBYTE Mode)
+{
+    LCD_1IN69_WriteCmd(0x3A, &Mode, 1);
+    LCD_1IN69.COLOR_MODE = Mode;
+}
+
+/******************************************************************************
+function :  Pack one pixel pair into 3 RGB444 bytes
+parameter:
+    Pair : Two RGB565 pixels in panel byte order, as a little-endian word
+******************************************************************************/
+static inline void LCD_1IN69_PackPair(uint32_t Pair, UBYTE *Out)
+{
+    uint32_t a0 = Pair & 0xFF, a1 = (Pair >> 8) & 0xFF;
+    uint32_t b0 = (Pair >> 16) & 0xFF, b1 = Pair >> 24;
+
+    // RRRRGGGG BBBBRRRR GGGGBBBB, top bits of every channel
+    Out[0] = (a0 & 0xF0) | ((a0 & 0x07) << 1) | (a1 >> 7);
+    Out[1] = ((a1 << 3) & 0xF0) | (b0 >> 4);
+    Out[2] = ((b0 & 0x07) << 5) | ((b1 >> 3) & 0x10) | ((b1 >> 1) & 0x0F);
+}
+
+/******************************************************************************
+function :  Convert RGB565 pixels to the 12-bit interface format
+parameter:
+    Src    : Pixels in panel byte order (as LVGL renders with LV_COLOR_16_SWAP)
+    Dst    : Output, needs (Pixels * 3 + 1) / 2 bytes
+    Pixels : Number of pixels
+return   :  Number of bytes written, an odd last pixel is padded to 2 bytes
+******************************************************************************/
+UDOUBLE LCD_1IN69_PackRGB444(const UWORD *Src, UBYTE *Dst, UDOUBLE Pixels)
+{
+    UBYTE *Out = Dst;
+    UDOUBLE Pairs = Pixels / 2;
+
+    if (((uintptr_t)Src & 3) == 0) {
+        // One word load per pixel pair
+        const uint32_t *Src32 = (const uint32_t *)Src;
+        while (Pairs--) {
+            LCD_1IN69_PackPair(*Src32++, Out);
+            Out += 3;
+        }
+        Src = (const UWORD *)Src32;
+    } else {
+        while (Pairs--) {
+            LCD_1IN69_PackPair((uint32_t)Src[0] | ((uint32_t)Src[1] << 16), Out);
+            Src += 2;
+            Out += 3;
+        }
     }
-    else { 
-        // set the X coordinates
-        LCD_1IN69_SendCommand(0x2A);
-        LCD_1IN69_SendData_8Bit((Xstart + 20) >> 8);
-        LCD_1IN69_SendData_8Bit((Xstart + 20) & 0xFF);
-        LCD_1IN69_SendData_8Bit((Xend + 20) >> 8);
-        LCD_1IN69_SendData_8Bit((Xend + 20) & 0xFF);
-
-        // set the Y coordinates
-        LCD_1IN69_SendCommand(0x2B);
-        LCD_1IN69_SendData_8Bit(Ystart >> 8);
-        LCD_1IN69_SendData_8Bit(Ystart & 0xFF);
-        LCD_1IN69_SendData_8Bit(Yend >> 8);
-        LCD_1IN69_SendData_8Bit(Yend & 0xFF);
+
+    if (Pixels & 1) {
+        UBYTE Tail[3];
+        LCD_1IN69_PackPair(Src[0], Tail);
+        *Out++ = Tail[0];
+        *Out++ = Tail[1];
     }
-    LCD_1IN69_SendCommand(0x2C);   
+    return Out - Dst;
 }
 
 /******************************************************************************
-function :  Clear screen
+function :  Releases CS after a DMA transfer, runs in the DMA IRQ
 parameter:
 ******************************************************************************/
-void LCD_1IN69_Clear(UWORD Color)
+static void LCD_1IN69_DMA_Done(void)
 {
-    UWORD j;
-    UWORD Image[LCD_1IN69_WIDTH];
-    for (j=0; j<LCD_1IN69_WIDTH; j++) {
-        Image[j] = Color;
+    DEV_Digital_Write(LCD_CS_PIN, 1);
+
+    DEV_DMA_Callback Done = LCD_1IN69_TransferDone;
+    LCD_1IN69_TransferDone = NULL;
+    if (Done) {
+        Done();
+    }
+}
+
+/******************************************************************************
+function :  Pack rows into the staging halves and send them (RGB444 mode)
+Info     :  A row with an odd width leaves one pixel over, it is paired with
+            the first pixel of the next row so the 12-bit stream stays aligned
+******************************************************************************/
+static void LCD_1IN69_WritePacked(const UWORD *Image, UDOUBLE Width, UWORD Rows, UDOUBLE Stride, DEV_DMA_Callback Done)
+{
+    UBYTE *Buf = LCD_1IN69_PackBuf[LCD_1IN69_PackHalf];
+    UDOUBLE Len = 0, Packed = 0, Chunk, Left;
+    const UWORD *Src;
+    UWORD Carry = 0;
+    UBYTE HasCarry = 0;
+
+    while (Rows--) {
+        Src = Image;
+        Left = Width;
+        Image += Stride;
+
+        while (Left > 0) {
+            if (HasCarry) {
+                LCD_1IN69_PackPair((uint32_t)Carry | ((uint32_t)*Src++ << 16), Buf + Len);
+                Len += 3;
+                Packed += 2;
+                Left--;
+                HasCarry = 0;
+            } else if (Left == 1) {
+                Carry = *Src++;
+                Left = 0;
+                HasCarry = 1;
+            } else {
+                Chunk = LCD_1IN69_PACK_PIXELS - Packed;
+                Chunk = (Chunk < Left ? Chunk : Left) & ~1u;
+                Len += LCD_1IN69_PackRGB444(Src, Buf + Len, Chunk);
+                Src += Chunk;
+                Left -= Chunk;
+                Packed += Chunk;
+            }
+
+            // Staging half full, send it and pack into the other one meanwhile
+            if (Packed == LCD_1IN69_PACK_PIXELS) {
+                DEV_SPI_Write_nByte_DMA(Buf, Len, NULL);
+                LCD_1IN69_PackHalf ^= 1;
+                Buf = LCD_1IN69_PackBuf[LCD_1IN69_PackHalf];
+                Len = 0;
+                Packed = 0;
+            }
+        }
     }
 
-    LCD_1IN69_SetWindows(0, 0, LCD_1IN69.WIDTH, LCD_1IN69.HEIGHT);
+    if (HasCarry) {
+        Len += LCD_1IN69_PackRGB444(&Carry, Buf + Len, 1);
+    }
+    DEV_SPI_Write_nByte_DMA(Buf, Len, Done);
+    LCD_1IN69_PackHalf ^= 1;
+}
+
+// Row chain state of a strided RGB565 transfer
+static const UWORD *LCD_1IN69_RowNext;
+static UDOUBLE LCD_1IN69_RowStride;
+static UDOUBLE LCD_1IN69_RowBytes;
+static volatile UWORD LCD_1IN69_RowsLeft;
+static volatile DEV_DMA_Callback LCD_1IN69_RowsDone = NULL;
+
+/******************************************************************************
+function :  Starts the next row of a strided transfer, runs in the DMA IRQ
+parameter:
+******************************************************************************/
+static void LCD_1IN69_NextRow(void)
+{
+    const UWORD *Row = LCD_1IN69_RowNext;
+
+    if (LCD_1IN69_RowsLeft == 0) {
+        DEV_DMA_Callback Done = LCD_1IN69_RowsDone;
+        LCD_1IN69_RowsDone = NULL;
+        if (Done) {
+            Done();
+        }
+        return;
+    }
+
+    LCD_1IN69_RowNext += LCD_1IN69_RowStride;
+    LCD_1IN69_RowsLeft--;
+    DEV_SPI_Write_nByte_DMA((const uint8_t *)Row, LCD_1IN69_RowBytes, LCD_1IN69_NextRow);
+}
+
+/******************************************************************************
+function :  Send rows of pixels inside an open RAMWR transaction (CS low, DC high)
+parameter:
+    Image  : First pixel of the first row, panel byte order
+    Width  : Pixels per row
+    Rows   : Number of rows
+    Stride : Distance between rows in pixels
+    Done   : Called when the last pixel is on the wire, may be NULL
+Info     :  Returns while the last part may still be in flight
+******************************************************************************/
+static void LCD_1IN69_WriteRows(const UWORD *Image, UDOUBLE Width, UWORD Rows, UDOUBLE Stride, DEV_DMA_Callback Done)
+{
+    if (LCD_1IN69.COLOR_MODE == LCD_1IN69_COLOR_RGB444) {
+        LCD_1IN69_WritePacked(Image, Width, Rows, Stride, Done);
+        return;
+    }
+
+    // Contiguous rows go out as one transfer
+    if (Rows <= 1 || Width == Stride) {
+        DEV_SPI_Write_nByte_DMA((const uint8_t *)Image, Width * Rows * 2, Done);
+        return;
+    }
+
+    DEV_SPI_DMA_Wait();
+    LCD_1IN69_RowNext = Image;
+    LCD_1IN69_RowStride = Stride;
+    LCD_1IN69_RowBytes = Width * 2;
+    LCD_1IN69_RowsLeft = Rows;
+    LCD_1IN69_RowsDone = Done;
+    LCD_1IN69_NextRow();
+}
+
+/******************************************************************************
+function :  Send one color repeatedly inside an open RAMWR transaction
+parameter:
+    Color  : RGB565 value
+    Pixels : Number of pixels
+Info     :  RGB565 goes out as a single non-incrementing DMA transfer, RGB444
+            repeats one packed chunk of the 3-byte pixel pair pattern
+******************************************************************************/
+static void LCD_1IN69_FillPixels(UWORD Color, UDOUBLE Pixels, DEV_DMA_Callback Done)
+{
+    UBYTE *Buf;
+    UDOUBLE i, Chunk;
+
+    if (LCD_1IN69.COLOR_MODE != LCD_1IN69_COLOR_RGB444) {
+        DEV_SPI_Fill16_DMA(Color, Pixels, Done);
+        return;
+    }
+
+    // The staging half may still be on the wire
+    DEV_SPI_DMA_Wait();
+    Buf = LCD_1IN69_PackBuf[LCD_1IN69_PackHalf];
+    LCD_1IN69_PackHalf ^= 1;
+
+    Chunk = Pixels < LCD_1IN69_PACK_PIXELS ? Pixels : LCD_1IN69_PACK_PIXELS;
+    Buf[0] = ((Color >> 8) & 0xF0) | ((Color >> 7) & 0x0F);
+    Buf[1] = ((Color << 3) & 0xF0) | (Color >> 12);
+    Buf[2] = ((Color >> 3) & 0xF0) | ((Color >> 1) & 0x0F);
+    for (i = 3; i < (Chunk * 3 + 1) / 2; i++) {
+        Buf[i] = Buf[i - 3];
+    }
+
+    while (Pixels > 0) {
+        Chunk = Pixels < LCD_1IN69_PACK_PIXELS ? Pixels : LCD_1IN69_PACK_PIXELS;
+        Pixels -= Chunk;
+        DEV_SPI_Write_nByte_DMA(Buf, (Chunk * 3 + 1) / 2, Pixels > 0 ? NULL : Done);
+    }
+}
+
+/******************************************************************************
+function :  Clip a window (inclusive, any corner order) to the current scan direction
+return   :  0 when nothing of the window is on screen
+******************************************************************************/
+static UBYTE LCD_1IN69_ClipWindow(UWORD *Xstart, UWORD *Ystart, UWORD *Xend, UWORD *Yend)
+{
+    UWORD data;
+    if (*Xstart > *Xend) {
+        data = *Xstart;
+        *Xstart = *Xend;
+        *Xend = data;
+    }
+    if (*Ystart > *Yend) {
+        data = *Ystart;
+        *Ystart = *Yend;
+        *Yend = data;
+    }
+
+    if (*Xstart >= LCD_1IN69.WIDTH || *Ystart >= LCD_1IN69.HEIGHT) {
+        return 0;
+    }
+    if (*Xend >= LCD_1IN69.WIDTH) {
+        *Xend = LCD_1IN69.WIDTH - 1;
+    }
+    if (*Yend >= LCD_1IN69.HEIGHT) {
+        *Yend = LCD_1IN69.HEIGHT - 1;
+    }
+    return 1;
+}
+
+/******************************************************************************
+function :  Check if all pixels of a buffer have one color
+parameter:
+    Image  : Pixels, 4-byte aligned, compared two at a time
+    Pixels : Number of pixels, at least 1
+return   :  1 when the buffer can be sent with FillRect instead
+******************************************************************************/
+UBYTE LCD_1IN69_IsSolid(const UWORD *Image, UDOUBLE Pixels)
+{
+    const uint32_t *Words = (const uint32_t *)Image;
+    const uint32_t Pattern = Image[0] | ((uint32_t)Image[0] << 16);
+    UDOUBLE i;
+
+    for (i = 0; i < Pixels / 2; i++) {
+        if (Words[i] != Pattern) {
+            return 0;
+        }
+    }
+    return (Pixels & 1) == 0 || Image[Pixels - 1] == Image[0];
+}
+
+/******************************************************************************
+function :  Fill a rectangle (inclusive, any corner order) with one color
+parameter:
+    Color : RGB565 value
+Info     :  No source buffer, the color is streamed straight to the panel;
+            the rectangle is clipped to the screen like DisplayWindows
+******************************************************************************/
+void LCD_1IN69_FillRect(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color)
+{
+    UDOUBLE Pixels;
+
+    if (!LCD_1IN69_ClipWindow(&Xstart, &Ystart, &Xend, &Yend)) {
+        return;
+    }
+    Pixels = (UDOUBLE)(Xend - Xstart + 1) * (Yend - Ystart + 1);
+
+    LCD_1IN69_SetWindows(Xstart, Ystart, Xend, Yend);
     DEV_Digital_Write(LCD_DC_PIN, 1);
     DEV_Digital_Write(LCD_CS_PIN, 0);
-    for (j=0; j<LCD_1IN69.HEIGHT; j++) {
-        DEV_SPI_Write_nByte((uint8_t *)&Image, LCD_1IN69.WIDTH * 2);
-    }
+    LCD_1IN69_FillPixels(Color, Pixels, NULL);
+    DEV_SPI_DMA_Wait();
     DEV_Digital_Write(LCD_CS_PIN, 1);
 }
 
+/******************************************************************************
+function :  Start filling a rectangle over DMA and return at once
+parameter:
+    Color : RGB565 value
+    Done  : Called from the DMA IRQ when the fill is complete, may be NULL
+******************************************************************************/
+void LCD_1IN69_FillRect_DMA(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color, DEV_DMA_Callback Done)
+{
+    UDOUBLE Pixels;
+
+    if (!LCD_1IN69_ClipWindow(&Xstart, &Ystart, &Xend, &Yend)) {
+        if (Done) {
+            Done();
+        }
+        return;
+    }
+    Pixels = (UDOUBLE)(Xend - Xstart + 1) * (Yend - Ystart + 1);
+
+    LCD_1IN69_SetWindows(Xstart, Ystart, Xend, Yend);
+
+    LCD_1IN69_TransferDone = Done;
+    DEV_Digital_Write(LCD_DC_PIN, 1);
+    DEV_Digital_Write(LCD_CS_PIN, 0);
+    LCD_1IN69_FillPixels(Color, Pixels, LCD_1IN69_DMA_Done);
+}
+
+/******************************************************************************
+function :  Clear screen
+parameter:
+******************************************************************************/
+void LCD_1IN69_Clear(UWORD Color)
+{
+    LCD_1IN69_FillRect(0, 0, LCD_1IN69.WIDTH - 1, LCD_1IN69.HEIGHT - 1, Color);
+}
+
 /******************************************************************************
 function :  Sends the image buffer in RAM to displays
 parameter:
@@ -313,54 +616,107 @@ void LCD_1IN69_Display(UWORD *Image)
 {
     UWORD j;
     
-    LCD_1IN69_SetWindows(0, 0, LCD_1IN69.WIDTH, LCD_1IN69.HEIGHT);
+    LCD_1IN69_SetWindows(0, 0, LCD_1IN69.WIDTH - 1, LCD_1IN69.HEIGHT - 1);
     DEV_Digital_Write(LCD_DC_PIN, 1);
     DEV_Digital_Write(LCD_CS_PIN, 0);
     for (j=0; j<LCD_1IN69.HEIGHT; j++) {
-        DEV_SPI_Write_nByte((uint8_t *)&Image[j * LCD_1IN69.WIDTH], LCD_1IN69.WIDTH * 2);
+        LCD_1IN69_WriteRows(&Image[j * LCD_1IN69.WIDTH], LCD_1IN69.WIDTH, 1, 0, NULL);
     }
+    DEV_SPI_DMA_Wait();
+    DEV_Digital_Write(LCD_CS_PIN, 1);
+}
+
+/******************************************************************************
+function :  Sends a rendered area (Xend, Yend inclusive) to the display
+parameter:
+    Image : Pixels of the area, row after row, in panel byte order
+******************************************************************************/
+void LCD_1IN69_DisplayArea(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image)
+{
+    UDOUBLE Pixels = (UDOUBLE)(Xend - Xstart + 1) * (Yend - Ystart + 1);
+
+    LCD_1IN69_SetWindows(Xstart, Ystart, Xend, Yend);
+    DEV_Digital_Write(LCD_DC_PIN, 1);
+    DEV_Digital_Write(LCD_CS_PIN, 0);
+    LCD_1IN69_WriteRows(Image, Pixels, 1, 0, NULL);
+    DEV_SPI_DMA_Wait();
     DEV_Digital_Write(LCD_CS_PIN, 1);
 }
 
-void LCD_1IN69_DisplayWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image)
+/******************************************************************************
+function :  Starts sending a rendered area over DMA and returns at once
+parameter:
+    Image : Pixels of the area, must stay untouched until Done is called
+    Done  : Called from the DMA IRQ when the last pixel is on the wire
+******************************************************************************/
+void LCD_1IN69_DisplayArea_DMA(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image, DEV_DMA_Callback Done)
 {
-    UWORD j,data;
-    UDOUBLE Addr = 0;
-    if(Xstart > Xend) 
-	{
-		data = Xstart;
-		Xstart = Xend;
-		Xend = data;
-	}
-	if (Ystart > Yend)
-	{
-		data = Ystart;
-		Ystart = Yend;
-		Yend = data;
-	}
-
-    Xstart -= 10;Xend += 10;
-    Ystart -= 10;Yend += 10;
-
-	Xstart = (Xstart < 240)? Xstart : 0;
-	Ystart = (Ystart < 280)? Ystart : 0;
-    Xend = (Xend < 240)? Xend : 240;
-	Yend = (Yend < 280)? Yend : 280;
+    UDOUBLE Pixels = (UDOUBLE)(Xend - Xstart + 1) * (Yend - Ystart + 1);
 
+    // Waits for the previous transfer before touching DC / CS
     LCD_1IN69_SetWindows(Xstart, Ystart, Xend, Yend);
+
+    LCD_1IN69_TransferDone = Done;
     DEV_Digital_Write(LCD_DC_PIN, 1);
     DEV_Digital_Write(LCD_CS_PIN, 0);
-    for (j=Ystart; j<Yend; j++) {
-        Addr = Xstart + j * LCD_1IN69.WIDTH;
-        DEV_SPI_Write_nByte((uint8_t *)&Image[Addr], (Xend-Xstart) * 2);
+    LCD_1IN69_WriteRows(Image, Pixels, 1, 0, LCD_1IN69_DMA_Done);
+}
+
+/******************************************************************************
+function :  Sends a sub-rectangle of a RAM framebuffer to the same place on screen
+parameter:
+    Xstart, Ystart, Xend, Yend : Rectangle, inclusive, clipped to the screen
+    Image  : Pixel (0, 0) of the framebuffer, panel byte order
+    Stride : Framebuffer line length in pixels
+******************************************************************************/
+void LCD_1IN69_DisplayWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, const UWORD *Image, UWORD Stride)
+{
+    if (!LCD_1IN69_ClipWindow(&Xstart, &Ystart, &Xend, &Yend)) {
+        return;
     }
+
+    LCD_1IN69_SetWindows(Xstart, Ystart, Xend, Yend);
+    DEV_Digital_Write(LCD_DC_PIN, 1);
+    DEV_Digital_Write(LCD_CS_PIN, 0);
+    LCD_1IN69_WriteRows(&Image[(UDOUBLE)Ystart * Stride + Xstart], Xend - Xstart + 1, Yend - Ystart + 1, Stride, NULL);
+    DEV_SPI_DMA_Wait();
     DEV_Digital_Write(LCD_CS_PIN, 1);
 }
 
+/******************************************************************************
+function :  Starts sending a framebuffer sub-rectangle over DMA, returns at once
+parameter:
+    Done : Called from the DMA IRQ when the last row is on the wire
+Info     :  In RGB565 mode every row re-arms the DMA from its completion IRQ
+******************************************************************************/
+void LCD_1IN69_DisplayWindows_DMA(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, const UWORD *Image, UWORD Stride, DEV_DMA_Callback Done)
+{
+    if (!LCD_1IN69_ClipWindow(&Xstart, &Ystart, &Xend, &Yend)) {
+        if (Done) {
+            Done();
+        }
+        return;
+    }
+
+    LCD_1IN69_SetWindows(Xstart, Ystart, Xend, Yend);
+
+    LCD_1IN69_TransferDone = Done;
+    DEV_Digital_Write(LCD_DC_PIN, 1);
+    DEV_Digital_Write(LCD_CS_PIN, 0);
+    LCD_1IN69_WriteRows(&Image[(UDOUBLE)Ystart * Stride + Xstart], Xend - Xstart + 1, Yend - Ystart + 1, Stride, LCD_1IN69_DMA_Done);
+}
+
 void LCD_1IN69_DrawPoint(UWORD X, UWORD Y, UWORD Color)
 {
-    LCD_1IN69_SetWindows(X, Y, X, Y);
-    LCD_1IN69_SendData_16Bit(Color);
+    UBYTE Pixel[2] = {(Color >> 8) & 0xFF, Color & 0xFF};
+
+    if (LCD_1IN69.COLOR_MODE == LCD_1IN69_COLOR_RGB444) {
+        Pixel[0] = ((Color >> 8) & 0xF0) | ((Color >> 7) & 0x0F);
+        Pixel[1] = (Color << 3) & 0xF0;
+    }
+
+    LCD_1IN69_SetAddress(X, Y, X, Y);
+    LCD_1IN69_WriteCmd(0x2C, Pixel, 2);
 }
 
 void Handler_1IN69_LCD(int signo)
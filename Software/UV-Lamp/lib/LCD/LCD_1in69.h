@@ -24,10 +24,22 @@
 #define HORIZONTAL 0
 #define VERTICAL   1
 
+// Interface pixel formats (COLMOD)
+#define LCD_1IN69_COLOR_RGB444 0x03
+#define LCD_1IN69_COLOR_RGB565 0x05
+
 typedef struct{
     UWORD WIDTH;
     UWORD HEIGHT;
     UBYTE SCAN_DIR;
+    UBYTE COLOR_MODE;
+    // Last window programmed into the panel (GRAM coordinates)
+    UWORD WIN_XSTART;
+    UWORD WIN_XEND;
+    UWORD WIN_YSTART;
+    UWORD WIN_YEND;
+    UBYTE WIN_SCAN_DIR;
+    UBYTE WIN_VALID;
 }LCD_1IN69_ATTRIBUTES;
 extern LCD_1IN69_ATTRIBUTES LCD_1IN69;
 
@@ -35,10 +47,20 @@ extern LCD_1IN69_ATTRIBUTES LCD_1IN69;
 function:   Macro definition variable name
 ********************************************************************************/
 void LCD_1IN69_Init(UBYTE Scan_dir);
+void LCD_1IN69_WriteCmd(UBYTE Cmd, const UBYTE *Params, UWORD Len);
+void LCD_1IN69_SetColorMode(UBYTE Mode);
+UDOUBLE LCD_1IN69_PackRGB444(const UWORD *Src, UBYTE *Dst, UDOUBLE Pixels);
 void LCD_1IN69_Clear(UWORD Color);
 void LCD_1IN69_Display(UWORD *Image);
-void LCD_1IN69_DisplayWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image);
+void LCD_1IN69_DisplayArea(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image);
+void LCD_1IN69_DisplayArea_DMA(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image, DEV_DMA_Callback Done);
+UBYTE LCD_1IN69_IsSolid(const UWORD *Image, UDOUBLE Pixels);
+void LCD_1IN69_FillRect(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color);
+void LCD_1IN69_FillRect_DMA(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color, DEV_DMA_Callback Done);
+void LCD_1IN69_DisplayWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, const UWORD *Image, UWORD Stride);
+void LCD_1IN69_DisplayWindows_DMA(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, const UWORD *Image, UWORD Stride, DEV_DMA_Callback Done);
 void LCD_1IN69_DrawPoint(UWORD X, UWORD Y, UWORD Color);
 void LCD_1IN69_SetWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend);
+void LCD_1IN69_InvalidateWindow(void);
 void Handler_1IN69_LCD(int signo);
 #endif
@@ -25,7 +25,12 @@
  *====================*/
 #define LV_DISP_DEF_REFR_PERIOD 30
 #define LV_INDEV_DEF_READ_PERIOD 30
-#define LV_TICK_CUSTOM 0
+#define LV_TICK_CUSTOM 1
+#if LV_TICK_CUSTOM
+    /*Free-running 64-bit microsecond timer, no tick interrupt needed*/
+    #define LV_TICK_CUSTOM_INCLUDE "hardware/timer.h"
+    #define LV_TICK_CUSTOM_SYS_TIME_EXPR ((uint32_t)(time_us_64() / 1000))
+#endif
 #define LV_DPI_DEF 130
 
 /*=================
@@ -8,12 +8,18 @@
 #include "hardware/flash.h"
 #include "hardware/sync.h"
 #include "hardware/pwm.h" 
+#include "pico/multicore.h"
+#include "src/spsc_queue.h"
+#include "src/input_events.h"
 
 // ========================================
 // KONFIGURACJA
 // ========================================
-#define TARGET_FPS 30
-#define FRAME_TIME_MS (1000 / TARGET_FPS)
+// Transfer do wyświetlacza w 12 bitach (RGB444) - 25% mniej bajtów po SPI
+#define LCD_RGB444_TRANSFER 0
+
+// Podział na rdzenie: rdzeń 1 - LVGL i wyświetlacz, rdzeń 0 - timer, PWM, przyciski i flash
+#define UV_LAMP_MULTICORE 1
 
 // GPIO PINY
 #define ENC_A_PIN 10
@@ -45,13 +51,19 @@ typedef struct {
 #define LONG_PRESS_TIME_MS 1000
 
 // Konfiguracja timera
-#define ARC_UPDATE_INTERVAL_MS 100  // Aktualizacja arcu co 100ms dla płynności
+#define ARC_UPDATE_INTERVAL_MS 100  // Aktualizacja odliczania na ekranie co 100ms dla płynności
 
 // ========================================
 // BUFORY DLA LVGL
 // ========================================
+// Dwa bufory: LVGL renderuje do jednego, gdy drugi jest wysyłany przez DMA
+#define LVGL_BUF_LINES 40
+#define LVGL_BUF_SIZE (LCD_1IN69_WIDTH * LVGL_BUF_LINES)
+
 static lv_disp_draw_buf_t draw_buf;
-static lv_color_t buf1[LCD_1IN69_WIDTH * 70];
+static lv_color_t buf1[LVGL_BUF_SIZE] __attribute__((aligned(4)));
+static lv_color_t buf2[LVGL_BUF_SIZE] __attribute__((aligned(4)));
+static lv_disp_drv_t *flushing_disp = NULL;
 
 // ========================================
 // ZMIENNE GLOBALNE
@@ -60,17 +72,14 @@ static uint8_t current_screen = 0;
 static uint8_t configured_timer_value = 0;
 static uint8_t configured_power_value = 0;
 
-// Zmienne dla enkodera
-static volatile int8_t encoder_delta = 0;
-static volatile uint8_t encoder_last_state = 0;
+// Zdarzenia GPIO z czasem: przerwanie -> główna pętla, jeden producent i jeden konsument
+#define INPUT_RING_CAPACITY 256
+static input_event_t input_ring_slots[INPUT_RING_CAPACITY];
+static spsc_queue_t input_ring;
+static volatile uint32_t input_events_dropped = 0;
 
-// Zmienne dla przycisków
-static volatile bool butt1_pressed = false;
-static volatile bool butt2_pressed = false;
-static volatile uint64_t butt1_press_time = 0;
-static volatile uint64_t butt2_press_time = 0;
-static volatile bool butt1_handled = false;
-static volatile bool butt2_handled = false;
+// Dekoder enkodera i przycisków (debounce, long press) w głównej pętli
+static input_decoder_t input_decoder;
 
 // Tryb edycji
 static bool edit_mode = false;
@@ -79,9 +88,50 @@ static bool edit_mode = false;
 // ZMIENNE DLA TIMERA
 // ========================================
 static bool timer_running = false;
-static uint32_t timer_remaining_ms = 0;  // Pozostały czas w milisekundach
-static uint64_t last_timer_update = 0;   // Ostatnia aktualizacja timera (ms)
-static uint64_t last_arc_update = 0;     // Ostatnia aktualizacja arcu (ms)
+static uint64_t timer_remaining_us = 0;  // Pozostały czas w mikrosekundach (gdy timer stoi)
+static uint64_t exposure_end_us = 0;     // Koniec naświetlania wg time_us_64() (gdy timer pracuje)
+static alarm_id_t exposure_alarm = 0;    // Alarm sprzętowy wyłączający PWM w exposure_end_us
+static volatile bool exposure_done = false;  // Alarm wyłączył PWM, reset timera w głównej pętli
+
+// ========================================
+// STAN I KOMENDY DLA UI
+// ========================================
+// Kopia stanu lampy, z której UI rysuje ekrany - UI nie czyta zmiennych sterowania
+typedef struct {
+    uint32_t timer_remaining_ms;  // podczas naświetlania liczony przez UI z exposure_end_us
+    uint64_t exposure_end_us;     // koniec naświetlania, 0 gdy timer stoi
+    uint8_t timer_value;
+    uint8_t power_value;
+    uint8_t screen;
+    bool edit_mode;
+} lamp_state_t;
+
+typedef enum {
+    UI_MSG_STATE,           // nowy stan lampy
+    UI_MSG_LOAD_SCREEN      // przejście na ekran (z animacją)
+} ui_msg_kind_t;
+
+typedef struct {
+    uint8_t kind;
+    uint8_t screen;
+    lamp_state_t state;
+} ui_msg_t;
+
+// Rdzeń 0 -> rdzeń 1, jeden producent i jeden konsument
+#define UI_QUEUE_CAPACITY 16
+
+#if UV_LAMP_MULTICORE
+static ui_msg_t ui_queue_slots[UI_QUEUE_CAPACITY];
+static spsc_queue_t ui_queue;
+#endif
+
+// Po stronie sterowania: co jeszcze trzeba wysłać do UI
+static bool ui_state_dirty = true;
+static int8_t pending_screen = -1;
+
+// Po stronie UI: stan ostatnio pokazany na ekranie
+static lamp_state_t ui_shown;
+static bool ui_shown_valid = false;
 
 // ZMIENNE DLA PWM
 static uint pwm_slice_ch1;
@@ -206,6 +256,11 @@ void save_config_to_flash(void)
     memset(buffer, 0xFF, FLASH_PAGE_SIZE);  // Wypełnij 0xFF (stan skasowanej pamięci)
     memcpy(buffer, &config, sizeof(flash_config_t));
     
+#if UV_LAMP_MULTICORE
+    // Rdzeń 1 nie może wykonywać kodu z flash podczas kasowania i zapisu
+    multicore_lockout_start_blocking();
+#endif
+    
     // Wyłącz przerwania podczas operacji flash
     uint32_t ints = save_and_disable_interrupts();
     
@@ -217,25 +272,18 @@ void save_config_to_flash(void)
     
     // Przywróć przerwania
     restore_interrupts(ints);
+    
+#if UV_LAMP_MULTICORE
+    multicore_lockout_end_blocking();
+#endif
 }
 
 // ========================================
-// FUNKCJA WYŚWIETLANIA OBSZARU LCD
+// KONIEC TRANSFERU DMA (WYWOŁYWANE Z PRZERWANIA)
 // ========================================
-void LCD_1IN69_DisplayArea(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image)
+static void my_disp_flush_done(void)
 {
-    UWORD width = Xend - Xstart + 1;
-    UWORD height = Yend - Ystart + 1;
-    UWORD total_pixels = width * height;
-    
-    LCD_1IN69_SetWindows(Xstart, Ystart, Xend, Yend);
-    
-    DEV_Digital_Write(LCD_DC_PIN, 1);
-    DEV_Digital_Write(LCD_CS_PIN, 0);
-    
-    DEV_SPI_Write_nByte((uint8_t *)Image, total_pixels * 2);
-    
-    DEV_Digital_Write(LCD_CS_PIN, 1);
+    lv_disp_flush_ready(flushing_disp);
 }
 
 // ========================================
@@ -243,93 +291,97 @@ void LCD_1IN69_DisplayArea(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, U
 // ========================================
 void my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p)
 {
-    LCD_1IN69_DisplayArea(area->x1, area->y1, area->x2, area->y2, (UWORD *)color_p);
-    lv_disp_flush_ready(disp);
-}
-
-// ========================================
-// TIMER CALLBACK DLA LVGL TICK
-// ========================================
-bool lvgl_timer_callback(struct repeating_timer *t)
-{
-    lv_tick_inc(1);
-    return true;
+    // Jednolite tło (np. ekrany 0xFFEDFF) - wypełnienie bez czytania bufora przez DMA,
+    // więc bufor można od razu oddać do LVGL
+    // Bufory są wyrównane do 4 bajtów, LCD_1IN69_IsSolid porównuje po dwa piksele naraz
+    if (LCD_1IN69_IsSolid((const UWORD *)color_p, lv_area_get_size(area))) {
+        uint16_t raw = color_p[0].full;
+        uint16_t color = (raw >> 8) | (raw << 8);  // LV_COLOR_16_SWAP
+        LCD_1IN69_FillRect_DMA(area->x1, area->y1, area->x2, area->y2, color, NULL);
+        lv_disp_flush_ready(disp);
+        return;
+    }
+    
+    // Start transferu i natychmiastowy powrót - lv_disp_flush_ready wywoła przerwanie DMA
+    flushing_disp = disp;
+    LCD_1IN69_DisplayArea_DMA(area->x1, area->y1, area->x2, area->y2, (UWORD *)color_p, my_disp_flush_done);
 }
 
 // ========================================
 // ZARZĄDZANIE WIDOCZNOŚCIĄ ARKÓW
 // ========================================
-void update_arc_visibility(void)
+void update_arc_visibility(const lamp_state_t *state)
 {
-    if (edit_mode) {
+    if (state->edit_mode) {
         // Pokaż arki w trybie edycji
-        if (current_screen == 1) {
+        if (state->screen == 1) {
             lv_obj_clear_flag(ui_ArcPowerValue, LV_OBJ_FLAG_HIDDEN);
-        } else if (current_screen == 2) {
+        } else if (state->screen == 2) {
             lv_obj_clear_flag(ui_ArcTimeValue, LV_OBJ_FLAG_HIDDEN);
         }
     } else {
         // Ukryj arki poza trybem edycji
         lv_obj_add_flag(ui_ArcPowerValue, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(ui_ArcTimeValue, LV_OBJ_FLAG_HIDDEN);
-        
-        // Zapisz konfigurację do flash przy wyjściu z trybu edycji
-        save_config_to_flash(); 
     }
 }
 
 // ========================================
 // AKTUALIZACJA WYŚWIETLACZA TIMERA
 // ========================================
-void update_timer_display(void)
+void update_timer_display(const lamp_state_t *state)
 {
     char timerText[16];
-    int minutes = configured_timer_value / 60;
-    int seconds = configured_timer_value % 60;
+    int minutes = state->timer_value / 60;
+    int seconds = state->timer_value % 60;
     snprintf(timerText, sizeof(timerText), "%02d:%02d", minutes, seconds);
     lv_label_set_text(ui_LabelConfigTimerValue, timerText);
-    int16_t arc_val = configured_timer_value * 10 / 18;
+    int16_t arc_val = state->timer_value * 10 / 18;
     lv_arc_set_value(ui_ArcTimeValue, arc_val);
 }
 
 // ========================================
 // AKTUALIZACJA WYŚWIETLACZA MOCY
 // ========================================
-void update_power_display(void)
+void update_power_display(const lamp_state_t *state)
 {
     char powerText[4];
-    snprintf(powerText, sizeof(powerText), "%d", configured_power_value);
-    lv_arc_set_value(ui_ArcPowerValue, configured_power_value);
+    snprintf(powerText, sizeof(powerText), "%d", state->power_value);
+    lv_arc_set_value(ui_ArcPowerValue, state->power_value);
     lv_label_set_text(ui_LabelPowerValue, powerText);
 }
 
 // ========================================
 // AKTUALIZACJA ARCU NA EKRANIE GŁÓWNYM
 // ========================================
-void update_main_arc(void)
+int16_t main_arc_percent(const lamp_state_t *state)
 {
-    if (configured_timer_value > 0) {
-        // Oblicz procent wypełnienia arcu na podstawie milisekund
-        uint32_t total_ms = configured_timer_value * 1000;
-        int16_t arc_percent = (timer_remaining_ms * 100) / total_ms;
-        
-        // Ogranicz do zakresu 0-100
-        if (arc_percent > 100) arc_percent = 100;
-        if (arc_percent < 0) arc_percent = 0;
-        
-        lv_arc_set_value(ui_ArcMainTimerValue, arc_percent);
-    } else {
-        lv_arc_set_value(ui_ArcMainTimerValue, 0);
+    if (state->timer_value == 0) {
+        return 0;
     }
+    
+    // Oblicz procent wypełnienia arcu na podstawie milisekund
+    uint32_t total_ms = state->timer_value * 1000;
+    int16_t arc_percent = (state->timer_remaining_ms * 100) / total_ms;
+    
+    // Ogranicz do zakresu 0-100
+    if (arc_percent > 100) arc_percent = 100;
+    if (arc_percent < 0) arc_percent = 0;
+    return arc_percent;
+}
+
+void update_main_arc(const lamp_state_t *state)
+{
+    lv_arc_set_value(ui_ArcMainTimerValue, main_arc_percent(state));
 }
 
 // ========================================
 // AKTUALIZACJA ETYKIETY CZASU NA EKRANIE GŁÓWNYM
 // ========================================
-void update_main_label(void)
+void update_main_label(const lamp_state_t *state)
 {
     char timerText[16];
-    uint32_t seconds = timer_remaining_ms / 1000;
+    uint32_t seconds = state->timer_remaining_ms / 1000;
     int minutes = seconds / 60;
     int secs = seconds % 60;
     snprintf(timerText, sizeof(timerText), "%02d:%02d", minutes, secs);
@@ -337,18 +389,199 @@ void update_main_label(void)
 }
 
 // ========================================
-// AKTUALIZACJA EKRANU GŁÓWNEGO (PEŁNA)
+// AKTUALIZACJA MOCY NA EKRANIE GŁÓWNYM
 // ========================================
-void update_main_display(void)
+void update_main_power(const lamp_state_t *state)
 {
-    // Aktualizacja wartości mocy
     char powerText[8];
-    snprintf(powerText, sizeof(powerText), "%d%%", configured_power_value);
+    snprintf(powerText, sizeof(powerText), "%d%%", state->power_value);
     lv_label_set_text(ui_LabelPowerValueSet, powerText);
+}
+
+// ========================================
+// ZASTOSOWANIE NOWEGO STANU W UI
+// ========================================
+void apply_ui_state(const lamp_state_t *new_state)
+{
+    // Podczas naświetlania pozostały czas liczony z terminu końca, a nie przysyłany co chwilę
+    lamp_state_t current = *new_state;
+    if (current.exposure_end_us != 0) {
+        uint64_t now_us = time_us_64();
+        current.timer_remaining_ms = current.exposure_end_us > now_us ? (current.exposure_end_us - now_us) / 1000 : 0;
+    }
+    const lamp_state_t *state = &current;
+    
+    // Pierwszy stan rysuje wszystko, kolejne tylko to, co się zmieniło -
+    // lv_label_set_text unieważnia obszar nawet przy tym samym tekście
+    const lamp_state_t *shown = ui_shown_valid ? &ui_shown : NULL;
+    
+    if (!shown || state->timer_value != shown->timer_value) {
+        update_timer_display(state);
+    }
+    if (!shown || state->power_value != shown->power_value) {
+        update_power_display(state);
+        update_main_power(state);
+    }
+    if (!shown || state->timer_remaining_ms / 1000 != shown->timer_remaining_ms / 1000) {
+        update_main_label(state);
+    }
+    if (!shown || main_arc_percent(state) != main_arc_percent(shown)) {
+        update_main_arc(state);
+    }
+    if (!shown || state->edit_mode != shown->edit_mode || state->screen != shown->screen) {
+        update_arc_visibility(state);
+    }
     
-    // Aktualizacja wartości timera i arcu
-    update_main_label();
-    update_main_arc();
+    ui_shown = *state;
+    ui_shown_valid = true;
+}
+
+// ========================================
+// ODLICZANIE NA EKRANIE (PO STRONIE UI)
+// ========================================
+// Czas (ms) do następnej zmiany etykiety lub arcu, LV_NO_TIMER_READY gdy timer stoi
+uint32_t ui_countdown_wait_ms(void)
+{
+    if (!ui_shown_valid || ui_shown.exposure_end_us == 0) {
+        return LV_NO_TIMER_READY;
+    }
+    
+    uint64_t now_us = time_us_64();
+    if (now_us >= ui_shown.exposure_end_us) {
+        return LV_NO_TIMER_READY;  // Koniec - reset timera przyjdzie jako nowy stan
+    }
+    
+    // Tuż po przejściu pozostałego czasu przez wielokrotność ARC_UPDATE_INTERVAL_MS
+    // (w tym przez pełną sekundę etykiety)
+    uint64_t left_us = ui_shown.exposure_end_us - now_us;
+    return (left_us % (ARC_UPDATE_INTERVAL_MS * 1000)) / 1000 + 1;
+}
+
+// Odliczanie i LVGL - zwraca czas (ms) do następnej pracy UI
+uint32_t ui_handler(void)
+{
+    if (ui_shown_valid && ui_shown.exposure_end_us != 0) {
+        apply_ui_state(&ui_shown);
+    }
+    
+    // Obsługa LVGL (renderowanie, timery, eventy) - zwraca czas do następnego timera LVGL
+    uint32_t lvgl_wait_ms = lv_timer_handler();
+    uint32_t countdown_wait_ms = ui_countdown_wait_ms();
+    return countdown_wait_ms < lvgl_wait_ms ? countdown_wait_ms : lvgl_wait_ms;
+}
+
+// ========================================
+// ZMIANA EKRANU
+// ========================================
+void load_ui_screen(uint8_t screen)
+{
+    switch(screen) {
+        case 0:
+            lv_scr_load_anim(ui_ScreenMain, 
+                            LV_SCR_LOAD_ANIM_MOVE_LEFT, 
+                            500, 0, false);
+            break;
+        case 1:
+            lv_scr_load_anim(ui_ScreenPowerSetting, 
+                            LV_SCR_LOAD_ANIM_MOVE_LEFT, 
+                            500, 0, false);
+            break;
+        case 2:
+            lv_scr_load_anim(ui_ScreenTimerSetting, 
+                            LV_SCR_LOAD_ANIM_MOVE_LEFT, 
+                            500, 0, false);
+            break;
+    }
+}
+
+// ========================================
+// OBSŁUGA WIADOMOŚCI DLA UI
+// ========================================
+void handle_ui_message(const ui_msg_t *msg)
+{
+    switch(msg->kind) {
+        case UI_MSG_STATE:
+            apply_ui_state(&msg->state);
+            break;
+        case UI_MSG_LOAD_SCREEN:
+            load_ui_screen(msg->screen);
+            break;
+    }
+}
+
+// ========================================
+// WYSYŁKA DO UI (PO STRONIE STEROWANIA)
+// ========================================
+static bool send_to_ui(const ui_msg_t *msg)
+{
+#if UV_LAMP_MULTICORE
+    if (!spsc_queue_push(&ui_queue, msg)) {
+        return false;  // Pełna kolejka - ponowna próba w następnym obiegu pętli
+    }
+    __sev();  // Obudź rdzeń 1 z WFE
+    return true;
+#else
+    handle_ui_message(msg);
+    return true;
+#endif
+}
+
+void publish_ui(void)
+{
+    // Komenda przed stanem - jak dotąd, najpierw zmiana ekranu, potem wartości
+    if (pending_screen >= 0) {
+        ui_msg_t msg = {.kind = UI_MSG_LOAD_SCREEN, .screen = (uint8_t)pending_screen};
+        if (!send_to_ui(&msg)) {
+            return;
+        }
+        pending_screen = -1;
+    }
+    
+    if (ui_state_dirty) {
+        ui_msg_t msg = {.kind = UI_MSG_STATE};
+        msg.state.timer_remaining_ms = timer_remaining_us / 1000;
+        msg.state.exposure_end_us = timer_running ? exposure_end_us : 0;
+        msg.state.timer_value = configured_timer_value;
+        msg.state.power_value = configured_power_value;
+        msg.state.screen = current_screen;
+        msg.state.edit_mode = edit_mode;
+        if (!send_to_ui(&msg)) {
+            return;
+        }
+        ui_state_dirty = false;
+    }
+}
+
+bool ui_publish_pending(void)
+{
+    return pending_screen >= 0 || ui_state_dirty;
+}
+
+// ========================================
+// KONIEC NAŚWIETLANIA (PRZERWANIE ALARMU)
+// ========================================
+static int64_t exposure_alarm_callback(alarm_id_t id, void *user_data)
+{
+    (void)id;
+    (void)user_data;
+    
+    // Oba kanały wyłączone w przerwaniu, dokładnie w terminie -
+    // renderowanie ani uśpiona pętla nie opóźniają końca naświetlania
+    stop_pwm();
+    exposure_done = true;
+    __sev();  // Obudź główną pętlę, która zresetuje timer
+    return 0;  // Jednorazowy
+}
+
+// Odwołanie alarmu razem z PWM; false gdy alarm zdążył już zakończyć naświetlanie
+static bool cancel_exposure(void)
+{
+    cancel_alarm(exposure_alarm);
+    exposure_alarm = 0;
+    stop_pwm();
+    
+    // Alarm działa na tym samym rdzeniu, więc po cancel_alarm flaga już się nie zmieni
+    return !exposure_done;
 }
 
 // ========================================
@@ -356,11 +589,16 @@ void update_main_display(void)
 // ========================================
 void reset_timer(void)
 {
+    // Reset w trakcie naświetlania wyłącza też lampę
+    if (timer_running) {
+        cancel_exposure();
+    }
+    
     timer_running = false;
-    timer_remaining_ms = configured_timer_value * 1000;
-    last_timer_update = 0;
-    last_arc_update = 0;
-    update_main_display();
+    exposure_done = false;
+    exposure_end_us = 0;
+    timer_remaining_us = configured_timer_value * 1000000ull;
+    ui_state_dirty = true;
 }
 
 // ========================================
@@ -369,17 +607,32 @@ void reset_timer(void)
 void toggle_timer(void)
 {
     if (timer_running) {
-        // Zatrzymaj timer
+        // Zatrzymaj timer - zostaje czas do terminu
+        if (!cancel_exposure()) {
+            return;  // Naświetlanie już się skończyło, reset w process_timer
+        }
+        
+        uint64_t now_us = time_us_64();
+        timer_remaining_us = exposure_end_us > now_us ? exposure_end_us - now_us : 0;
         timer_running = false;
-        stop_pwm();
+        exposure_end_us = 0;
+        ui_state_dirty = true;
     } else {
         // Uruchom timer
-        if (timer_remaining_ms > 0) {
-            timer_running = true;
-            last_timer_update = time_us_64() / 1000;
-            last_arc_update = last_timer_update;
+        if (timer_remaining_us > 0) {
+            exposure_done = false;
+            exposure_end_us = time_us_64() + timer_remaining_us;
             
             start_pwm();
+            exposure_alarm = add_alarm_at(from_us_since_boot(exposure_end_us), exposure_alarm_callback, NULL, true);
+            if (exposure_alarm <= 0) {
+                stop_pwm();  // Brak wolnego alarmu - bez wyłącznika nie naświetlamy
+                exposure_end_us = 0;
+                return;
+            }
+            
+            timer_running = true;
+            ui_state_dirty = true;
         }
     }
 }
@@ -389,49 +642,17 @@ void toggle_timer(void)
 // ========================================
 void process_timer(void)
 {
-    if (!timer_running || current_screen != 0) {
+    // PWM wyłączył już alarm - tu tylko automatyczny reset do wartości początkowej
+    if (!exposure_done) {
         return;
     }
     
-    uint64_t current_time = time_us_64() / 1000; // czas w ms
-    uint64_t elapsed = current_time - last_timer_update;
-    
-    if (elapsed > 0) {
-        last_timer_update = current_time;
-        
-        // Odejmij upłynięty czas
-        if (timer_remaining_ms > elapsed) {
-            timer_remaining_ms -= elapsed;
-        } else {
-            // Timer zakończony
-            timer_remaining_ms = 0;
-            timer_running = false;
-            
-            // Zatrzymaj PWM po zakończeniu timera
-            stop_pwm();  
-            
-            // Automatyczny reset do wartości początkowej
-            timer_remaining_ms = configured_timer_value * 1000;
-            update_main_display();
-            
-            return; // Zakończ funkcję, nie aktualizuj już wyświetlacza
-        }
-        
-        // Aktualizuj etykietę co sekundę (gdy zmienia się wartość w sekundach)
-        static uint32_t last_displayed_seconds = 0xFFFFFFFF;
-        uint32_t current_seconds = timer_remaining_ms / 1000;
-        
-        if (current_seconds != last_displayed_seconds) {
-            update_main_label();
-            last_displayed_seconds = current_seconds;
-        }
-        
-        // Aktualizuj arc częściej (co ARC_UPDATE_INTERVAL_MS)
-        if (current_time - last_arc_update >= ARC_UPDATE_INTERVAL_MS) {
-            update_main_arc();
-            last_arc_update = current_time;
-        }
-    }
+    timer_running = false;
+    exposure_done = false;
+    exposure_alarm = 0;
+    exposure_end_us = 0;
+    timer_remaining_us = configured_timer_value * 1000000ull;
+    ui_state_dirty = true;
 }
 
 // ========================================
@@ -439,50 +660,20 @@ void process_timer(void)
 // ========================================
 void gpio_callback(uint gpio, uint32_t events)
 {
-    // Obsługa enkodera
-    if (gpio == ENC_A_PIN || gpio == ENC_B_PIN) {
-        uint8_t enc_a = gpio_get(ENC_A_PIN);
-        uint8_t enc_b = gpio_get(ENC_B_PIN);
-        uint8_t current_state = (enc_a << 1) | enc_b;
-        
-        // Dekodowanie kierunku obrotu (Gray code)
-        uint8_t combined = (encoder_last_state << 2) | current_state;
-        
-        switch(combined) {
-            case 0b0001: case 0b0111: case 0b1110: case 0b1000:
-                encoder_delta++;
-                break;
-            case 0b0010: case 0b0100: case 0b1101: case 0b1011:
-                encoder_delta--;
-                break;
-        }
-        
-        encoder_last_state = current_state;
-    }
-    // Obsługa przycisków
-    else if (gpio == BUTT1_PIN) {
-        uint64_t current_time = time_us_64() / 1000; // czas w ms
-        
-        if (events & GPIO_IRQ_EDGE_FALL) {
-            // Przycisk wciśnięty
-            butt1_pressed = true;
-            butt1_press_time = current_time;
-            butt1_handled = false;
-        } else if (events & GPIO_IRQ_EDGE_RISE) {
-            // Przycisk zwolniony
-            butt1_pressed = false;
-        }
-    } else if (gpio == BUTT2_PIN) {
-        uint64_t current_time = time_us_64() / 1000; // czas w ms
-        
-        if (events & GPIO_IRQ_EDGE_FALL) {
-            butt2_pressed = true;
-            butt2_press_time = current_time;
-            butt2_handled = false;
-        } else if (events & GPIO_IRQ_EDGE_RISE) {
-            butt2_pressed = false;
-        }
+    // Tylko zapis zdarzenia z czasem - dekodowanie w głównej pętli, więc szybkie
+    // wciśnięcia i serie kroków enkodera nie zlewają się w jedną zmienną
+    input_event_t event;
+    event.time_us = time_us_32();
+    event.pin = gpio;
+    event.edges = events & (GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL);
+    event.level = gpio_get(gpio);
+    
+    if (!spsc_queue_push(&input_ring, &event)) {
+        input_events_dropped++;
     }
+    
+    // Obudź główną pętlę, także gdy przerwanie przyszło tuż przed WFE
+    __sev();
 }
 
 // ========================================
@@ -506,8 +697,11 @@ void init_gpio(void)
     gpio_pull_up(BUTT1_PIN);
     gpio_pull_up(BUTT2_PIN);
     
-    // Odczytaj początkowy stan enkodera
-    encoder_last_state = (gpio_get(ENC_A_PIN) << 1) | gpio_get(ENC_B_PIN);
+    // Kolejka zdarzeń i dekoder z początkowym stanem enkodera
+    static const uint8_t button_pins[INPUT_NUM_BUTTONS] = {BUTT1_PIN, BUTT2_PIN};
+    spsc_queue_init(&input_ring, input_ring_slots, sizeof(input_event_t), INPUT_RING_CAPACITY);
+    input_decoder_init(&input_decoder, ENC_A_PIN, ENC_B_PIN, (gpio_get(ENC_A_PIN) << 1) | gpio_get(ENC_B_PIN),
+                       button_pins, DEBOUNCE_TIME_MS * 1000, LONG_PRESS_TIME_MS * 1000);
     
     // Ustawienie przerwań z jednym wspólnym callbackiem
     gpio_set_irq_enabled_with_callback(ENC_A_PIN, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true, &gpio_callback);
@@ -517,17 +711,10 @@ void init_gpio(void)
 }
 
 // ========================================
-// OBSŁUGA ENKODERA W GŁÓWNEJ PĘTLI
+// OBSŁUGA ENKODERA
 // ========================================
-void process_encoder(void)
+void process_encoder(int8_t delta)
 {
-    if (encoder_delta == 0) {
-        return;
-    }
-    
-    int8_t delta = encoder_delta;
-    encoder_delta = 0;
-    
     // Obsługa enkodera tylko w trybie edycji
     if (!edit_mode) {
         return;
@@ -539,7 +726,7 @@ void process_encoder(void)
         if (new_value < 0) new_value = 0;
         if (new_value > 100) new_value = 100;
         configured_power_value = new_value;
-        update_power_display();
+        ui_state_dirty = true;
         
     } else if (current_screen == 2) {
         // Ekran konfiguracji timera
@@ -547,123 +734,124 @@ void process_encoder(void)
         if (new_value < 0) new_value = 0;
         if (new_value > 180) new_value = 180;
         configured_timer_value = new_value;
-        update_timer_display();
+        ui_state_dirty = true;
     }
 }
 
 // ========================================
-// OBSŁUGA PRZYCISKÓW W GŁÓWNEJ PĘTLI
+// OBSŁUGA BUTT1 (zmiana ekranów / tryb edycji)
 // ========================================
-void process_buttons(void)
+void process_butt1(uint8_t kind)
 {
-    uint64_t current_time = time_us_64() / 1000; // czas w ms
-    
-    // ========================================
-    // Obsługa BUTT1 (zmiana ekranów / tryb edycji)
-    // ========================================
-    if (butt1_pressed && !butt1_handled) {
-        uint64_t press_duration = current_time - butt1_press_time;
-        
-        // Long press - wejście/wyjście z trybu edycji
-        if (press_duration >= LONG_PRESS_TIME_MS) {
-            butt1_handled = true;
+    if (kind == INPUT_LONG_PRESS) {
+        // Long press - wejście/wyjście z trybu edycji, tylko na ekranach konfiguracji
+        if (current_screen == 1 || current_screen == 2) {
+            edit_mode = !edit_mode;
+            ui_state_dirty = true; // Widoczność arków
             
-            // Long press działa tylko na ekranach konfiguracji
-            if (current_screen == 1 || current_screen == 2) {
-                edit_mode = !edit_mode;
-                update_arc_visibility(); // Aktualizuj widoczność arków
+            // Zapisz konfigurację do flash przy wyjściu z trybu edycji
+            if (!edit_mode) {
+                save_config_to_flash();
             }
         }
-    } else if (!butt1_pressed && butt1_press_time > 0) {
-        // Przycisk został zwolniony
-        uint64_t press_duration = current_time - butt1_press_time;
-        
-        // Short press - zmiana ekranu
-        // BLOKADA: nie można zmieniać ekranu podczas pracy timera, w trybie edycji lub po long press
-        if (press_duration < LONG_PRESS_TIME_MS && 
-            press_duration > DEBOUNCE_TIME_MS && 
-            !edit_mode && 
-            !timer_running) {  // <-- DODANA BLOKADA
-            
-            current_screen++;
-            if (current_screen > 2) {
-                current_screen = 0;
-            }
-            
-            switch(current_screen) {
-                case 0:
-                    lv_scr_load_anim(ui_ScreenMain, 
-                                    LV_SCR_LOAD_ANIM_MOVE_LEFT, 
-                                    500, 0, false);
-                    // Zresetuj timer przy powrocie do ekranu głównego
-                    reset_timer();
-                    break;
-                case 1:
-                    lv_scr_load_anim(ui_ScreenPowerSetting, 
-                                    LV_SCR_LOAD_ANIM_MOVE_LEFT, 
-                                    500, 0, false);
-                    update_arc_visibility(); // Aktualizuj po zmianie ekranu
-                    break;
-                case 2:
-                    lv_scr_load_anim(ui_ScreenTimerSetting, 
-                                    LV_SCR_LOAD_ANIM_MOVE_LEFT, 
-                                    500, 0, false);
-                    update_arc_visibility(); // Aktualizuj po zmianie ekranu
-                    break;
-            }
-        }
-        
-        butt1_press_time = 0;
-        butt1_handled = false;
+        return;
     }
     
-    // ========================================
-    // Obsługa BUTT2 (timer play/pause/reset)
-    // ========================================
-    if (butt2_pressed && !butt2_handled) {
-        uint64_t press_duration = current_time - butt2_press_time;
-        
-        // Long press - reset timera (tylko na ekranie głównym)
-        if (press_duration >= LONG_PRESS_TIME_MS) {
-            butt2_handled = true;
-            
-            if (current_screen == 0) {
-                reset_timer();
-            }
-        }
-    } else if (!butt2_pressed && butt2_press_time > 0) {
-        // Przycisk został zwolniony
-        uint64_t press_duration = current_time - butt2_press_time;
-        
-        // Short press - play/pause (tylko jeśli nie było long press i jesteśmy na ekranie głównym)
-        if (press_duration < LONG_PRESS_TIME_MS && press_duration > DEBOUNCE_TIME_MS) {
-            if (current_screen == 0 && !butt2_handled) {
-                toggle_timer();
-            }
-        }
-        
-        butt2_press_time = 0;
-        butt2_handled = false;
+    // Short press - zmiana ekranu
+    // BLOKADA: nie można zmieniać ekranu podczas pracy timera ani w trybie edycji
+    if (edit_mode || timer_running) {
+        return;
+    }
+    
+    current_screen++;
+    if (current_screen > 2) {
+        current_screen = 0;
+    }
+    
+    // Zmiana ekranu jako komenda dla UI, stan z nowym numerem ekranu za nią
+    pending_screen = current_screen;
+    ui_state_dirty = true;
+    
+    if (current_screen == 0) {
+        // Zresetuj timer przy powrocie do ekranu głównego
+        reset_timer();
+    }
+}
+
+// ========================================
+// OBSŁUGA BUTT2 (timer play/pause/reset)
+// ========================================
+void process_butt2(uint8_t kind)
+{
+    // Tylko na ekranie głównym
+    if (current_screen != 0) {
+        return;
+    }
+    
+    if (kind == INPUT_LONG_PRESS) {
+        // Long press - reset timera
+        reset_timer();
+    } else {
+        // Short press - play/pause
+        toggle_timer();
+    }
+}
+
+static void on_input_action(const input_action_t *action, void *ctx)
+{
+    (void)ctx;
+    
+    if (action->kind == INPUT_TURN) {
+        process_encoder(action->steps);
+    } else if (action->button == 0) {
+        process_butt1(action->kind);
+    } else {
+        process_butt2(action->kind);
     }
 }
 
 // ========================================
-// INICJALIZACJA HARDWARE
+// OBSŁUGA WEJŚĆ W GŁÓWNEJ PĘTLI
 // ========================================
-bool init_hardware(void)
+void process_inputs(void)
 {
+    // Zdarzenia w kolejności, w jakiej przyszły - każde wciśnięcie i każdy krok osobno
+    input_event_t event;
+    while (spsc_queue_pop(&input_ring, &event)) {
+        input_decoder_event(&input_decoder, &event, on_input_action, NULL);
+    }
+    
+    // Terminy bez nowych zdarzeń: koniec debounce, long press
+    input_decoder_poll(&input_decoder, time_us_32(), on_input_action, NULL);
+}
+
+// ========================================
+// INICJALIZACJA WYŚWIETLACZA (RDZEŃ UI)
+// ========================================
+bool init_display(void)
+{
+    // Przerwanie DMA trafia do rdzenia, który je włączył - stąd inicjalizacja na rdzeniu UI
     if (DEV_Module_Init() != 0) {
         return false;
     }
     
     DEV_SET_PWM(100);
     LCD_1IN69_Init(VERTICAL);
+#if LCD_RGB444_TRANSFER
+    LCD_1IN69_SetColorMode(LCD_1IN69_COLOR_RGB444);
+#endif
     LCD_1IN69_Clear(WHITE);
     
+    return true;
+}
+
+// ========================================
+// INICJALIZACJA HARDWARE (RDZEŃ STEROWANIA)
+// ========================================
+void init_hardware(void)
+{
     init_gpio();
     init_pwm();
-    
-    return true;
 }
 
 // ========================================
@@ -673,8 +861,8 @@ bool init_lvgl(void)
 {
     lv_init();
     
-    // Inicjalizacja bufora rysowania
-    lv_disp_draw_buf_init(&draw_buf, buf1, NULL, LCD_1IN69_WIDTH * 70);
+    // Inicjalizacja podwójnego bufora rysowania
+    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, LVGL_BUF_SIZE);
     
     // Inicjalizacja sterownika wyświetlacza
     static lv_disp_drv_t disp_drv;
@@ -690,69 +878,131 @@ bool init_lvgl(void)
         return false;
     }
     
-    // Timer dla LVGL tick (1ms)
-    static struct repeating_timer timer;
-    add_repeating_timer_ms(1, lvgl_timer_callback, NULL, &timer);
-    
+    // Tick LVGL czytany z licznika time_us_64() (LV_TICK_CUSTOM w lv_conf.h) - bez przerwań co 1 ms
     return true;
 }
 
 // ========================================
-// INICJALIZACJA UI
+// INICJALIZACJA STANU LAMPY
 // ========================================
-void init_ui_timers(void)
+void init_lamp_state(void)
 {
     // Załaduj konfigurację z flash
     load_config_from_flash();
     
-    ui_init();
-    
-    // Inicjalizacja początkowych wartości
-    update_timer_display();
-    update_power_display();
-    
     // Inicjalizacja timera głównego
-    timer_remaining_ms = configured_timer_value * 1000;
+    timer_remaining_us = configured_timer_value * 1000000ull;
+    
+    // Pierwszy stan dla UI (ui_state_dirty) rysuje wszystkie wartości
+    ui_state_dirty = true;
+}
+
+// ========================================
+// INICJALIZACJA UI
+// ========================================
+void init_ui(void)
+{
+    ui_init();
     
     // Ukryj arki na starcie (nie jesteśmy w trybie edycji)
     lv_obj_add_flag(ui_ArcPowerValue, LV_OBJ_FLAG_HIDDEN);
     lv_obj_add_flag(ui_ArcTimeValue, LV_OBJ_FLAG_HIDDEN);
     
-    // Załaduj ekran główny i zaktualizuj jego wartości
+    // Załaduj ekran główny, wartości przyjdą z pierwszym stanem lampy
     lv_scr_load(ui_ScreenMain);
-    update_main_display();
 }
 
 // ========================================
-// GŁÓWNA PĘTLA Z KONTROLĄ FPS
+// NAJBLIŻSZY TERMIN PRACY GŁÓWNEJ PĘTLI
+// ========================================
+// Czas (ms od startu), do którego pętla może spać, jeśli nie obudzi jej przerwanie
+uint64_t next_wakeup_ms(uint64_t now_ms, uint32_t lvgl_wait_ms)
+{
+    // LV_NO_TIMER_READY (0xFFFFFFFF) daje termin praktycznie nieskończony
+    // Koniec naświetlania budzi pętlę przerwaniem alarmu, odliczanie na ekranie jest w czasie UI
+    uint64_t wakeup = now_ms + lvgl_wait_ms;
+    
+    // Przyciski: koniec okna debounce albo moment rozpoznania long press
+    uint32_t input_deadline_us;
+    if (input_decoder_deadline(&input_decoder, &input_deadline_us)) {
+        int32_t wait_us = (int32_t)(input_deadline_us - time_us_32());
+        uint64_t input_wakeup = (time_us_64() + (wait_us > 0 ? wait_us : 0) + 999) / 1000;
+        if (input_wakeup < wakeup) wakeup = input_wakeup;
+    }
+    
+    return wakeup;
+}
+
+// ========================================
+// GŁÓWNA PĘTLA STEROWANA ZDARZENIAMI
 // ========================================
 void main_loop(void)
 {
     while (1) {
-        uint64_t frame_start = time_us_64();
-        
         // Obsługa timera
         process_timer();
         
-        // Obsługa enkodera
-        process_encoder();
-        
-        // Obsługa przycisków
-        process_buttons();
+        // Obsługa enkodera i przycisków (zdarzenia z przerwania GPIO)
+        process_inputs();
         
-        // Obsługa LVGL (renderowanie, timery, eventy)
-        lv_timer_handler();
+        // Nowy stan i komendy dla UI
+        publish_ui();
         
-        // Oblicz czas renderowania ramki
-        uint64_t frame_time = (time_us_64() - frame_start) / 1000;
+#if UV_LAMP_MULTICORE
+        // LVGL pracuje na rdzeniu 1; przy pełnej kolejce ponowna próba za 1 ms
+        uint32_t lvgl_wait_ms = ui_publish_pending() ? 1 : LV_NO_TIMER_READY;
+#else
+        // Odliczanie i LVGL - zwraca czas do następnej pracy UI
+        uint32_t lvgl_wait_ms = ui_handler();
+#endif
         
-        // Poczekaj do następnej ramki (kontrola FPS)
-        if (frame_time < FRAME_TIME_MS) {
-            sleep_ms(FRAME_TIME_MS - frame_time);
+        // Sen do najbliższego terminu; przerwanie GPIO (__sev) lub DMA budzi wcześniej
+        uint64_t wakeup_ms = next_wakeup_ms(time_us_64() / 1000, lvgl_wait_ms);
+        best_effort_wfe_or_timeout(from_us_since_boot(wakeup_ms * 1000));
+    }
+}
+
+#if UV_LAMP_MULTICORE
+// ========================================
+// PĘTLA UI NA RDZENIU 1
+// ========================================
+void ui_loop(void)
+{
+    while (1) {
+        // Stan i komendy od rdzenia 0
+        ui_msg_t msg;
+        while (spsc_queue_pop(&ui_queue, &msg)) {
+            handle_ui_message(&msg);
         }
+        
+        // Odliczanie i LVGL - zwraca czas do następnej pracy UI
+        uint32_t lvgl_wait_ms = ui_handler();
+        
+        // Sen do następnego timera LVGL lub zmiany odliczania; wiadomość z rdzenia 0 (__sev) lub przerwanie DMA budzi wcześniej
+        best_effort_wfe_or_timeout(make_timeout_time_ms(lvgl_wait_ms));
     }
 }
 
+// ========================================
+// WEJŚCIE RDZENIA 1
+// ========================================
+void core1_main(void)
+{
+    // Zapis flash na rdzeniu 0 wstrzymuje ten rdzeń (multicore_lockout)
+    multicore_lockout_victim_init();
+    
+    // Inicjalizacja wyświetlacza i LVGL
+    if (!init_display() || !init_lvgl()) {
+        while(1) { tight_loop_contents(); }  // Zatrzymaj się w przypadku błędu
+    }
+    
+    // Inicjalizacja UI
+    init_ui();
+    
+    ui_loop();
+}
+#endif
+
 // ========================================
 // MAIN
 // ========================================
@@ -760,18 +1010,23 @@ int main(void)
 {
     sleep_ms(100);  // Stabilizacja po starcie
     
-    // Inicjalizacja hardware
-    if (!init_hardware()) {
-        while(1) { tight_loop_contents(); }  // Zatrzymaj się w przypadku błędu
-    }
+    // Inicjalizacja hardware sterowania i stanu lampy
+    init_hardware();
+    init_lamp_state();
     
-    // Inicjalizacja LVGL
-    if (!init_lvgl()) {
+#if UV_LAMP_MULTICORE
+    // Wyświetlacz, LVGL i UI na rdzeniu 1
+    spsc_queue_init(&ui_queue, ui_queue_slots, sizeof(ui_msg_t), UI_QUEUE_CAPACITY);
+    multicore_launch_core1(core1_main);
+#else
+    // Inicjalizacja wyświetlacza i LVGL
+    if (!init_display() || !init_lvgl()) {
         while(1) { tight_loop_contents(); }  // Zatrzymaj się w przypadku błędu
     }
     
     // Inicjalizacja UI
-    init_ui_timers();
+    init_ui();
+#endif
     
     // Główna pętla
     main_loop();
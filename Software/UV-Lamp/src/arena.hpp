@@ -0,0 +1,60 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+namespace Graphics {
+
+    /// @brief Bump allocator over a caller supplied buffer
+    /// @details Allocation only moves a pointer forward; memory is given back all
+    ///          at once with reset() or rewind() to an earlier mark
+    class Arena {
+    private:
+        uint8_t* base;      // start of buffer
+        size_t capacity;    // size of buffer in bytes
+        size_t used;        // bytes already handed out
+
+    public:
+        /// @brief Contructor of Arena
+        /// @param buffer memory to allocate from, must outlive the arena
+        /// @param size size of buffer in bytes
+        Arena(void* buffer, size_t size) : base(static_cast<uint8_t*>(buffer)), capacity(size), used(0) {}
+
+        // Remove unwanted stuff
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /// @brief Function to allocate memory
+        /// @param size number of bytes
+        /// @param align alignment, power of two
+        /// @return memory or nullptr if arena is full
+        void* allocate(size_t size, size_t align = alignof(max_align_t)) {
+            const uintptr_t start = reinterpret_cast<uintptr_t>(base) + used;
+            const size_t padding = (align - (start & (align - 1))) & (align - 1);
+            if (padding + size > capacity - used) return nullptr;
+            used += padding + size;
+            return reinterpret_cast<void*>(start + padding);
+        }
+
+        /// @brief Function to allocate uninitialized array of objects
+        /// @param count number of objects
+        /// @return memory or nullptr if arena is full
+        template<typename T>
+        T* allocate(size_t count = 1) { return static_cast<T*>(allocate(sizeof(T) * count, alignof(T))); }
+
+        /// @brief Function to get position to rewind to later
+        size_t mark() const { return used; }
+
+        /// @brief Function to free everything allocated after mark
+        void rewind(size_t position) { if (position < used) used = position; }
+
+        /// @brief Function to free everything
+        void reset() { used = 0; }
+
+        /// @brief Function to get number of bytes in use
+        size_t getUsed() const { return used; }
+
+        /// @brief Function to get size of buffer
+        size_t getCapacity() const { return capacity; }
+    };
+
+} // namespace Graphics
@@ -0,0 +1,50 @@
+#include "dirty_region.hpp"
+
+namespace Graphics {
+
+void DirtyRegion::add(Rect rect) {
+    if (rect.empty()) return;
+
+    while (true) {
+        // Scalenie opłaca się, gdy dodatkowe piksele kosztują mniej niż osobne okno
+        uint8_t merge = count;
+        uint8_t cheapest = 0;
+        int64_t cheapestExtra = INT64_MAX;
+        for (uint8_t i = 0; i < count; ++i) {
+            if (rects[i].contains(rect)) return;
+
+            const int64_t extra = static_cast<int64_t>(rect.unite(rects[i]).area()) - rect.area() - rects[i].area();
+            if (extra <= static_cast<int64_t>(windowCost)) {
+                merge = i;
+                break;
+            }
+            if (extra < cheapestExtra) {
+                cheapestExtra = extra;
+                cheapest = i;
+            }
+        }
+
+        if (merge == count) {
+            // Nic się nie opłaca i jest miejsce - nowy prostokąt
+            if (count < Capacity) {
+                rects[count++] = rect;
+                return;
+            }
+            merge = cheapest;
+        }
+
+        // Scalony prostokąt może teraz opłacać się scalić z kolejnym
+        rect = rect.unite(rects[merge]);
+        remove(merge);
+    }
+}
+
+uint32_t DirtyRegion::pixelCount() const {
+    uint32_t pixels = 0;
+    for (uint8_t i = 0; i < count; ++i) {
+        pixels += rects[i].area();
+    }
+    return pixels;
+}
+
+} // namespace Graphics
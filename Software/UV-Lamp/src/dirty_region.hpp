@@ -0,0 +1,80 @@
+#pragma once
+#include <stdint.h>
+
+namespace Graphics {
+
+    /// @brief Rectangle on canvas, corners inclusive
+    struct Rect {
+        int16_t x0;
+        int16_t y0;
+        int16_t x1;
+        int16_t y1;
+
+        /// @brief Function to check if rectangle has no pixels
+        constexpr bool empty() const { return x1 < x0 || y1 < y0; }
+
+        /// @brief Function to get number of pixels in rectangle
+        constexpr uint32_t area() const {
+            return empty() ? 0 : static_cast<uint32_t>(x1 - x0 + 1) * static_cast<uint32_t>(y1 - y0 + 1);
+        }
+
+        /// @brief Function to check if rectangle fully covers other one
+        constexpr bool contains(const Rect& other) const {
+            return other.x0 >= x0 && other.x1 <= x1 && other.y0 >= y0 && other.y1 <= y1;
+        }
+
+        /// @brief Function to check if rectangles share any pixel
+        constexpr bool intersects(const Rect& other) const {
+            return other.x0 <= x1 && other.x1 >= x0 && other.y0 <= y1 && other.y1 >= y0;
+        }
+
+        /// @brief Function to get bounding box of both rectangles
+        constexpr Rect unite(const Rect& other) const {
+            return Rect{x0 < other.x0 ? x0 : other.x0, y0 < other.y0 ? y0 : other.y0,
+                        x1 > other.x1 ? x1 : other.x1, y1 > other.y1 ? y1 : other.y1};
+        }
+    };
+
+    /// @brief Small set of rectangles changed since last frame
+    /// @details Rectangles are merged when sending their bounding box is cheaper
+    ///          than sending both, with every extra window costing windowCost pixels
+    class DirtyRegion {
+    public:
+        static constexpr uint8_t Capacity = 8;              // max number of rectangles
+        static constexpr uint32_t DefaultWindowCost = 64;   // CASET + RASET + RAMWR, in pixels
+
+    private:
+        Rect rects[Capacity];       // dirty rectangles
+        uint8_t count;              // number of used rectangles
+        uint32_t windowCost;        // cost of one more window, in pixels
+
+        /// @brief Function to remove rectangle, order is not kept
+        void remove(uint8_t index) { rects[index] = rects[--count]; }
+
+    public:
+        /// @brief Contructor of DirtyRegion
+        /// @param cost cost of one more window, in pixels
+        explicit DirtyRegion(uint32_t cost = DefaultWindowCost) : rects(), count(0), windowCost(cost) {}
+
+        /// @brief Function to add changed rectangle
+        /// @param rect rectangle, already clipped to canvas
+        void add(Rect rect);
+
+        /// @brief Function to forget all rectangles
+        void clear() { count = 0; }
+
+        /// @brief Function to check if nothing changed
+        bool empty() const { return count == 0; }
+
+        /// @brief Function to get number of rectangles
+        uint8_t size() const { return count; }
+
+        /// @brief Function to get number of pixels to send
+        uint32_t pixelCount() const;
+
+        const Rect* begin() const { return rects; }
+        const Rect* end() const { return rects + count; }
+        const Rect& operator[](uint8_t index) const { return rects[index]; }
+    };
+
+} // namespace Graphics
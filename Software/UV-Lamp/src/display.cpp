@@ -1,9 +1,101 @@
 #include "display.hpp"
 
-void Display::Initialize() {
-    // TODO: implement initialization
+extern "C" {
+#include "DEV_Config.h"
+#include "LCD_1in69.h"
 }
 
-void Display::SetFrame(const Graphics::Canvas& canvas) {
-    // TODO: implement sending data to display
+namespace {
+
+// Porcje wierszy przekonwertowane do RGB565 dla płócien innych niż RGB565, dwie połówki:
+// jedna idzie przez DMA, gdy druga jest wypełniana. Każda mieści 8 wierszy w obu kierunkach skanowania
+constexpr size_t StagingPixels = 8 * LCD_1IN69_HEIGHT;
+UWORD staging[2][StagingPixels] __attribute__((aligned(4)));
+
+// Wysyła zmienione prostokąty płótna na ekran, jedno okno na porcję wierszy
+template<typename Format>
+void sendDirty(Graphics::PixelCanvas<Format>& canvas) {
+    uint8_t half = 0;
+    for (const Graphics::Rect& rect : canvas.getDirty()) {
+        // Prostokąt jest w granicach płótna, ekran w bieżącym kierunku skanowania może być mniejszy
+        const int16_t x1 = std::min<int16_t>(rect.x1, LCD_1IN69.WIDTH - 1);
+        const int16_t y1 = std::min<int16_t>(rect.y1, LCD_1IN69.HEIGHT - 1);
+        if (rect.x0 > x1 || rect.y0 > y1) continue;
+
+        const uint16_t width = x1 - rect.x0 + 1;
+        const int16_t rows = static_cast<int16_t>(StagingPixels / width);
+        for (int16_t top = rect.y0; top <= y1; top += rows) {
+            const int16_t bottom = std::min<int16_t>(top + rows - 1, y1);
+            UWORD* out = staging[half];
+            for (int16_t y = top; y <= bottom; ++y) {
+                const typename Format::Storage* row = canvas.data() + static_cast<size_t>(y) * canvas.getWidth() + rect.x0;
+                for (uint16_t x = 0; x < width; ++x) {
+                    *out++ = Graphics::Rgb565::pack(Format::unpack(row[x]));
+                }
+            }
+            // Wysyłka czeka na poprzednią, więc druga połówka jest już wolna do wypełnienia
+            LCD_1IN69_DisplayArea_DMA(rect.x0, top, x1, bottom, staging[half], NULL);
+            half ^= 1;
+        }
+    }
+    DEV_SPI_DMA_Wait();
+}
+
+// RGB565 jest już w kolejności bajtów panelu - prostokąt prosto z płótna
+template<>
+void sendDirty(Graphics::PixelCanvas<Graphics::Rgb565>& canvas) {
+    for (const Graphics::Rect& rect : canvas.getDirty()) {
+        LCD_1IN69_DisplayWindows(rect.x0, rect.y0, rect.x1, rect.y1, canvas.data(), canvas.getWidth());
+    }
+}
+
+} // namespace
+
+bool Display::Initialize() {
+    if (DEV_Module_Init() != 0) {
+        return false;
+    }
+
+    DEV_SET_PWM(100);
+    LCD_1IN69_Init(VERTICAL);
+    return true;
+}
+
+void Display::SetFrame(Graphics::Canvas& canvas) {
+    if (auto* c = canvas.as<Graphics::Rgb565>()) {
+        sendDirty(*c);
+    } else if (auto* c = canvas.as<Graphics::Rgb444>()) {
+        sendDirty(*c);
+    } else if (auto* c = canvas.as<Graphics::Rgb666>()) {
+        sendDirty(*c);
+    }
+    canvas.clearDirty();
+}
+
+void Display::RenderBanded(const Graphics::DisplayList& list, Graphics::PixelCanvas<Graphics::Rgb565>& front,
+                           Graphics::PixelCanvas<Graphics::Rgb565>& back) {
+    Graphics::PixelCanvas<Graphics::Rgb565>* strips[2] = {&front, &back};
+    const uint16_t lines = front.getHeight();
+    if (front.getWidth() != LCD_1IN69_WIDTH || back.getWidth() != LCD_1IN69_WIDTH || back.getHeight() != lines || lines == 0) {
+        return;
+    }
+
+    uint8_t current = 0;
+    for (uint16_t top = 0; top < LCD_1IN69_HEIGHT; top += lines) {
+        Graphics::PixelCanvas<Graphics::Rgb565>& strip = *strips[current];
+        const uint16_t bottom = std::min<uint16_t>(top + lines, LCD_1IN69_HEIGHT) - 1;
+
+        // Ten sam pasek dwa razy - trzeba poczekać aż poprzednia wysyłka się skończy
+        if (&front == &back) {
+            DEV_SPI_DMA_Wait();
+        }
+        list.replay(strip, 0, top);
+        strip.clearDirty();
+
+        // Pasek ma szerokość ekranu - jest spójnym kawałkiem ekranu
+        // Wysyłka czeka na poprzednią, więc drugi pasek jest już wolny do rysowania
+        LCD_1IN69_DisplayArea_DMA(0, top, LCD_1IN69_WIDTH - 1, bottom, strip.data(), NULL);
+        current ^= 1;
+    }
+    DEV_SPI_DMA_Wait();
 }
\ No newline at end of file
@@ -1,13 +1,24 @@
 #pragma once
 
+#include "display_list.hpp"
 #include "graphics.hpp"
 
 /// @brief Namespace for interaction with display
 namespace Display {
     /// @brief Function to initialize Display
-    void Initialize();
+    /// @return true if display is ready
+    bool Initialize();
 
-    /// @brief Function to send canvas to display
-    /// @param canvas canvas with content to display
-    void SetFrame(const Graphics::Canvas& canvas);
+    /// @brief Function to send changed part of canvas to display
+    /// @param canvas canvas with content to display, its dirty region is cleared
+    void SetFrame(Graphics::Canvas& canvas);
+
+    /// @brief Function to draw recorded frame strip by strip, without full framebuffer
+    /// @details Strips are rendered alternately; while one is sent over DMA the other
+    ///          is drawn. Passing the same strip twice renders and sends in turn
+    /// @param list recorded frame, in screen coordinates
+    /// @param front strip canvas, exactly display width, any number of lines
+    /// @param back second strip canvas of the same size
+    void RenderBanded(const Graphics::DisplayList& list, Graphics::PixelCanvas<Graphics::Rgb565>& front,
+                      Graphics::PixelCanvas<Graphics::Rgb565>& back);
 }
\ No newline at end of file
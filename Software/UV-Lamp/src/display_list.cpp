@@ -0,0 +1,266 @@
+#include "display_list.hpp"
+
+#include <string.h>
+#include <new>
+
+namespace Graphics {
+
+namespace {
+
+// Prostokąt z zakresu int32 przycięty do zakresu współrzędnych
+Rect makeRect(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    auto clamp = [](int32_t v) { return static_cast<int16_t>(std::min<int32_t>(std::max<int32_t>(v, INT16_MIN), INT16_MAX)); };
+    return Rect{clamp(x0), clamp(y0), clamp(x1), clamp(y1)};
+}
+
+} // namespace
+
+DisplayList::DisplayList(Arena& memory)
+    : arena(memory), start(memory.mark()), head(nullptr), tail(nullptr), count(0), culledCount(0) {
+}
+
+void DisplayList::reset() {
+    arena.rewind(start);
+    head = nullptr;
+    tail = nullptr;
+    count = 0;
+    culledCount = 0;
+}
+
+template<typename T>
+T* DisplayList::append(Op op, const Rect& bounds, const RGB& color, size_t extra) {
+    void* memory = arena.allocate(sizeof(T) + extra, alignof(T));
+    if (memory == nullptr) return nullptr;
+
+    T* cmd = new (memory) T();
+    cmd->next = nullptr;
+    cmd->bounds = bounds;
+    cmd->op = op;
+    cmd->culled = false;
+    cmd->color = color;
+
+    if (tail != nullptr) {
+        tail->next = cmd;
+    } else {
+        head = cmd;
+    }
+    tail = cmd;
+    ++count;
+    return cmd;
+}
+
+void DisplayList::cover(const Rect& rect) {
+    // Nieprzezroczyste wypełnienie nadpisuje wszystko, co w całości leży pod nim
+    for (Command* cmd = head; cmd != nullptr && cmd != tail; cmd = cmd->next) {
+        if (!cmd->culled && rect.contains(cmd->bounds)) {
+            cmd->culled = true;
+            ++culledCount;
+        }
+    }
+}
+
+bool DisplayList::clear(const RGB& color) {
+    if (append<Command>(Op::Clear, makeRect(INT16_MIN, INT16_MIN, INT16_MAX, INT16_MAX), color) == nullptr) return false;
+    cover(tail->bounds);
+    return true;
+}
+
+bool DisplayList::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, const RGB& color) {
+    if (w <= 0 || h <= 0) return true;
+    if (append<Command>(Op::FillRect, makeRect(x, y, x + w - 1, y + h - 1), color) == nullptr) return false;
+    cover(tail->bounds);
+    return true;
+}
+
+bool DisplayList::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const RGB& color, uint8_t thickness, LineCap cap) {
+    const int32_t reach = cap == LineCap::Square ? thickness : (thickness + 1) / 2;
+    const Rect bounds = makeRect(std::min(x0, x1) - reach, std::min(y0, y1) - reach, std::max(x0, x1) + reach, std::max(y0, y1) + reach);
+    LineCommand* cmd = append<LineCommand>(Op::Line, bounds, color);
+    if (cmd == nullptr) return false;
+    cmd->x0 = x0;
+    cmd->y0 = y0;
+    cmd->x1 = x1;
+    cmd->y1 = y1;
+    cmd->thickness = thickness;
+    cmd->cap = cap;
+    return true;
+}
+
+bool DisplayList::drawLineAA(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const RGB& color) {
+    const Rect bounds = makeRect(std::min(x0, x1), std::min(y0, y1), std::max(x0, x1) + 1, std::max(y0, y1) + 1);
+    LineCommand* cmd = append<LineCommand>(Op::LineAA, bounds, color);
+    if (cmd == nullptr) return false;
+    cmd->x0 = x0;
+    cmd->y0 = y0;
+    cmd->x1 = x1;
+    cmd->y1 = y1;
+    return true;
+}
+
+bool DisplayList::drawRingAA(int16_t cx, int16_t cy, uint16_t outer, uint16_t inner, const RGB& color) {
+    RingCommand* cmd = append<RingCommand>(Op::RingAA, makeRect(cx - outer, cy - outer, cx + outer, cy + outer), color);
+    if (cmd == nullptr) return false;
+    cmd->cx = cx;
+    cmd->cy = cy;
+    cmd->outer = outer;
+    cmd->inner = inner;
+    return true;
+}
+
+bool DisplayList::fillPolygon(const Point* points, uint8_t count, const RGB& color) {
+    if (points == nullptr || count < 3) return true;
+    if (count > MaxPolygonPoints) return false;
+
+    int16_t left = points[0].x, right = points[0].x, top = points[0].y, bottom = points[0].y;
+    for (uint8_t i = 1; i < count; ++i) {
+        left = std::min(left, points[i].x);
+        right = std::max(right, points[i].x);
+        top = std::min(top, points[i].y);
+        bottom = std::max(bottom, points[i].y);
+    }
+
+    PolygonCommand* cmd = append<PolygonCommand>(Op::Polygon, makeRect(left, top, right, bottom), color, (count - 1) * sizeof(Point));
+    if (cmd == nullptr) return false;
+    cmd->count = count;
+    memcpy(cmd->points, points, count * sizeof(Point));
+    return true;
+}
+
+bool DisplayList::drawText(int16_t x, int16_t y, const char* text, const sFONT& font, const RGB& color) {
+    if (text == nullptr) return true;
+    const size_t length = strlen(text);
+
+    const Rect bounds = makeRect(x, y, x + static_cast<int32_t>(length) * font.Width - 1, y + font.Height - 1);
+    TextCommand* cmd = append<TextCommand>(Op::Text, bounds, color, length);
+    if (cmd == nullptr) return false;
+    cmd->font = &font;
+    cmd->x = x;
+    cmd->y = y;
+    memcpy(cmd->text, text, length + 1);
+    return true;
+}
+
+bool DisplayList::recordBlit(const void* pixels, uint16_t width, uint16_t height, ColorDepth depth, const Rect& srcRect, int16_t x, int16_t y) {
+    if (pixels == nullptr) return true;
+
+    // Przycięcie do obrazu od razu - granice są wtedy dokładne i mogą zakrywać
+    const int32_t sx = std::max<int32_t>(srcRect.x0, 0), sy = std::max<int32_t>(srcRect.y0, 0);
+    const int32_t ex = std::min<int32_t>(srcRect.x1, width - 1), ey = std::min<int32_t>(srcRect.y1, height - 1);
+    if (sx > ex || sy > ey) return true;
+    const int32_t dx = x + sx - srcRect.x0, dy = y + sy - srcRect.y0;
+
+    BlitCommand* cmd = append<BlitCommand>(Op::Blit, makeRect(dx, dy, dx + ex - sx, dy + ey - sy), RGB());
+    if (cmd == nullptr) return false;
+    cmd->pixels = pixels;
+    cmd->width = width;
+    cmd->height = height;
+    cmd->depth = depth;
+    cmd->srcX = static_cast<uint16_t>(sx);
+    cmd->srcY = static_cast<uint16_t>(sy);
+    cover(cmd->bounds);
+    return true;
+}
+
+bool DisplayList::drawImage(const PackedImage& image, int16_t x, int16_t y) {
+    if (image.width == 0 || image.height == 0) return true;
+    ImageCommand* cmd = append<ImageCommand>(Op::Image, makeRect(x, y, x + image.width - 1, y + image.height - 1), RGB());
+    if (cmd == nullptr) return false;
+    cmd->image = &image;
+    cmd->x = x;
+    cmd->y = y;
+    cover(cmd->bounds);
+    return true;
+}
+
+template<typename Format>
+void DisplayList::draw(const Command& cmd, PixelCanvas<Format>& canvas, int16_t originX, int16_t originY) {
+    // Współrzędne ekranu przesunięte do współrzędnych płótna
+    switch (cmd.op) {
+        case Op::Clear:
+            canvas.clear(cmd.color);
+            break;
+        case Op::FillRect:
+            canvas.fillRect(cmd.bounds.x0 - originX, cmd.bounds.y0 - originY,
+                            cmd.bounds.x1 - cmd.bounds.x0 + 1, cmd.bounds.y1 - cmd.bounds.y0 + 1, cmd.color);
+            break;
+        case Op::Line: {
+            const LineCommand& line = static_cast<const LineCommand&>(cmd);
+            canvas.drawLine(line.x0 - originX, line.y0 - originY, line.x1 - originX, line.y1 - originY, cmd.color, line.thickness, line.cap);
+            break;
+        }
+        case Op::LineAA: {
+            const LineCommand& line = static_cast<const LineCommand&>(cmd);
+            canvas.drawLineAA(line.x0 - originX, line.y0 - originY, line.x1 - originX, line.y1 - originY, cmd.color);
+            break;
+        }
+        case Op::RingAA: {
+            const RingCommand& ring = static_cast<const RingCommand&>(cmd);
+            canvas.drawRingAA(ring.cx - originX, ring.cy - originY, ring.outer, ring.inner, cmd.color);
+            break;
+        }
+        case Op::Polygon: {
+            const PolygonCommand& polygon = static_cast<const PolygonCommand&>(cmd);
+            Point points[MaxPolygonPoints];
+            for (uint8_t i = 0; i < polygon.count; ++i) {
+                points[i] = Point{static_cast<int16_t>(polygon.points[i].x - originX), static_cast<int16_t>(polygon.points[i].y - originY)};
+            }
+            canvas.fillPolygon(points, polygon.count, cmd.color);
+            break;
+        }
+        case Op::Text: {
+            const TextCommand& text = static_cast<const TextCommand&>(cmd);
+            canvas.drawText(text.x - originX, text.y - originY, text.text, *text.font, cmd.color);
+            break;
+        }
+        case Op::Blit: {
+            const BlitCommand& blit = static_cast<const BlitCommand&>(cmd);
+            const Rect src{static_cast<int16_t>(blit.srcX), static_cast<int16_t>(blit.srcY),
+                           static_cast<int16_t>(blit.srcX + cmd.bounds.x1 - cmd.bounds.x0), static_cast<int16_t>(blit.srcY + cmd.bounds.y1 - cmd.bounds.y0)};
+            const int16_t x = cmd.bounds.x0 - originX, y = cmd.bounds.y0 - originY;
+            switch (blit.depth) {
+                case ColorDepth::RGB444:
+                    canvas.blit(Image<Rgb444>{static_cast<const Rgb444::Storage*>(blit.pixels), blit.width, blit.height}, src, x, y);
+                    break;
+                case ColorDepth::RGB565:
+                    canvas.blit(Image<Rgb565>{static_cast<const Rgb565::Storage*>(blit.pixels), blit.width, blit.height}, src, x, y);
+                    break;
+                case ColorDepth::RGB666:
+                    canvas.blit(Image<Rgb666>{static_cast<const Rgb666::Storage*>(blit.pixels), blit.width, blit.height}, src, x, y);
+                    break;
+            }
+            break;
+        }
+        case Op::Image: {
+            const ImageCommand& image = static_cast<const ImageCommand&>(cmd);
+            canvas.drawImage(*image.image, image.x - originX, image.y - originY);
+            break;
+        }
+    }
+}
+
+template<typename Format>
+void DisplayList::replay(PixelCanvas<Format>& canvas, int16_t originX, int16_t originY) const {
+    // Obszar ekranu pod płótnem
+    const Rect area = makeRect(originX, originY, originX + canvas.getWidth() - 1, originY + canvas.getHeight() - 1);
+    if (area.empty()) return;
+
+    // Start od ostatniego wypełnienia zakrywającego cały obszar
+    const Command* first = head;
+    for (const Command* cmd = head; cmd != nullptr; cmd = cmd->next) {
+        if (!cmd->culled && (cmd->op == Op::Clear || cmd->op == Op::FillRect || cmd->op == Op::Blit || cmd->op == Op::Image) && cmd->bounds.contains(area)) {
+            first = cmd;
+        }
+    }
+
+    for (const Command* cmd = first; cmd != nullptr; cmd = cmd->next) {
+        if (!cmd->culled && cmd->bounds.intersects(area)) {
+            draw(*cmd, canvas, originX, originY);
+        }
+    }
+}
+
+template void DisplayList::replay(PixelCanvas<Rgb444>&, int16_t, int16_t) const;
+template void DisplayList::replay(PixelCanvas<Rgb565>&, int16_t, int16_t) const;
+template void DisplayList::replay(PixelCanvas<Rgb666>&, int16_t, int16_t) const;
+
+} // namespace Graphics
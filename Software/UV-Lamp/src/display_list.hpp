@@ -0,0 +1,170 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#include "arena.hpp"
+#include "graphics.hpp"
+
+namespace Graphics {
+
+    /// @brief Recorded drawing commands, replayed later on any canvas
+    /// @details Coordinates are recorded in screen space; replay shifts them by the
+    ///          origin of the target canvas, so one list can be drawn strip by strip.
+    ///          Every command keeps its bounding box: commands fully covered by a later
+    ///          opaque fill are culled when recorded, and replay runs only the commands
+    ///          touching the target canvas or region
+    class DisplayList {
+    private:
+        /// @brief Type of recorded command
+        enum class Op : uint8_t {
+            Clear,
+            FillRect,
+            Line,
+            LineAA,
+            RingAA,
+            Polygon,
+            Text,
+            Blit,
+            Image
+        };
+
+        /// @brief Header of recorded command, its arguments follow
+        struct Command {
+            Command* next;      // next command in drawing order
+            Rect bounds;        // screen area the command may touch
+            Op op;              // type of command
+            bool culled;        // covered by later opaque fill
+            RGB color;          // color of command
+        };
+
+        struct LineCommand : Command {
+            int16_t x0, y0, x1, y1;
+            uint8_t thickness;
+            LineCap cap;
+        };
+
+        struct RingCommand : Command {
+            int16_t cx, cy;
+            uint16_t outer, inner;
+        };
+
+        struct PolygonCommand : Command {
+            uint8_t count;
+            Point points[1];    // count points
+        };
+
+        struct TextCommand : Command {
+            const sFONT* font;
+            int16_t x, y;
+            char text[1];       // zero terminated
+        };
+
+        struct BlitCommand : Command {
+            const void* pixels;     // source image, not copied
+            uint16_t width, height; // size of source image
+            ColorDepth depth;       // format of source image
+            uint16_t srcX, srcY;    // top left corner in source, bounds give the rest
+        };
+
+        struct ImageCommand : Command {
+            const PackedImage* image;   // not copied
+            int16_t x, y;
+        };
+
+        Arena& arena;           // memory of commands
+        size_t start;           // arena position of first command
+        Command* head;          // first command
+        Command* tail;          // last command
+        uint16_t count;         // number of recorded commands
+        uint16_t culledCount;   // number of culled commands
+
+        /// @brief Function to allocate command and append it to list
+        /// @return command or nullptr if arena is full
+        template<typename T>
+        T* append(Op op, const Rect& bounds, const RGB& color, size_t extra = 0);
+
+        /// @brief Function to record blit of image in any format
+        bool recordBlit(const void* pixels, uint16_t width, uint16_t height, ColorDepth depth, const Rect& srcRect, int16_t x, int16_t y);
+
+        /// @brief Function to cull earlier commands covered by opaque rectangle
+        void cover(const Rect& rect);
+
+        /// @brief Function to draw one command
+        template<typename Format>
+        static void draw(const Command& cmd, PixelCanvas<Format>& canvas, int16_t originX, int16_t originY);
+
+    public:
+        /// @brief Contructor of DisplayList
+        /// @param memory arena for commands, the list allocates from its current position
+        explicit DisplayList(Arena& memory);
+
+        // Remove unwanted stuff
+        DisplayList(const DisplayList&) = delete;
+        DisplayList& operator=(const DisplayList&) = delete;
+
+        /// @brief Function to forget all commands and give their memory back to arena
+        void reset();
+
+        /// @brief Function to get number of recorded commands
+        uint16_t size() const { return count; }
+
+        /// @brief Function to get number of commands culled by later opaque fills
+        uint16_t culled() const { return culledCount; }
+
+        /// @brief Function to record clearing of whole canvas
+        /// @return false if arena is full
+        bool clear(const RGB& color = RGB());
+
+        /// @brief Function to record Canvas::fillRect
+        bool fillRect(int16_t x, int16_t y, int16_t w, int16_t h, const RGB& color);
+
+        /// @brief Function to record Canvas::drawLine
+        bool drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const RGB& color, uint8_t thickness = 1, LineCap cap = LineCap::Butt);
+
+        /// @brief Function to record Canvas::drawLineAA
+        bool drawLineAA(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const RGB& color);
+
+        /// @brief Function to record Canvas::drawRingAA
+        bool drawRingAA(int16_t cx, int16_t cy, uint16_t outer, uint16_t inner, const RGB& color);
+
+        /// @brief Function to record Canvas::fillCircleAA
+        bool fillCircleAA(int16_t cx, int16_t cy, uint16_t r, const RGB& color) { return drawRingAA(cx, cy, r, 0, color); }
+
+        /// @brief Function to record Canvas::fillTriangle
+        bool fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, const RGB& color) {
+            const Point points[3] = {{x0, y0}, {x1, y1}, {x2, y2}};
+            return fillPolygon(points, 3, color);
+        }
+
+        /// @brief Function to record Canvas::fillPolygon
+        /// @return false if arena is full or count is above MaxPolygonPoints
+        bool fillPolygon(const Point* points, uint8_t count, const RGB& color);
+
+        /// @brief Function to record Canvas::drawText, text is copied
+        bool drawText(int16_t x, int16_t y, const char* text, const sFONT& font, const RGB& color);
+
+        /// @brief Function to record Canvas::blit, pixels are not copied and must outlive replay
+        template<typename Format>
+        bool blit(const Image<Format>& src, const Rect& srcRect, int16_t x, int16_t y) {
+            return recordBlit(src.pixels, src.width, src.height, Format::depth, srcRect, x, y);
+        }
+
+        /// @brief Function to record Canvas::drawImage, image is not copied and must outlive replay
+        bool drawImage(const PackedImage& image, int16_t x, int16_t y);
+
+        /// @brief Function to draw commands touching canvas
+        /// @details Only commands whose bounds touch the screen area under the canvas are
+        ///          run, starting at the last opaque fill covering all of it. To redraw a
+        ///          dirty rectangle or strip use a canvas of that size placed over it
+        /// @param canvas target canvas
+        /// @param originX screen X coordinate of canvas pixel (0, 0)
+        /// @param originY screen Y coordinate of canvas pixel (0, 0)
+        template<typename Format>
+        void replay(PixelCanvas<Format>& canvas, int16_t originX = 0, int16_t originY = 0) const;
+    };
+
+    extern template void DisplayList::replay(PixelCanvas<Rgb444>&, int16_t, int16_t) const;
+    extern template void DisplayList::replay(PixelCanvas<Rgb565>&, int16_t, int16_t) const;
+    extern template void DisplayList::replay(PixelCanvas<Rgb666>&, int16_t, int16_t) const;
+
+} // namespace Graphics
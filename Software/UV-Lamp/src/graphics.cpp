@@ -1,159 +1,759 @@
 #include "graphics.hpp"
 
+#include <stdlib.h>
+#include <type_traits>
+
 namespace Graphics {
 
-// Implementacja metod RGB
-uint8_t RGB::toColorDepth(ColorDepth depth) const {
-    switch(depth) {
-        case ColorDepth::RGB444: {
-            // 4 bity na kanał (0-15)
-            uint8_t r4 = r >> 4;    // Konwersja 8 bitów do 4 bitów
-            uint8_t g4 = g >> 4;
-            uint8_t b4 = b >> 4;
-            return (r4 << 4) | b4;  // Zapisujemy R i B, G w osobnym bajcie
-        }
-        case ColorDepth::RGB565: {
-            // 5 bitów R (0-31), 6 bitów G (0-63), 5 bitów B (0-31)
-            uint8_t r5 = r >> 3;    // Konwersja 8 bitów do 5 bitów
-            uint8_t g6 = g >> 2;    // Konwersja 8 bitów do 6 bitów
-            uint8_t b5 = b >> 3;    // Konwersja 8 bitów do 5 bitów
-            return (r5 << 3) | b5;  // Zapisujemy R i B, G w osobnym bajcie
-        }
-        case ColorDepth::RGB666: {
-            // 6 bitów na kanał (0-63)
-            uint8_t r6 = r >> 2;    // Konwersja 8 bitów do 6 bitów
-            uint8_t g6 = g >> 2;
-            uint8_t b6 = b >> 2;
-            return (r6 << 2) | b6;  // Zapisujemy R i B, G w osobnym bajcie
+namespace {
+
+// Pierwiastek całkowity (zaokrąglony w dół), bez operacji zmiennoprzecinkowych
+uint32_t isqrt(uint32_t value) {
+    uint32_t result = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > value) bit >>= 2;
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
         }
-        default: {
-            return 0;
+        bit >>= 2;
+    }
+    return result;
+}
+
+// Jak wyżej, dla wartości powyżej 32 bitów
+uint64_t isqrt64(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > value) bit >>= 2;
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
         }
+        bit >>= 2;
     }
+    return result;
 }
 
-RGB RGB::fromColorDepth(uint8_t value, ColorDepth depth) {
-    switch(depth) {
-        case ColorDepth::RGB444: {
-            uint8_t r4 = (value >> 4) & 0x0F;
-            uint8_t b4 = value & 0x0F;
-            // Rozszerzenie do 8 bitów przez powielenie
-            uint8_t r = (r4 << 4) | r4;
-            uint8_t b = (b4 << 4) | b4;
-            return RGB(r, 0, b); // G musi być ustawione z drugiego bajtu
-        }
-        
-        case ColorDepth::RGB565: {
-            uint8_t r5 = (value >> 3) & 0x1F;
-            uint8_t b5 = value & 0x07;
-            // Rozszerzenie do 8 bitów
-            uint8_t r = (r5 << 3) | (r5 >> 2);
-            uint8_t b = (b5 << 3) | (b5 >> 2);
-            return RGB(r, 0, b); // G musi być ustawione z drugiego bajtu
-        }
-        
-        case ColorDepth::RGB666: {
-            uint8_t r6 = (value >> 2) & 0x3F;
-            uint8_t b6 = value & 0x03;
-            // Rozszerzenie do 8 bitów
-            uint8_t r = (r6 << 2) | (r6 >> 4);
-            uint8_t b = (b6 << 2) | (b6 >> 4);
-            return RGB(r, 0, b); // G musi być ustawione z drugiego bajtu
-        }
-        
-        default:
-            return RGB();
-    }
-}
-
-Canvas::Canvas(uint16_t w, uint16_t h, ColorDepth depth)
-    : width(w), height(h), colorDepth(depth) {
-    buffer.resize(calculateBufferSize(), 0);
+// Dzielenie z zaokrągleniem w dół / w górę, dzielnik dodatni
+template<typename T>
+T floorDiv(T n, T d) { return n >= 0 ? n / d : -((-n + d - 1) / d); }
+template<typename T>
+T ceilDiv(T n, T d) { return -floorDiv(-n, d); }
+
+// Zakres x, dla którego a * x + b leży w [lo, hi]; false gdy pusty
+template<typename T>
+bool solveRange(T a, T b, T lo, T hi, T& xmin, T& xmax) {
+    if (a == 0) {
+        return b >= lo && b <= hi;  // nie zależy od x - zakres bez zmian
+    }
+    if (a < 0) {
+        a = -a;
+        b = -b;
+        const T t = lo;
+        lo = -hi;
+        hi = -t;
+    }
+    xmin = std::max(xmin, ceilDiv(lo - b, a));
+    xmax = std::min(xmax, floorDiv(hi - b, a));
+    return xmin <= xmax;
 }
 
-Canvas::~Canvas() = default;
+// Największe |x| spełniające 4 * x^2 <= value, -1 gdy brak
+int32_t halfRoot(int32_t value) {
+    return value < 0 ? -1 : static_cast<int32_t>(isqrt(value)) / 2;
+}
+
+// Pokrycie piksela (0 - 64) przez brzeg koła o promieniu radius, odległość d w 1/64 piksela
+int32_t edgeCoverage(int32_t radius, int32_t d64) {
+    return std::min<int32_t>(std::max<int32_t>(radius * 64 + 32 - d64, 0), 64);
+}
+
+// Krawędź wielokąta skierowana w dół, x w formacie 16.16 dla bieżącego wiersza
+struct Edge {
+    int32_t x;          // przecięcie z wierszem na całkowitym y
+    int32_t step;       // przyrost x na wiersz
+    int16_t top;        // pierwszy wiersz krawędzi
+    int16_t bottom;     // wiersz za ostatnim wierszem krawędzi
+};
 
-uint8_t Canvas::getBytesPerPixel() const {
-    switch(colorDepth) {
-        case ColorDepth::RGB444: return 2;  // 12 bitów = 2 bajty
-        case ColorDepth::RGB565: return 2;  // 16 bitów = 2 bajty
-        case ColorDepth::RGB666: return 3;  // 18 bitów = 3 bajty
+} // namespace
+
+// Implementacja metod RGB
+uint32_t RGB::toColorDepth(ColorDepth depth) const {
+    switch(depth) {
+        case ColorDepth::RGB444: return Rgb444::encode(*this);
+        case ColorDepth::RGB565: return Rgb565::encode(*this);
+        case ColorDepth::RGB666: return Rgb666::encode(*this);
         default: return 0;
     }
 }
 
-size_t Canvas::calculateBufferSize() const {
-    return static_cast<size_t>(width) * height * getBytesPerPixel();
+RGB RGB::fromColorDepth(uint32_t value, ColorDepth depth) {
+    switch(depth) {
+        case ColorDepth::RGB444: return Rgb444::decode(value);
+        case ColorDepth::RGB565: return Rgb565::decode(value);
+        case ColorDepth::RGB666: return Rgb666::decode(value);
+        default: return RGB();
+    }
 }
 
-void Canvas::setPixelInBuffer(uint16_t x, uint16_t y, uint8_t color) {
-    if (x >= width || y >= height) return;
-    
-    size_t pixelOffset = (y * width + x) * getBytesPerPixel();
-    buffer[pixelOffset] = color;
+// Implementacja metod PixelCanvas
+template<typename Format>
+PixelCanvas<Format>::PixelCanvas(uint16_t w, uint16_t h, Storage* buffer)
+    : width(buffer ? w : 0), height(buffer ? h : 0), pixels(buffer) {
+    // Zawartość ekranu nieznana - pierwsza klatka wysyłana w całości
+    markDirty(0, 0, width - 1, height - 1);
 }
 
-RGB Canvas::getPixelFromBuffer(uint16_t x, uint16_t y) const {
-    if (x >= width || y >= height) return RGB();
-    
-    size_t pixelOffset = (y * width + x) * getBytesPerPixel();
-    return RGB::fromColorDepth(buffer[pixelOffset], colorDepth);
+template<typename Format>
+bool PixelCanvas<Format>::clipRect(int32_t& x, int32_t& y, int32_t& w, int32_t& h) const {
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > width) w = width - x;
+    if (y + h > height) h = height - y;
+    return w > 0 && h > 0;
 }
 
-void Canvas::clear(const RGB& color) {
-    uint8_t colorValue = color.toColorDepth(colorDepth);
-    for (uint16_t y = 0; y < height; ++y) {
-        for (uint16_t x = 0; x < width; ++x) {
-            setPixelInBuffer(x, y, colorValue);
-        }
+template<typename Format>
+void PixelCanvas<Format>::fillClipped(uint16_t x, uint16_t y, uint16_t w, uint16_t h, Storage value) {
+    Storage* row = pixels + static_cast<size_t>(y) * width + x;
+
+    // Pełne wiersze leżą w pamięci jeden za drugim - jedno wypełnienie
+    if (w == width) {
+        Format::fill(row, static_cast<size_t>(w) * h, value);
+        return;
+    }
+    for (; h > 0; --h, row += width) {
+        Format::fill(row, w, value);
     }
 }
 
-void Canvas::drawPixel(uint16_t x, uint16_t y, const RGB& color) {
-    if (x >= width || y >= height) return;
-    setPixelInBuffer(x, y, color.toColorDepth(colorDepth));
+template<typename Format>
+void PixelCanvas<Format>::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, const RGB& color) {
+    int32_t cx = x, cy = y, cw = w, ch = h;
+    if (!clipRect(cx, cy, cw, ch)) return;
+    fillClipped(cx, cy, cw, ch, Format::pack(color));
+    markDirty(cx, cy, cx + cw - 1, cy + ch - 1);
 }
 
-RGB Canvas::getPixel(uint16_t x, uint16_t y) const {
-    if (x >= width || y >= height) return RGB();
-    return getPixelFromBuffer(x, y);
+template<typename Format>
+void PixelCanvas<Format>::clear(const RGB& color) {
+    fillClipped(0, 0, width, height, Format::pack(color));
+    markDirty(0, 0, width - 1, height - 1);
+}
+
+template<typename Format>
+void PixelCanvas<Format>::fillSpan(int32_t x0, int32_t x1, int32_t y, Storage value) {
+    if (y < 0 || y >= height) return;
+    x0 = std::max<int32_t>(x0, 0);
+    x1 = std::min<int32_t>(x1, width - 1);
+    if (x0 > x1) return;
+    Format::fill(pixels + static_cast<size_t>(y) * width + x0, x1 - x0 + 1, value);
 }
 
-void Canvas::drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, const RGB& color, uint8_t thickness) {
-    // Implementacja algorytmu Bresenhama z obsługą grubości
-    int16_t dx = abs(static_cast<int16_t>(x1) - x0);
-    int16_t dy = abs(static_cast<int16_t>(y1) - y0);
-    int16_t sx = x0 < x1 ? 1 : -1;
-    int16_t sy = y0 < y1 ? 1 : -1;
-    int16_t err = dx - dy;
-    
-    // Oblicz offset dla grubości
-    int16_t thicknessOffset = thickness / 2;
+template<typename Format>
+void PixelCanvas<Format>::drawThinLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, Storage value) {
+    // Implementacja algorytmu Bresenhama
+    int32_t dx = abs(x1 - x0);
+    int32_t dy = abs(y1 - y0);
+    int32_t sx = x0 < x1 ? 1 : -1;
+    int32_t sy = y0 < y1 ? 1 : -1;
+    int32_t err = dx - dy;
+    int32_t x = x0;
+    int32_t y = y0;
 
     while (true) {
-        // Rysuj piksel z uwzględnieniem grubości
-        for (int16_t tx = -thicknessOffset; tx <= thicknessOffset; ++tx) {
-            for (int16_t ty = -thicknessOffset; ty <= thicknessOffset; ++ty) {
-                int16_t px = x0 + tx;
-                int16_t py = y0 + ty;
-                if (px >= 0 && px < width && py >= 0 && py < height) {
-                    drawPixel(px, py, color);
-                }
-            }
+        if (x >= 0 && x < width && y >= 0 && y < height) {
+            pixels[static_cast<size_t>(y) * width + x] = value;
         }
 
-        if (x0 == x1 && y0 == y1) break;
-        
-        int16_t e2 = 2 * err;
+        if (x == x1 && y == y1) break;
+
+        int32_t e2 = 2 * err;
         if (e2 > -dy) {
             err -= dy;
-            x0 += sx;
+            x += sx;
         }
         if (e2 < dx) {
             err += dx;
-            y0 += sy;
+            y += sy;
+        }
+    }
+}
+
+template<typename Format>
+void PixelCanvas<Format>::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const RGB& color, uint8_t thickness, LineCap cap) {
+    // Kolor pakowany raz dla całej linii
+    const Storage value = Format::pack(color);
+
+    // Obcięcie na starcie - linia w całości poza płótnem nie robi nic
+    // Narożniki kwadratowych końców sięgają do t/2 * sqrt(2) od punktu końcowego
+    // Cienka linia nie wychodzi poza swoje punkty końcowe
+    const int32_t reach = thickness <= 1 ? 0 : cap == LineCap::Square ? thickness : (thickness + 1) / 2;
+    const int32_t top = std::max<int32_t>(std::min(y0, y1) - reach, 0);
+    const int32_t bottom = std::min<int32_t>(std::max(y0, y1) + reach, height - 1);
+    if (top > bottom || std::max(x0, x1) + reach < 0 || std::min(x0, x1) - reach >= width) return;
+    markDirty(std::min(x0, x1) - reach, top, std::max(x0, x1) + reach, bottom);
+
+    if (thickness <= 1) {
+        if (y0 == y1) {
+            fillSpan(std::min(x0, x1), std::max(x0, x1), y0, value);
+        } else if (x0 == x1) {
+            int32_t x = x0, y = std::min(y0, y1), w = 1, h = abs(y1 - y0) + 1;
+            if (clipRect(x, y, w, h)) fillClipped(x, y, w, h, value);
+        } else {
+            drawThinLine(x0, y0, x1, y1, value);
+        }
+        return;
+    }
+
+    const int32_t dx = x1 - x0;
+    const int32_t dy = y1 - y0;
+    const int64_t lengthSq = static_cast<int64_t>(dx) * dx + static_cast<int64_t>(dy) * dy;
+
+    // Punkt zamiast linii: kwadrat albo koło o średnicy grubości
+    if (lengthSq == 0 && cap != LineCap::Round) {
+        int32_t x = x0 - thickness / 2, y = y0 - thickness / 2, w = thickness, h = thickness;
+        if (clipRect(x, y, w, h)) fillClipped(x, y, w, h, value);
+        return;
+    }
+
+    // Pas linii: |(p - p0) x d| <= t/2 * |d|, 0 <= (p - p0) . d <= |d|^2
+    // Wszystko w skali 16, |d| z pierwiastka całkowitego z 4 bitami ułamka
+    const int64_t halfWidth = static_cast<int64_t>(thickness) * static_cast<int64_t>(isqrt64(lengthSq * 256)) / 2;
+    const int64_t alongLo = cap == LineCap::Square ? -halfWidth : 0;
+    const int64_t alongHi = lengthSq * 16 + (cap == LineCap::Square ? halfWidth : 0);
+    const int32_t diameterSq = static_cast<int32_t>(thickness) * thickness;
+
+    // Do 4096 pikseli od p0 iloczyny mieszczą się w int32 (sprzętowy dzielnik RP2040),
+    // dłuższe linie i punkty daleko poza płótnem liczone w int64
+    const bool narrow = std::max({abs(dx), abs(dy), abs(x0), abs(top - y0), abs(bottom - y0)}) < 4096;
+    auto band = [&](auto zero, int32_t y, int32_t& spanLo, int32_t& spanHi) {
+        using T = decltype(zero);
+        const T ry = y - y0;
+        T lo = 0;
+        T hi = width - 1;
+        if (solveRange<T>(16 * dy, -16 * (static_cast<T>(x0) * dy + ry * dx), -halfWidth, halfWidth, lo, hi) &&
+            solveRange<T>(16 * dx, 16 * (ry * dy - static_cast<T>(x0) * dx), alongLo, alongHi, lo, hi)) {
+            spanLo = static_cast<int32_t>(lo);
+            spanHi = static_cast<int32_t>(hi);
+        }
+    };
+
+    for (int32_t y = top; y <= bottom; ++y) {
+        int32_t spanLo = width;
+        int32_t spanHi = -1;
+
+        if (lengthSq != 0) {
+            if (narrow) {
+                band(int32_t{}, y, spanLo, spanHi);
+            } else {
+                band(int64_t{}, y, spanLo, spanHi);
+            }
+        }
+
+        // Okrągłe końce: (x - cx)^2 <= (t/2)^2 - (y - cy)^2, w skali 4
+        // Kapsuła jest wypukła, więc suma zakresów w wierszu jest ciągła
+        if (cap == LineCap::Round) {
+            const int32_t ends[2][2] = {{x0, y0}, {x1, y1}};
+            for (const auto& end : ends) {
+                const int32_t ry = y - end[1];
+                if (ry < -thickness || ry > thickness) continue;
+                const int32_t rest = diameterSq - 4 * ry * ry;
+                if (rest < 0) continue;
+                const int32_t r = static_cast<int32_t>(isqrt(rest)) / 2;
+                spanLo = std::min(spanLo, end[0] - r);
+                spanHi = std::max(spanHi, end[0] + r);
+            }
+        }
+
+        fillSpan(spanLo, spanHi, y, value);
+    }
+}
+
+template<typename Format>
+void PixelCanvas<Format>::drawLineAA(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const RGB& color) {
+    const Storage value = Format::pack(color);
+
+    // Algorytm Wu: wzdłuż dłuższej osi, pozycja na krótszej w formacie 16.16
+    const bool steep = abs(y1 - y0) > abs(x1 - x0);
+    int32_t a0 = steep ? y0 : x0;
+    int32_t b0 = steep ? x0 : y0;
+    int32_t a1 = steep ? y1 : x1;
+    int32_t b1 = steep ? x1 : y1;
+    if (a0 > a1) {
+        std::swap(a0, a1);
+        std::swap(b0, b1);
+    }
+
+    // Obcięcie zakresu osi głównej do płótna
+    const int32_t limit = (steep ? height : width) - 1;
+    const int32_t first = std::max<int32_t>(a0, 0);
+    const int32_t last = std::min(a1, limit);
+    if (first > last) return;
+    if (steep) {
+        markDirty(std::min(b0, b1), first, std::max(b0, b1) + 1, last);
+    } else {
+        markDirty(first, std::min(b0, b1), last, std::max(b0, b1) + 1);
+    }
+
+    // Pozycja w formacie 32.32: (b1 - b0) << 32 i b0 << 32 nie mieszczą się w int32, a błąd
+    // przyrostu po 65535 krokach od a0 poza płótnem zostaje poniżej 1/65536 piksela
+    // W wierszu a pozycja to zawsze b0 + gradient * (a - a0), więc paski i pełna klatka są zgodne
+    const int64_t gradient = a1 == a0 ? 0 : static_cast<int64_t>(static_cast<uint64_t>(static_cast<int64_t>(b1 - b0)) << 32) / (a1 - a0);
+    int64_t pos = static_cast<int64_t>(static_cast<uint64_t>(static_cast<int64_t>(b0)) << 32) + gradient * (first - a0);
+
+    for (int32_t a = first; a <= last; ++a, pos += gradient) {
+        const int32_t b = static_cast<int32_t>(pos >> 32);
+        const uint8_t frac = static_cast<uint8_t>(pos >> 24);
+        if (steep) {
+            plot(b, a, value, 255 - frac);
+            plot(b + 1, a, value, frac);
+        } else {
+            plot(a, b, value, 255 - frac);
+            plot(a, b + 1, value, frac);
         }
     }
 }
 
-} // namespace Graphics
\ No newline at end of file
+template<typename Format>
+void PixelCanvas<Format>::drawRingAA(int16_t cx, int16_t cy, uint16_t outer, uint16_t inner, const RGB& color) {
+    const Storage value = Format::pack(color);
+    const int32_t ro = std::min<int32_t>(outer, 1000);
+    const int32_t ri = std::min<int32_t>(inner, ro);
+
+    const int32_t top = std::max<int32_t>(cy - ro, 0);
+    const int32_t bottom = std::min<int32_t>(cy + ro, height - 1);
+    if (ro == 0 || top > bottom || cx + ro < 0 || cx - ro >= width) return;
+    markDirty(cx - ro, top, cx + ro, bottom);
+
+    // Pokrycie piksela liczone z odległości jego środka: clamp(R + 0.5 - d)
+    // Zakresy |x| w wierszu (w skali 4, bez pierwiastków poza brzegami):
+    //   (holeFull, holeEdge]   brzeg wewnętrzny - częściowo pokryte
+    //   (holeEdge, solid]      w całości pokryte - wypełniane wierszem
+    //   (solid, edge]          brzeg zewnętrzny - częściowo pokryte
+    for (int32_t y = top; y <= bottom; ++y) {
+        const int32_t ry = y - cy;
+        const int32_t ry4 = 4 * ry * ry;
+        const int32_t solid = halfRoot((2 * ro - 1) * (2 * ro - 1) - ry4);
+        const int32_t edge = halfRoot((2 * ro + 1) * (2 * ro + 1) - ry4 - 1);
+        const int32_t holeFull = ri > 0 ? halfRoot((2 * ri - 1) * (2 * ri - 1) - ry4) : -1;
+        const int32_t holeEdge = ri > 0 ? halfRoot((2 * ri + 1) * (2 * ri + 1) - ry4 - 1) : -1;
+
+        if (solid > holeEdge) {
+            if (holeEdge < 0) {
+                fillSpan(cx - solid, cx + solid, y, value);
+            } else {
+                fillSpan(cx - solid, cx - holeEdge - 1, y, value);
+                fillSpan(cx + holeEdge + 1, cx + solid, y, value);
+            }
+        }
+
+        for (int32_t x = holeFull + 1; x <= edge; ++x) {
+            if (x > holeEdge && x <= solid) {
+                x = solid;  // środek wypełniony wyżej
+                continue;
+            }
+            const int32_t d64 = static_cast<int32_t>(isqrt(static_cast<uint32_t>(x * x + ry * ry) << 12));
+            int32_t coverage = edgeCoverage(ro, d64);
+            if (ri > 0) {
+                coverage = std::min(coverage, 64 - edgeCoverage(ri, d64));
+            }
+            if (coverage <= 0) continue;
+
+            const uint8_t alpha = static_cast<uint8_t>((coverage * 255) >> 6);
+            plot(cx + x, y, value, alpha);
+            if (x != 0) plot(cx - x, y, value, alpha);
+        }
+    }
+}
+
+template<typename Format>
+void PixelCanvas<Format>::fillPolygon(const Point* points, uint8_t count, const RGB& color) {
+    // Nadmiarowych wierzchołków nie obcinamy - byłby to inny kształt
+    if (points == nullptr || count < 3 || count > MaxPolygonPoints) return;
+    const Storage value = Format::pack(color);
+
+    // Tablica krawędzi posortowana po pierwszym wierszu; poziome krawędzie pomijane
+    // Wiersze krawędzi to [top, bottom) - reguła "górnej" krawędzi
+    Edge edges[MaxPolygonPoints];
+    uint8_t edgeCount = 0;
+    int32_t first = height;
+    int32_t last = 0;
+    for (uint8_t i = 0; i < count; ++i) {
+        Point a = points[i];
+        Point b = points[(i + 1) % count];
+        if (a.y == b.y) continue;
+        if (a.y > b.y) std::swap(a, b);
+
+        const int32_t top = std::max<int32_t>(a.y, 0);
+        const int32_t bottom = std::min<int32_t>(b.y, height);
+        if (top >= bottom) continue;
+
+        // Punkt startowy liczony dokładnie od wierzchołka, także gdy krawędź jest obcięta
+        const int32_t dx = b.x - a.x;
+        const int32_t dy = b.y - a.y;
+        const int64_t slope = static_cast<int64_t>(dx) * 65536;
+        const int64_t offset = slope * (top - a.y);
+        Edge edge;
+        edge.x = a.x * 65536 + static_cast<int32_t>(offset >= 0 ? offset / dy : -((-offset + dy - 1) / dy));
+        edge.step = static_cast<int32_t>(slope >= 0 ? slope / dy : -((-slope + dy - 1) / dy));
+        edge.top = top;
+        edge.bottom = bottom;
+
+        uint8_t j = edgeCount++;
+        for (; j > 0 && edges[j - 1].top > edge.top; --j) {
+            edges[j] = edges[j - 1];
+        }
+        edges[j] = edge;
+        first = std::min(first, top);
+        last = std::max(last, bottom);
+    }
+    if (first >= last) return;
+
+    int16_t left = points[0].x;
+    int16_t right = points[0].x;
+    for (uint8_t i = 1; i < count; ++i) {
+        left = std::min(left, points[i].x);
+        right = std::max(right, points[i].x);
+    }
+    markDirty(left, first, right, last - 1);
+
+    Edge* active[MaxPolygonPoints];
+    uint8_t activeCount = 0;
+    uint8_t next = 0;
+    for (int32_t y = first; y < last; ++y) {
+        // Dołącz krawędzie zaczynające się w tym wierszu, usuń zakończone
+        while (next < edgeCount && edges[next].top == y) {
+            active[activeCount++] = &edges[next++];
+        }
+        uint8_t kept = 0;
+        for (uint8_t i = 0; i < activeCount; ++i) {
+            if (active[i]->bottom > y) active[kept++] = active[i];
+        }
+        activeCount = kept;
+
+        // Sortowanie po x (kilka krawędzi - sortowanie przez wstawianie)
+        for (uint8_t i = 1; i < activeCount; ++i) {
+            Edge* edge = active[i];
+            uint8_t j = i;
+            for (; j > 0 && active[j - 1]->x > edge->x; --j) {
+                active[j] = active[j - 1];
+            }
+            active[j] = edge;
+        }
+
+        // Reguła lewej krawędzi: piksele od ceil(xl) do ceil(xr) - 1
+        for (uint8_t i = 0; i + 1 < activeCount; i += 2) {
+            const int32_t left = (active[i]->x + 0xFFFF) >> 16;
+            const int32_t right = ((active[i + 1]->x + 0xFFFF) >> 16) - 1;
+            fillSpan(left, right, y, value);
+        }
+
+        for (uint8_t i = 0; i < activeCount; ++i) {
+            active[i]->x += active[i]->step;
+        }
+    }
+}
+
+template<typename Format>
+void PixelCanvas<Format>::drawText(int16_t x, int16_t y, const char* text, const sFONT& font, const RGB& color) {
+    if (text == nullptr || font.table == nullptr) return;
+    const Storage value = Format::pack(color);
+
+    // Znaki zapisane wiersz po wierszu, bit 7 pierwszego bajtu to lewa kolumna
+    const uint16_t rowBytes = (font.Width + 7) / 8;
+    const uint32_t glyphBytes = static_cast<uint32_t>(rowBytes) * font.Height;
+    const int32_t first = std::max<int32_t>(0, -y);
+    const int32_t last = std::min<int32_t>(font.Height, height - y);
+
+    int32_t cx = x;
+    for (; *text != '\0' && cx < width; ++text, cx += font.Width) {
+        const char c = *text;
+        if (c < ' ' || c > '~' || cx + font.Width <= 0) continue;
+
+        const uint8_t* glyph = font.table + (c - ' ') * glyphBytes;
+        for (int32_t row = first; row < last; ++row) {
+            // Ciągłe serie zapalonych bitów jako wiersze
+            const uint8_t* bits = glyph + row * rowBytes;
+            int32_t col = 0;
+            while (col < font.Width) {
+                if (!(bits[col >> 3] & (0x80 >> (col & 7)))) {
+                    ++col;
+                    continue;
+                }
+                const int32_t start = col;
+                while (col < font.Width && (bits[col >> 3] & (0x80 >> (col & 7)))) ++col;
+                fillSpan(cx + start, cx + col - 1, y + row, value);
+            }
+        }
+    }
+    if (first < last && cx > x) markDirty(x, y + first, cx - 1, y + last - 1);
+}
+
+template<typename Format>
+void PixelCanvas<Format>::drawImage(const PackedImage& image, int16_t x, int16_t y) {
+    int32_t cx = x, cy = y, w = image.width, h = image.height;
+    if (!clipRect(cx, cy, w, h)) return;
+
+    // Wiersze dekodowane prosto do płótna, bez bufora pośredniego
+    for (int32_t row = cy; row < cy + h; ++row) {
+        decodeRow<Format>(image, row - y, cx - x, w, pixels + row * width + cx);
+    }
+    markDirty(cx, cy, cx + w - 1, cy + h - 1);
+}
+
+template<typename Format>
+bool PixelCanvas<Format>::clipBlit(const Rect& srcRect, uint16_t srcWidth, uint16_t srcHeight, int16_t x, int16_t y, BlitArea& area) {
+    // Najpierw do obrazu źródłowego - przesunięcie przenosi się na cel
+    int32_t sx = srcRect.x0, sy = srcRect.y0;
+    int32_t w = srcRect.x1 - srcRect.x0 + 1, h = srcRect.y1 - srcRect.y0 + 1;
+    int32_t dx = x, dy = y;
+    if (sx < 0) { w += sx; dx -= sx; sx = 0; }
+    if (sy < 0) { h += sy; dy -= sy; sy = 0; }
+    w = std::min<int32_t>(w, srcWidth - sx);
+    h = std::min<int32_t>(h, srcHeight - sy);
+
+    // Potem do płótna - przesunięcie przenosi się na źródło
+    if (dx < 0) { w += dx; sx -= dx; dx = 0; }
+    if (dy < 0) { h += dy; sy -= dy; dy = 0; }
+    w = std::min<int32_t>(w, width - dx);
+    h = std::min<int32_t>(h, height - dy);
+    if (w <= 0 || h <= 0) return false;
+
+    area = BlitArea{static_cast<uint16_t>(sx), static_cast<uint16_t>(sy), static_cast<uint16_t>(dx), static_cast<uint16_t>(dy),
+                    static_cast<uint16_t>(w), static_cast<uint16_t>(h)};
+    return true;
+}
+
+template<typename Format>
+template<bool Precise>
+void PixelCanvas<Format>::blendClipped(uint16_t x, uint16_t y, uint16_t w, uint16_t h, Storage value, uint8_t alpha) {
+    Storage* row = pixels + static_cast<size_t>(y) * width + x;
+    for (; h > 0; --h, row += width) {
+        for (uint16_t i = 0; i < w; ++i) {
+            row[i] = Format::template blend<Precise>(row[i], value, alpha);
+        }
+    }
+}
+
+template<typename Format>
+void PixelCanvas<Format>::blendRect(int16_t x, int16_t y, int16_t w, int16_t h, const RGB& color, uint8_t alpha, AlphaPrecision precision) {
+    if (alpha == 0) return;
+    if (alpha == 255) {
+        fillRect(x, y, w, h, color);
+        return;
+    }
+
+    int32_t cx = x, cy = y, cw = w, ch = h;
+    if (!clipRect(cx, cy, cw, ch)) return;
+    if (precision == AlphaPrecision::Precise) {
+        blendClipped<true>(cx, cy, cw, ch, Format::pack(color), alpha);
+    } else {
+        blendClipped<false>(cx, cy, cw, ch, Format::pack(color), alpha);
+    }
+    markDirty(cx, cy, cx + cw - 1, cy + ch - 1);
+}
+
+template<typename Format>
+template<bool Precise>
+void PixelCanvas<Format>::compositeClipped(const PixelCanvas& layer, const uint8_t* alpha, uint16_t srcX, uint16_t srcY,
+                                           uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t opacity) {
+    const Storage black = Storage();
+    for (uint16_t r = 0; r < h; ++r) {
+        const size_t srcOffset = static_cast<size_t>(srcY + r) * layer.width + srcX;
+        const Storage* src = layer.pixels + srcOffset;
+        const uint8_t* srcAlpha = alpha ? alpha + srcOffset : nullptr;
+        Storage* dst = pixels + static_cast<size_t>(y + r) * width + x;
+
+        for (uint16_t i = 0; i < w; ++i) {
+            uint32_t a = srcAlpha ? srcAlpha[i] : 255;
+            Storage s = src[i];
+            if (opacity != 255) {
+                a = (a * (opacity + 1)) >> 8;
+                s = Format::template blend<Precise>(black, s, opacity);
+            }
+
+            // dst = src + dst * (1 - a); przezroczysty piksel ma też czarny kolor
+            if (a == 0) continue;
+            if (a == 255) {
+                dst[i] = s;
+            } else {
+                dst[i] = Format::add(s, Format::template blend<Precise>(dst[i], black, static_cast<uint8_t>(a)));
+            }
+        }
+    }
+}
+
+template<typename Format>
+void PixelCanvas<Format>::compositeLayer(const PixelCanvas& layer, const uint8_t* alpha, int16_t x, int16_t y, uint8_t opacity,
+                                         AlphaPrecision precision) {
+    if (opacity == 0 || &layer == this) return;
+
+    int32_t cx = x, cy = y, cw = layer.width, ch = layer.height;
+    if (!clipRect(cx, cy, cw, ch)) return;
+    const uint16_t srcX = cx - x;
+    const uint16_t srcY = cy - y;
+
+    if (precision == AlphaPrecision::Precise) {
+        compositeClipped<true>(layer, alpha, srcX, srcY, cx, cy, cw, ch, opacity);
+    } else {
+        compositeClipped<false>(layer, alpha, srcX, srcY, cx, cy, cw, ch, opacity);
+    }
+    markDirty(cx, cy, cx + cw - 1, cy + ch - 1);
+}
+
+template class PixelCanvas<Rgb444>;
+template class PixelCanvas<Rgb565>;
+template class PixelCanvas<Rgb666>;
+
+// Implementacja metod Canvas
+Canvas::Variant Canvas::create(uint16_t w, uint16_t h, ColorDepth depth, void* buffer) {
+    switch(depth) {
+        case ColorDepth::RGB444: return Variant(std::in_place_type<PixelCanvas<Rgb444>>, w, h, static_cast<Rgb444::Storage*>(buffer));
+        case ColorDepth::RGB666: return Variant(std::in_place_type<PixelCanvas<Rgb666>>, w, h, static_cast<Rgb666::Storage*>(buffer));
+        case ColorDepth::RGB565:
+        default: return Variant(std::in_place_type<PixelCanvas<Rgb565>>, w, h, static_cast<Rgb565::Storage*>(buffer));
+    }
+}
+
+size_t Canvas::bufferSize(uint16_t w, uint16_t h, ColorDepth depth) {
+    const size_t pixels = static_cast<size_t>(w) * h;
+    switch(depth) {
+        case ColorDepth::RGB444: return pixels * sizeof(Rgb444::Storage);
+        case ColorDepth::RGB666: return pixels * sizeof(Rgb666::Storage);
+        case ColorDepth::RGB565:
+        default: return pixels * sizeof(Rgb565::Storage);
+    }
+}
+
+Canvas::Canvas(uint16_t w, uint16_t h, ColorDepth depth, void* buffer)
+    : canvas(create(w, h, depth, buffer)) {
+}
+
+Canvas::Canvas(uint16_t w, uint16_t h, ColorDepth depth, Arena& arena)
+    : canvas(create(w, h, depth, arena.allocate(bufferSize(w, h, depth), 4))) {
+}
+
+Canvas::~Canvas() = default;
+
+bool Canvas::valid() const {
+    return std::visit([](const auto& c) { return c.valid(); }, canvas);
+}
+
+uint16_t Canvas::getWidth() const {
+    return std::visit([](const auto& c) { return c.getWidth(); }, canvas);
+}
+
+uint16_t Canvas::getHeight() const {
+    return std::visit([](const auto& c) { return c.getHeight(); }, canvas);
+}
+
+ColorDepth Canvas::getColorDepth() const {
+    return std::visit([](const auto& c) { return c.getColorDepth(); }, canvas);
+}
+
+const uint8_t* Canvas::getBuffer() const {
+    return std::visit([](const auto& c) { return c.getBuffer(); }, canvas);
+}
+
+size_t Canvas::getBufferSize() const {
+    return std::visit([](const auto& c) { return c.getBufferSize(); }, canvas);
+}
+
+const DirtyRegion& Canvas::getDirty() const {
+    return std::visit([](const auto& c) -> const DirtyRegion& { return c.getDirty(); }, canvas);
+}
+
+void Canvas::clearDirty() {
+    std::visit([](auto& c) { c.clearDirty(); }, canvas);
+}
+
+void Canvas::clear(const RGB& color) {
+    std::visit([&](auto& c) { c.clear(color); }, canvas);
+}
+
+void Canvas::drawPixel(uint16_t x, uint16_t y, const RGB& color) {
+    std::visit([&](auto& c) { c.drawPixel(x, y, color); }, canvas);
+}
+
+RGB Canvas::getPixel(uint16_t x, uint16_t y) const {
+    return std::visit([&](const auto& c) { return c.getPixel(x, y); }, canvas);
+}
+
+void Canvas::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, const RGB& color) {
+    std::visit([&](auto& c) { c.fillRect(x, y, w, h, color); }, canvas);
+}
+
+void Canvas::hLine(int16_t x, int16_t y, int16_t w, const RGB& color) {
+    std::visit([&](auto& c) { c.hLine(x, y, w, color); }, canvas);
+}
+
+void Canvas::vLine(int16_t x, int16_t y, int16_t h, const RGB& color) {
+    std::visit([&](auto& c) { c.vLine(x, y, h, color); }, canvas);
+}
+
+void Canvas::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const RGB& color, uint8_t thickness, LineCap cap) {
+    std::visit([&](auto& c) { c.drawLine(x0, y0, x1, y1, color, thickness, cap); }, canvas);
+}
+
+void Canvas::drawLineAA(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const RGB& color) {
+    std::visit([&](auto& c) { c.drawLineAA(x0, y0, x1, y1, color); }, canvas);
+}
+
+void Canvas::drawRingAA(int16_t cx, int16_t cy, uint16_t outer, uint16_t inner, const RGB& color) {
+    std::visit([&](auto& c) { c.drawRingAA(cx, cy, outer, inner, color); }, canvas);
+}
+
+void Canvas::fillCircleAA(int16_t cx, int16_t cy, uint16_t r, const RGB& color) {
+    std::visit([&](auto& c) { c.fillCircleAA(cx, cy, r, color); }, canvas);
+}
+
+void Canvas::drawCircleAA(int16_t cx, int16_t cy, uint16_t r, const RGB& color, uint8_t thickness) {
+    std::visit([&](auto& c) { c.drawCircleAA(cx, cy, r, color, thickness); }, canvas);
+}
+
+void Canvas::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, const RGB& color) {
+    std::visit([&](auto& c) { c.fillTriangle(x0, y0, x1, y1, x2, y2, color); }, canvas);
+}
+
+void Canvas::fillPolygon(const Point* points, uint8_t count, const RGB& color) {
+    std::visit([&](auto& c) { c.fillPolygon(points, count, color); }, canvas);
+}
+
+void Canvas::drawText(int16_t x, int16_t y, const char* text, const sFONT& font, const RGB& color) {
+    std::visit([&](auto& c) { c.drawText(x, y, text, font, color); }, canvas);
+}
+
+void Canvas::drawImage(const PackedImage& image, int16_t x, int16_t y) {
+    std::visit([&](auto& c) { c.drawImage(image, x, y); }, canvas);
+}
+
+void Canvas::blendPixel(int16_t x, int16_t y, const RGB& color, uint8_t alpha, AlphaPrecision precision) {
+    std::visit([&](auto& c) { c.blendPixel(x, y, color, alpha, precision); }, canvas);
+}
+
+void Canvas::blendSpan(int16_t x, int16_t y, int16_t w, const RGB& color, uint8_t alpha, AlphaPrecision precision) {
+    std::visit([&](auto& c) { c.blendSpan(x, y, w, color, alpha, precision); }, canvas);
+}
+
+void Canvas::blendRect(int16_t x, int16_t y, int16_t w, int16_t h, const RGB& color, uint8_t alpha, AlphaPrecision precision) {
+    std::visit([&](auto& c) { c.blendRect(x, y, w, h, color, alpha, precision); }, canvas);
+}
+
+void Canvas::compositeLayer(const Canvas& layer, const uint8_t* alpha, int16_t x, int16_t y, uint8_t opacity, AlphaPrecision precision) {
+    std::visit([&](auto& c, const auto& l) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(c)>, std::decay_t<decltype(l)>>) {
+            c.compositeLayer(l, alpha, x, y, opacity, precision);
+        }
+    }, canvas, layer.canvas);
+}
+
+} // namespace Graphics
@@ -1,111 +1,560 @@
 #pragma once
 #include <stdint.h>
+#include <stddef.h>
+#include <string.h>
 #include <algorithm>
-#include <vector>
+#include <type_traits>
+#include <variant>
+
+#include "arena.hpp"
+#include "dirty_region.hpp"
+#include "fonts.h"
+#include "packed_image.hpp"
+#include "pixel_format.hpp"
 
 namespace Graphics {
 
-    /// @brief Definicja głębi kolorów
-    enum class ColorDepth : uint8_t {
-        RGB444, // (12 bitów)
-        RGB565, // (16 bitów), 
-        RGB666  // (18 bitów)
+    /// @brief Ending of thick lines
+    enum class LineCap : uint8_t {
+        Butt,   // line ends exactly at end points
+        Square, // line extended by half of thickness
+        Round   // half circle at both ends
     };
-    
-    /// @brief Struktura reprezentująca kolor RGB
-    struct RGB {
-        uint8_t r;
-        uint8_t g;
-        uint8_t b;
-    
-        RGB() : r(0), g(0), b(0) {}
-        RGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
-    
-        // Konwersja do wartości odpowiadającej głębi kolorów
-        uint8_t toColorDepth(ColorDepth depth) const;
-
-        // Konwersja z wartości odpowiadającej głębi kolorów
-        static RGB fromColorDepth(uint8_t value, ColorDepth depth);
+
+    /// @brief Point on canvas
+    struct Point {
+        int16_t x;
+        int16_t y;
     };
-   
-    /// @brief Klasa obsługująca płótno
-    class Canvas {
+
+    /// @brief Read-only image in given pixel format, e.g. asset in flash or another canvas
+    template<typename Format>
+    struct Image {
+        const typename Format::Storage* pixels;     // pixels row after row
+        uint16_t width;                             // width of image
+        uint16_t height;                            // height of image
+
+        /// @brief Function to get first pixel of row
+        const typename Format::Storage* row(uint16_t y) const { return pixels + static_cast<size_t>(y) * width; }
+    };
+
+    /// @brief Precision of alpha in blending
+    enum class AlphaPrecision : uint8_t {
+        Fast,       // 5 bits on RGB565 (4 on RGB444), all channels in one multiply
+        Precise     // 8 bits, two channels per multiply
+    };
+
+    // Maximum number of polygon points
+    constexpr uint8_t MaxPolygonPoints = 16;
+
+    /// @brief Canvas with pixel format resolved at compile time
+    /// @details Canvas never allocates: pixels live in a buffer owned by the caller
+    ///          (static array, arena, LVGL draw buffer, DMA buffer) and are not cleared
+    /// @tparam Format pixel format traits (Rgb444, Rgb565, Rgb666)
+    template<typename Format>
+    class PixelCanvas {
+    public:
+        using Storage = typename Format::Storage;
+
     private:
         uint16_t width;                 // Canvas width
         uint16_t height;                // Canvas Height
-        ColorDepth colorDepth;          // Canvas color depth
-        std::vector<uint8_t> buffer;    // vector of bytes with pixels
-        
-        /// @brief Function to calculate bytes per pixel based on color depth
-        /// @return number of bytes per pixel
-        uint8_t getBytesPerPixel() const;
-        
-        /// @brief Function to calculate required buffer size
-        /// @return buffer size in bytes
-        size_t calculateBufferSize() const;
-
-        /// @brief Function to set pixel color in buffer
+        Storage* pixels;                // pixels row after row, not owned
+        DirtyRegion dirty;              // area changed since last frame
+
+        /// @brief Function to mark rectangle as changed, clipped to canvas
+        void markDirty(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+            dirty.add(Rect{static_cast<int16_t>(std::max<int32_t>(x0, 0)), static_cast<int16_t>(std::max<int32_t>(y0, 0)),
+                           static_cast<int16_t>(std::min<int32_t>(x1, width - 1)), static_cast<int16_t>(std::min<int32_t>(y1, height - 1))});
+        }
+
+        /// @brief Function to clip rectangle to canvas
+        /// @return false if nothing of rectangle is on canvas
+        bool clipRect(int32_t& x, int32_t& y, int32_t& w, int32_t& h) const;
+
+        /// @brief Function to fill rectangle already clipped to canvas
+        /// @param value packed pixel
+        void fillClipped(uint16_t x, uint16_t y, uint16_t w, uint16_t h, Storage value);
+
+        /// @brief Function to fill horizontal span from x0 to x1 (inclusive), clipped to canvas
+        void fillSpan(int32_t x0, int32_t x1, int32_t y, Storage value);
+
+        /// @brief Function to draw one pixel wide line with Bresenham algorithm
+        void drawThinLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, Storage value);
+
+        /// @brief Part of blit left after clipping
+        struct BlitArea {
+            uint16_t srcX, srcY;    // top left corner in source
+            uint16_t x, y;          // top left corner on canvas
+            uint16_t w, h;          // size
+        };
+
+        /// @brief Function to clip source rectangle to source image and to canvas
+        /// @return false if nothing is left
+        bool clipBlit(const Rect& srcRect, uint16_t srcWidth, uint16_t srcHeight, int16_t x, int16_t y, BlitArea& area);
+
+        /// @brief Function to blend color over already clipped rectangle
+        template<bool Precise>
+        void blendClipped(uint16_t x, uint16_t y, uint16_t w, uint16_t h, Storage value, uint8_t alpha);
+
+        /// @brief Function to composite already clipped part of premultiplied layer
+        template<bool Precise>
+        void compositeClipped(const PixelCanvas& layer, const uint8_t* alpha, uint16_t srcX, uint16_t srcY,
+                              uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t opacity);
+
+        /// @brief Function to blend packed pixel into canvas, clipped to canvas
+        /// @param alpha coverage of pixel, 0 - 255
+        void plot(int32_t x, int32_t y, Storage value, uint8_t alpha) {
+            if (alpha == 0 || x < 0 || x >= width || y < 0 || y >= height) return;
+            Storage& dst = pixels[static_cast<size_t>(y) * width + x];
+            dst = Format::blend(dst, value, alpha);
+        }
+
+    public:
+        /// @brief Contructor of PixelCanvas wrapping existing buffer, without copy
+        /// @param w Width of canvas
+        /// @param h Height of canvas
+        /// @param buffer w * h pixels, must outlive the canvas; nullptr gives empty canvas
+        PixelCanvas(uint16_t w, uint16_t h, Storage* buffer);
+
+        /// @brief Contructor of PixelCanvas with buffer taken from arena
+        /// @param w Width of canvas
+        /// @param h Height of canvas
+        /// @param arena arena to allocate from; empty canvas if it is full
+        PixelCanvas(uint16_t w, uint16_t h, Arena& arena)
+            : PixelCanvas(w, h, arena.allocate<Storage>(static_cast<size_t>(w) * h)) {}
+
+        /// @brief Move constructor, buffer is handed over, other becomes empty
+        PixelCanvas(PixelCanvas&& other) noexcept
+            : width(other.width), height(other.height), pixels(other.pixels), dirty(other.dirty) {
+            other.width = 0;
+            other.height = 0;
+            other.pixels = nullptr;
+            other.dirty.clear();
+        }
+
+        /// @brief Move assignment, buffers are exchanged
+        PixelCanvas& operator=(PixelCanvas&& other) noexcept {
+            swap(other);
+            return *this;
+        }
+
+        // Remove unwanted stuff
+        PixelCanvas(const PixelCanvas&) = delete;
+        PixelCanvas& operator=(const PixelCanvas&) = delete;
+
+        /// @brief Function to exchange buffers of two canvases, e.g. front and back buffer
+        void swap(PixelCanvas& other) noexcept {
+            std::swap(width, other.width);
+            std::swap(height, other.height);
+            std::swap(pixels, other.pixels);
+            std::swap(dirty, other.dirty);
+        }
+
+        /// @brief Function to check if canvas has a buffer
+        /// @return false if canvas is empty
+        bool valid() const { return pixels != nullptr; }
+
+        /// @brief Function to get canvas as read-only image, e.g. as source of blit
+        Image<Format> image() const { return Image<Format>{pixels, width, height}; }
+
+        /// @brief Function to get Width of canvas
+        /// @return width of canvas
+        uint16_t getWidth() const { return width; }
+
+        /// @brief Function to get Height of canvas
+        /// @return height of canvas
+        uint16_t getHeight() const { return height; }
+
+        /// @brief Function to get color depth of canvas
+        /// @return color depth of canvas
+        static constexpr ColorDepth getColorDepth() { return Format::depth; }
+
+        /// @brief Function to get pointer to pixels of canvas
+        /// @return pixels, row after row
+        Storage* data() { return pixels; }
+        const Storage* data() const { return pixels; }
+
+        /// @brief Function to get pointer to raw buffer of canvas
+        /// @return raw buffer of canvas
+        const uint8_t* getBuffer() const { return reinterpret_cast<const uint8_t*>(pixels); }
+
+        /// @brief Function to get size in bytes
+        /// @return size of raw buffer in bytes
+        size_t getBufferSize() const { return static_cast<size_t>(width) * height * sizeof(Storage); }
+
+        /// @brief Function to get area changed since last clearDirty
+        /// @return set of changed rectangles, whole canvas after construction
+        const DirtyRegion& getDirty() const { return dirty; }
+
+        /// @brief Function to forget changes, called once the frame is sent
+        void clearDirty() { dirty.clear(); }
+
+        /// @brief Function to clear canvas and set it to one color
+        /// @param color color to set
+        void clear(const RGB& color = RGB());
+
+        /// @brief Function to fill rectangle with color, clipped to canvas
+        /// @param x X coordinate of top left corner
+        /// @param y Y coordinate of top left corner
+        /// @param w width of rectangle
+        /// @param h height of rectangle
+        /// @param color fill color
+        void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, const RGB& color);
+
+        /// @brief Function to draw horizontal line, clipped to canvas
+        /// @param x X coordinate of left end
+        /// @param y Y coordinate of line
+        /// @param w length of line
+        /// @param color color of line
+        void hLine(int16_t x, int16_t y, int16_t w, const RGB& color) { fillRect(x, y, w, 1, color); }
+
+        /// @brief Function to draw vertical line, clipped to canvas
+        /// @param x X coordinate of line
+        /// @param y Y coordinate of top end
+        /// @param h length of line
+        /// @param color color of line
+        void vLine(int16_t x, int16_t y, int16_t h, const RGB& color) { fillRect(x, y, 1, h, color); }
+
+        /// @brief Function to store already packed pixel
         /// @param x X coordinate of pixel
         /// @param y Y coordinate of pixel
-        /// @param color color to set
-        void setPixelInBuffer(uint16_t x, uint16_t y, uint8_t color);
+        /// @param value packed pixel
+        void setPixel(uint16_t x, uint16_t y, Storage value) {
+            if (x >= width || y >= height) return;
+            pixels[static_cast<size_t>(y) * width + x] = value;
+            markDirty(x, y, x, y);
+        }
 
-        /// @brief Function to read color of pixel in buffer
+        /// @brief Function to draw single pixel of given color
+        /// @param x X coordinate of pixel
+        /// @param y Y coordinate of pixel
+        /// @param color color of pixel
+        void drawPixel(uint16_t x, uint16_t y, const RGB& color) { setPixel(x, y, Format::pack(color)); }
+
+        /// @brief Function to get color from pixel
         /// @param x X coordinate of pixel
         /// @param y Y coordinate of pixel
         /// @return color of pixel
-        RGB getPixelFromBuffer(uint16_t x, uint16_t y) const;
-    
+        RGB getPixel(uint16_t x, uint16_t y) const {
+            if (x >= width || y >= height) return RGB();
+            return Format::unpack(pixels[static_cast<size_t>(y) * width + x]);
+        }
+
+        /// @brief Function to draw line from point (x0, y0) to (x1, y1) of given thickness and color
+        /// @param x0 X coordinate of starting point
+        /// @param y0 Y coordinate of starting point
+        /// @param x1 X coordinate of finish point
+        /// @param y1 y coordinate of finish point
+        /// @param color color of line
+        /// @param thickness thickness of line in pixels
+        /// @param cap ending of line thicker than one pixel
+        void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const RGB& color, uint8_t thickness = 1, LineCap cap = LineCap::Butt);
+
+        /// @brief Function to draw anti-aliased (Wu) line from point (x0, y0) to (x1, y1)
+        /// @param x0 X coordinate of starting point
+        /// @param y0 Y coordinate of starting point
+        /// @param x1 X coordinate of finish point
+        /// @param y1 y coordinate of finish point
+        /// @param color color of line
+        void drawLineAA(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const RGB& color);
+
+        /// @brief Function to draw anti-aliased ring (filled circle when inner radius is 0)
+        /// @param cx X coordinate of center
+        /// @param cy Y coordinate of center
+        /// @param outer outer radius in pixels, up to 1000
+        /// @param inner inner radius in pixels, below outer
+        /// @param color color of ring
+        void drawRingAA(int16_t cx, int16_t cy, uint16_t outer, uint16_t inner, const RGB& color);
+
+        /// @brief Function to draw anti-aliased filled circle
+        /// @param cx X coordinate of center
+        /// @param cy Y coordinate of center
+        /// @param r radius in pixels, up to 1000
+        /// @param color color of circle
+        void fillCircleAA(int16_t cx, int16_t cy, uint16_t r, const RGB& color) { drawRingAA(cx, cy, r, 0, color); }
+
+        /// @brief Function to draw anti-aliased circle of given thickness
+        /// @param cx X coordinate of center
+        /// @param cy Y coordinate of center
+        /// @param r radius in pixels (middle of outline), up to 1000
+        /// @param color color of circle
+        /// @param thickness thickness of outline in pixels
+        void drawCircleAA(int16_t cx, int16_t cy, uint16_t r, const RGB& color, uint8_t thickness = 1) {
+            const uint16_t outer = r + thickness / 2;
+            drawRingAA(cx, cy, outer, outer > thickness ? outer - thickness : 0, color);
+        }
+
+        /// @brief Function to fill triangle with color (top-left fill rule)
+        /// @param x0 X coordinate of first vertex
+        /// @param y0 Y coordinate of first vertex
+        /// @param x1 X coordinate of second vertex
+        /// @param y1 Y coordinate of second vertex
+        /// @param x2 X coordinate of third vertex
+        /// @param y2 Y coordinate of third vertex
+        /// @param color fill color
+        void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, const RGB& color) {
+            const Point points[3] = {{x0, y0}, {x1, y1}, {x2, y2}};
+            fillPolygon(points, 3, color);
+        }
+
+        /// @brief Function to fill polygon with color (top-left fill rule)
+        /// @param points vertices of polygon, in any winding order
+        /// @param count number of vertices, 3 to MaxPolygonPoints; anything else draws nothing
+        /// @param color fill color
+        /// @note Meant for convex polygons; other simple polygons are filled with even-odd rule
+        void fillPolygon(const Point* points, uint8_t count, const RGB& color);
+
+        /// @brief Function to draw text, background is left untouched
+        /// @param x X coordinate of top left corner
+        /// @param y Y coordinate of top left corner
+        /// @param text ASCII text, characters outside ' ' - '~' are skipped
+        /// @param font font from lib/Fonts
+        /// @param color color of text
+        void drawText(int16_t x, int16_t y, const char* text, const sFONT& font, const RGB& color);
+
+        /// @brief Function to draw packed image, decoding only rows and columns on canvas
+        /// @param image image packed by tools/pack_images.py
+        /// @param x X coordinate of top left corner
+        /// @param y Y coordinate of top left corner
+        void drawImage(const PackedImage& image, int16_t x, int16_t y);
+
+        /// @brief Function to blend color over single pixel
+        /// @param x X coordinate of pixel
+        /// @param y Y coordinate of pixel
+        /// @param color color to blend
+        /// @param alpha opacity of color, 0 - 255
+        /// @param precision precision of alpha
+        void blendPixel(int16_t x, int16_t y, const RGB& color, uint8_t alpha, AlphaPrecision precision = AlphaPrecision::Fast) {
+            blendRect(x, y, 1, 1, color, alpha, precision);
+        }
+
+        /// @brief Function to blend color over horizontal span
+        /// @param x X coordinate of left end
+        /// @param y Y coordinate of span
+        /// @param w length of span
+        /// @param color color to blend
+        /// @param alpha opacity of color, 0 - 255
+        /// @param precision precision of alpha
+        void blendSpan(int16_t x, int16_t y, int16_t w, const RGB& color, uint8_t alpha, AlphaPrecision precision = AlphaPrecision::Fast) {
+            blendRect(x, y, w, 1, color, alpha, precision);
+        }
+
+        /// @brief Function to blend color over rectangle, e.g. to dim a backdrop
+        /// @param x X coordinate of top left corner
+        /// @param y Y coordinate of top left corner
+        /// @param w width of rectangle
+        /// @param h height of rectangle
+        /// @param color color to blend
+        /// @param alpha opacity of color, 0 - 255
+        /// @param precision precision of alpha
+        void blendRect(int16_t x, int16_t y, int16_t w, int16_t h, const RGB& color, uint8_t alpha, AlphaPrecision precision = AlphaPrecision::Fast);
+
+        /// @brief Function to composite layer over canvas (premultiplied "over")
+        /// @param layer layer of the same format, colors premultiplied by their alpha
+        /// @param alpha alpha of every layer pixel, row after row; nullptr for opaque layer
+        /// @param x X coordinate of layer on canvas
+        /// @param y Y coordinate of layer on canvas
+        /// @param opacity opacity of whole layer, 0 - 255
+        /// @param precision precision of alpha
+        void compositeLayer(const PixelCanvas& layer, const uint8_t* alpha, int16_t x, int16_t y, uint8_t opacity = 255,
+                            AlphaPrecision precision = AlphaPrecision::Fast);
+
+        /// @brief Function to copy part of image onto canvas, clipped to both
+        /// @details Same format is copied row by row with memcpy, other formats are converted
+        /// @param src source image
+        /// @param srcRect part of source to copy
+        /// @param x X coordinate of copy on canvas
+        /// @param y Y coordinate of copy on canvas
+        template<typename SrcFormat>
+        void blit(const Image<SrcFormat>& src, const Rect& srcRect, int16_t x, int16_t y) {
+            BlitArea area;
+            if (!clipBlit(srcRect, src.width, src.height, x, y, area)) return;
+            for (uint16_t r = 0; r < area.h; ++r) {
+                const typename SrcFormat::Storage* from = src.row(area.srcY + r) + area.srcX;
+                Storage* to = pixels + static_cast<size_t>(area.y + r) * width + area.x;
+                if constexpr (std::is_same_v<SrcFormat, Format>) {
+                    memcpy(to, from, area.w * sizeof(Storage));
+                } else {
+                    for (uint16_t i = 0; i < area.w; ++i) {
+                        to[i] = Format::pack(SrcFormat::unpack(from[i]));
+                    }
+                }
+            }
+            markDirty(area.x, area.y, area.x + area.w - 1, area.y + area.h - 1);
+        }
+
+        /// @brief Function to copy part of image onto canvas, skipping pixels of key color
+        /// @param src source image
+        /// @param srcRect part of source to copy
+        /// @param x X coordinate of copy on canvas
+        /// @param y Y coordinate of copy on canvas
+        /// @param key transparent color, compared after packing to source format
+        template<typename SrcFormat>
+        void blitKeyed(const Image<SrcFormat>& src, const Rect& srcRect, int16_t x, int16_t y, const RGB& key) {
+            BlitArea area;
+            if (!clipBlit(srcRect, src.width, src.height, x, y, area)) return;
+            const typename SrcFormat::Storage packedKey = SrcFormat::pack(key);
+            for (uint16_t r = 0; r < area.h; ++r) {
+                const typename SrcFormat::Storage* from = src.row(area.srcY + r) + area.srcX;
+                Storage* to = pixels + static_cast<size_t>(area.y + r) * width + area.x;
+                uint16_t i = 0;
+                while (i < area.w) {
+                    // Serie nieprzezroczystych pikseli kopiowane razem
+                    if (from[i] == packedKey) {
+                        ++i;
+                        continue;
+                    }
+                    const uint16_t start = i;
+                    while (i < area.w && from[i] != packedKey) ++i;
+                    if constexpr (std::is_same_v<SrcFormat, Format>) {
+                        memcpy(to + start, from + start, (i - start) * sizeof(Storage));
+                    } else {
+                        for (uint16_t j = start; j < i; ++j) {
+                            to[j] = Format::pack(SrcFormat::unpack(from[j]));
+                        }
+                    }
+                }
+            }
+            markDirty(area.x, area.y, area.x + area.w - 1, area.y + area.h - 1);
+        }
+
+        /// @brief Function to copy part of image onto canvas where 1-bit mask is set
+        /// @param src source image
+        /// @param mask one bit per source pixel, rows of (width + 7) / 8 bytes, bit 7 first
+        /// @param srcRect part of source to copy
+        /// @param x X coordinate of copy on canvas
+        /// @param y Y coordinate of copy on canvas
+        template<typename SrcFormat>
+        void blitMasked(const Image<SrcFormat>& src, const uint8_t* mask, const Rect& srcRect, int16_t x, int16_t y) {
+            BlitArea area;
+            if (mask == nullptr || !clipBlit(srcRect, src.width, src.height, x, y, area)) return;
+            const uint16_t maskStride = (src.width + 7) / 8;
+            for (uint16_t r = 0; r < area.h; ++r) {
+                const typename SrcFormat::Storage* from = src.row(area.srcY + r);
+                const uint8_t* bits = mask + static_cast<size_t>(area.srcY + r) * maskStride;
+                Storage* to = pixels + static_cast<size_t>(area.y + r) * width + area.x - area.srcX;
+                for (uint16_t sx = area.srcX; sx < area.srcX + area.w; ++sx) {
+                    if (bits[sx >> 3] & (0x80 >> (sx & 7))) {
+                        to[sx] = Format::pack(SrcFormat::unpack(from[sx]));
+                    }
+                }
+            }
+            markDirty(area.x, area.y, area.x + area.w - 1, area.y + area.h - 1);
+        }
+    };
+
+    extern template class PixelCanvas<Rgb444>;
+    extern template class PixelCanvas<Rgb565>;
+    extern template class PixelCanvas<Rgb666>;
+
+    /// @brief Klasa obsługująca płótno z głębią kolorów wybieraną w czasie działania
+    /// @note Thin wrapper, every call is dispatched once to the matching PixelCanvas
+    class Canvas {
     public:
-        /// @brief Contructor of Canvas
+        using Variant = std::variant<PixelCanvas<Rgb444>, PixelCanvas<Rgb565>, PixelCanvas<Rgb666>>;
+
+    private:
+        Variant canvas;                 // canvas of selected color depth
+
+        /// @brief Function to create canvas of given color depth
+        static Variant create(uint16_t w, uint16_t h, ColorDepth depth, void* buffer);
+
+    public:
+        /// @brief Function to get size of buffer needed by canvas
+        /// @param w Width of canvas
+        /// @param h Height of canvas
+        /// @param depth color depth to use
+        /// @return size of buffer in bytes
+        static size_t bufferSize(uint16_t w, uint16_t h, ColorDepth depth);
+
+        /// @brief Contructor of Canvas wrapping existing buffer, without copy
+        /// @param w Width of canvas
+        /// @param h Height of canvas
+        /// @param depth color depth to use
+        /// @param buffer bufferSize() bytes, 4-byte aligned, must outlive the canvas
+        Canvas(uint16_t w, uint16_t h, ColorDepth depth, void* buffer);
+
+        /// @brief Contructor of Canvas with buffer taken from arena
         /// @param w Width of canvas
         /// @param h Height of canvas
         /// @param depth color depth to use
-        Canvas(uint16_t w, uint16_t h, ColorDepth depth);
-        
+        /// @param arena arena to allocate from; empty canvas if it is full
+        Canvas(uint16_t w, uint16_t h, ColorDepth depth, Arena& arena);
+
         /// @brief Destructor
         ~Canvas();
-    
-        // Remove unwanted stuff
+
+        // Move only, buffer is handed over
+        Canvas(Canvas&&) noexcept = default;
+        Canvas& operator=(Canvas&&) noexcept = default;
         Canvas(const Canvas&) = delete;
         Canvas& operator=(const Canvas&) = delete;
-    
+
+        /// @brief Function to check if canvas has a buffer
+        /// @return false if canvas is empty
+        bool valid() const;
+
         /// @brief Function to get Width of canvas
         /// @return width of canvas
-        uint16_t getWidth() const { return width; }
-        
+        uint16_t getWidth() const;
+
         /// @brief Function to get Height of canvas
         /// @return height of canvas
-        uint16_t getHeight() const { return height; }
-        
+        uint16_t getHeight() const;
+
         /// @brief Function to get color depth of canvas
         /// @return color depth of canvas
-        ColorDepth getColorDepth() const { return colorDepth; }
-        
+        ColorDepth getColorDepth() const;
+
         /// @brief Function to get pointer to raw buffer of canvas
         /// @return raw buffer of canvas
-        const uint8_t* getBuffer() const { return buffer.data(); }
-        
-        /// @brief Function to get size in bytes 
-        /// @return 
-        uint16_t getBufferSize() const { return buffer.size(); }
-    
+        const uint8_t* getBuffer() const;
+
+        /// @brief Function to get size in bytes
+        /// @return size of raw buffer in bytes
+        size_t getBufferSize() const;
+
+        /// @brief Function to get area changed since last clearDirty
+        /// @return set of changed rectangles, whole canvas after construction
+        const DirtyRegion& getDirty() const;
+
+        /// @brief Function to forget changes, called once the frame is sent
+        void clearDirty();
+
+        /// @brief Function to get typed canvas
+        /// @return canvas of given format or nullptr if color depth differs
+        template<typename Format>
+        PixelCanvas<Format>* as() { return std::get_if<PixelCanvas<Format>>(&canvas); }
+
+        template<typename Format>
+        const PixelCanvas<Format>* as() const { return std::get_if<PixelCanvas<Format>>(&canvas); }
+
         /// @brief Function to clear canvas and set it to one color
-        /// @param color color to set 
+        /// @param color color to set
         void clear(const RGB& color = RGB());
-        
+
         /// @brief Function to draw single pixel of given color
-        /// @param x X coordinate of pixel 
+        /// @param x X coordinate of pixel
         /// @param y Y coordinate of pixel
         /// @param color color of pixel
         void drawPixel(uint16_t x, uint16_t y, const RGB& color);
 
         /// @brief Function to get color from pixel
-        /// @param x X coordinate of pixel 
+        /// @param x X coordinate of pixel
         /// @param y Y coordinate of pixel
         /// @return color of pixel
         RGB getPixel(uint16_t x, uint16_t y) const;
-    
+
+        /// @brief Function to fill rectangle with color, clipped to canvas
+        void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, const RGB& color);
+
+        /// @brief Function to draw horizontal line, clipped to canvas
+        void hLine(int16_t x, int16_t y, int16_t w, const RGB& color);
+
+        /// @brief Function to draw vertical line, clipped to canvas
+        void vLine(int16_t x, int16_t y, int16_t h, const RGB& color);
+
         /// @brief Function to draw line from point (x0, y0) to (x1, y1) of given thickness and color
         /// @param x0 X coordinate of starting point
         /// @param y0 Y coordinate of starting point
@@ -113,8 +562,63 @@ namespace Graphics {
         /// @param y1 y coordinate of finish point
         /// @param color color of line
         /// @param thickness thickness of line in pixels
-        void drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, const RGB& color, uint8_t thickness = 1);
+        /// @param cap ending of line thicker than one pixel
+        void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const RGB& color, uint8_t thickness = 1, LineCap cap = LineCap::Butt);
+
+        /// @brief Function to draw anti-aliased (Wu) line from point (x0, y0) to (x1, y1)
+        void drawLineAA(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const RGB& color);
+
+        /// @brief Function to draw anti-aliased ring (filled circle when inner radius is 0)
+        void drawRingAA(int16_t cx, int16_t cy, uint16_t outer, uint16_t inner, const RGB& color);
+
+        /// @brief Function to draw anti-aliased filled circle
+        void fillCircleAA(int16_t cx, int16_t cy, uint16_t r, const RGB& color);
+
+        /// @brief Function to draw anti-aliased circle of given thickness
+        void drawCircleAA(int16_t cx, int16_t cy, uint16_t r, const RGB& color, uint8_t thickness = 1);
+
+        /// @brief Function to fill triangle with color (top-left fill rule)
+        void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, const RGB& color);
+
+        /// @brief Function to fill polygon with color (top-left fill rule)
+        void fillPolygon(const Point* points, uint8_t count, const RGB& color);
+
+        /// @brief Function to draw text, background is left untouched
+        void drawText(int16_t x, int16_t y, const char* text, const sFONT& font, const RGB& color);
+
+        /// @brief Function to draw packed image, decoding only rows and columns on canvas
+        void drawImage(const PackedImage& image, int16_t x, int16_t y);
+
+        /// @brief Function to blend color over single pixel
+        void blendPixel(int16_t x, int16_t y, const RGB& color, uint8_t alpha, AlphaPrecision precision = AlphaPrecision::Fast);
+
+        /// @brief Function to blend color over horizontal span
+        void blendSpan(int16_t x, int16_t y, int16_t w, const RGB& color, uint8_t alpha, AlphaPrecision precision = AlphaPrecision::Fast);
+
+        /// @brief Function to blend color over rectangle, e.g. to dim a backdrop
+        void blendRect(int16_t x, int16_t y, int16_t w, int16_t h, const RGB& color, uint8_t alpha, AlphaPrecision precision = AlphaPrecision::Fast);
+
+        /// @brief Function to composite layer over canvas (premultiplied "over")
+        /// @note Layer of other color depth than canvas is ignored
+        void compositeLayer(const Canvas& layer, const uint8_t* alpha, int16_t x, int16_t y, uint8_t opacity = 255,
+                            AlphaPrecision precision = AlphaPrecision::Fast);
+
+        /// @brief Function to copy part of image onto canvas, clipped to both
+        template<typename SrcFormat>
+        void blit(const Image<SrcFormat>& src, const Rect& srcRect, int16_t x, int16_t y) {
+            std::visit([&](auto& c) { c.blit(src, srcRect, x, y); }, canvas);
+        }
+
+        /// @brief Function to copy part of image onto canvas, skipping pixels of key color
+        template<typename SrcFormat>
+        void blitKeyed(const Image<SrcFormat>& src, const Rect& srcRect, int16_t x, int16_t y, const RGB& key) {
+            std::visit([&](auto& c) { c.blitKeyed(src, srcRect, x, y, key); }, canvas);
+        }
 
-        
+        /// @brief Function to copy part of image onto canvas where 1-bit mask is set
+        template<typename SrcFormat>
+        void blitMasked(const Image<SrcFormat>& src, const uint8_t* mask, const Rect& srcRect, int16_t x, int16_t y) {
+            std::visit([&](auto& c) { c.blitMasked(src, mask, srcRect, x, y); }, canvas);
+        }
     };
-} // namespace Graphics
\ No newline at end of file
+} // namespace Graphics
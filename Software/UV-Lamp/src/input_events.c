@@ -0,0 +1,196 @@
+#include "input_events.h"
+
+// Stany przycisku
+enum {
+    BUTTON_UP,              // zwolniony
+    BUTTON_DOWN,            // wciśnięty, przed czasem long press
+    BUTTON_LONG,            // long press zgłoszony, czeka na zwolnienie
+    BUTTON_NUM_STATES
+};
+
+// Wejścia automatu przycisku
+enum {
+    BUTTON_PRESS,           // krawędź opadająca po debounce
+    BUTTON_RELEASE,         // krawędź narastająca po debounce
+    BUTTON_LONG_TIMEOUT,    // minął czas long press
+    BUTTON_NUM_INPUTS
+};
+
+#define ACTION_NONE 0xFF
+
+static const struct {
+    uint8_t next;
+    uint8_t action;
+} button_table[BUTTON_NUM_STATES][BUTTON_NUM_INPUTS] = {
+    //                PRESS                          RELEASE                            LONG_TIMEOUT
+    [BUTTON_UP]   = {{BUTTON_DOWN, ACTION_NONE},   {BUTTON_UP, ACTION_NONE},          {BUTTON_UP, ACTION_NONE}},
+    [BUTTON_DOWN] = {{BUTTON_DOWN, ACTION_NONE},   {BUTTON_UP, INPUT_SHORT_PRESS},    {BUTTON_LONG, INPUT_LONG_PRESS}},
+    [BUTTON_LONG] = {{BUTTON_LONG, ACTION_NONE},   {BUTTON_UP, ACTION_NONE},          {BUTTON_LONG, ACTION_NONE}},
+};
+
+// Kroki enkodera dla (poprzedni stan << 2) | nowy stan, kod Graya 00 -> 01 -> 11 -> 10
+static const int8_t quadrature_table[16] = {
+    0, +1, -1, 0,
+    -1, 0, 0, +1,
+    +1, 0, 0, -1,
+    0, -1, +1, 0,
+};
+
+// a nie później niż b, odporne na przepełnienie licznika
+static bool time_reached(uint32_t a, uint32_t b)
+{
+    return (int32_t)(b - a) >= 0;
+}
+
+void input_decoder_init(input_decoder_t *d, uint8_t enc_a_pin, uint8_t enc_b_pin, uint8_t enc_state,
+                        const uint8_t button_pins[INPUT_NUM_BUTTONS], uint32_t debounce_us, uint32_t long_press_us)
+{
+    d->enc_a_pin = enc_a_pin;
+    d->enc_b_pin = enc_b_pin;
+    d->enc_state = enc_state & 3;
+    d->debounce_us = debounce_us;
+    d->long_press_us = long_press_us;
+
+    for (int i = 0; i < INPUT_NUM_BUTTONS; i++) {
+        input_button_t *b = &d->buttons[i];
+        b->pin = button_pins[i];
+        b->state = BUTTON_UP;
+        b->raw_pressed = false;
+        b->stable_pressed = false;
+        b->settled = true;
+        b->edge_us = 0;
+        b->press_us = 0;
+    }
+}
+
+// ========================================
+// PRZYCISKI
+// ========================================
+static void button_input(input_button_t *b, uint8_t index, uint8_t input, uint32_t time_us, input_action_fn fn, void *ctx)
+{
+    if (input == BUTTON_PRESS && b->state == BUTTON_UP) {
+        b->press_us = time_us;
+    }
+
+    const uint8_t action = button_table[b->state][input].action;
+    b->state = button_table[b->state][input].next;
+
+    if (action != ACTION_NONE) {
+        const input_action_t a = {action, index, 0, time_us};
+        fn(&a, ctx);
+    }
+}
+
+// Zaakceptowana zmiana poziomu otwiera okno debounce
+static void button_accept(input_button_t *b, uint8_t index, uint32_t time_us, input_action_fn fn, void *ctx)
+{
+    b->stable_pressed = b->raw_pressed;
+    b->settled = false;
+    b->edge_us = time_us;
+    button_input(b, index, b->stable_pressed ? BUTTON_PRESS : BUTTON_RELEASE, time_us, fn, ctx);
+}
+
+// Najbliższy termin przycisku: koniec okna debounce albo long press
+static bool button_deadline(const input_decoder_t *d, const input_button_t *b, uint32_t *at_us, bool *debounce)
+{
+    bool found = false;
+    if (!b->settled) {
+        *at_us = b->edge_us + d->debounce_us;
+        *debounce = true;
+        found = true;
+    }
+    if (b->state == BUTTON_DOWN) {
+        const uint32_t long_us = b->press_us + d->long_press_us;
+        if (!found || !time_reached(*at_us, long_us)) {
+            *at_us = long_us;
+            *debounce = false;
+            found = true;
+        }
+    }
+    return found;
+}
+
+bool input_decoder_deadline(const input_decoder_t *d, uint32_t *at_us)
+{
+    bool found = false;
+    for (int i = 0; i < INPUT_NUM_BUTTONS; i++) {
+        uint32_t at;
+        bool debounce;
+        if (button_deadline(d, &d->buttons[i], &at, &debounce) && (!found || !time_reached(*at_us, at))) {
+            *at_us = at;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void input_decoder_poll(input_decoder_t *d, uint32_t now_us, input_action_fn fn, void *ctx)
+{
+    // Terminy w kolejności czasu; każdy zmienia stan, więc liczba obiegów jest ograniczona
+    for (;;) {
+        int first = -1;
+        uint32_t first_us = 0;
+        bool first_debounce = false;
+
+        for (int i = 0; i < INPUT_NUM_BUTTONS; i++) {
+            uint32_t at;
+            bool debounce;
+            if (button_deadline(d, &d->buttons[i], &at, &debounce) && time_reached(at, now_us) &&
+                (first < 0 || !time_reached(first_us, at))) {
+                first = i;
+                first_us = at;
+                first_debounce = debounce;
+            }
+        }
+        if (first < 0) {
+            return;
+        }
+
+        input_button_t *b = &d->buttons[first];
+        if (first_debounce) {
+            // Koniec okna; poziom zmieniony w oknie przyjęty teraz
+            b->settled = true;
+            if (b->raw_pressed != b->stable_pressed) {
+                button_accept(b, first, first_us, fn, ctx);
+            }
+        } else {
+            button_input(b, first, BUTTON_LONG_TIMEOUT, first_us, fn, ctx);
+        }
+    }
+}
+
+// ========================================
+// ZDARZENIA
+// ========================================
+void input_decoder_event(input_decoder_t *d, const input_event_t *event, input_action_fn fn, void *ctx)
+{
+    // Najpierw terminy sprzed zdarzenia, np. long press przed spóźnionym zwolnieniem
+    input_decoder_poll(d, event->time_us, fn, ctx);
+
+    if (event->pin == d->enc_a_pin || event->pin == d->enc_b_pin) {
+        const uint8_t bit = event->pin == d->enc_a_pin ? 2 : 1;
+        const uint8_t state = event->level ? (d->enc_state | bit) : (d->enc_state & ~bit);
+        const int8_t steps = quadrature_table[(d->enc_state << 2) | state];
+        d->enc_state = state;
+
+        if (steps != 0) {
+            const input_action_t a = {INPUT_TURN, 0, steps, event->time_us};
+            fn(&a, ctx);
+        }
+        return;
+    }
+
+    for (int i = 0; i < INPUT_NUM_BUTTONS; i++) {
+        input_button_t *b = &d->buttons[i];
+        if (event->pin != b->pin) continue;
+
+        // Przyciski aktywne niskim poziomem
+        b->raw_pressed = !event->level;
+
+        // W oknie debounce tylko zapamiętany poziom, przyjęty po zamknięciu okna
+        if (b->settled && b->raw_pressed != b->stable_pressed) {
+            button_accept(b, i, event->time_us, fn, ctx);
+        }
+        return;
+    }
+}
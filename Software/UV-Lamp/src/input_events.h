@@ -0,0 +1,81 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// Plain C so main.c can use it; the GPIO interrupt records edges, the main loop decodes them
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define INPUT_NUM_BUTTONS 2
+
+/// @brief One GPIO interrupt, as recorded by the handler
+typedef struct {
+    uint32_t time_us;       // time_us_32() in the handler
+    uint8_t pin;            // GPIO number
+    uint8_t edges;          // GPIO_IRQ_EDGE_* bits latched since last interrupt
+    uint8_t level;          // pin level read in the handler, after the edges
+} input_event_t;
+
+/// @brief What the decoder found in the events
+typedef enum {
+    INPUT_TURN,             // encoder moved, steps is +1 or -1
+    INPUT_SHORT_PRESS,      // button released before long press time
+    INPUT_LONG_PRESS        // button held for long press time, release then gives nothing
+} input_action_kind_t;
+
+typedef struct {
+    uint8_t kind;           // input_action_kind_t
+    uint8_t button;         // index of button pin given to init
+    int8_t steps;           // encoder steps for INPUT_TURN
+    uint32_t time_us;       // time of edge or deadline that caused it
+} input_action_t;
+
+typedef void (*input_action_fn)(const input_action_t *action, void *ctx);
+
+/// @brief State of one debounced button
+typedef struct {
+    uint8_t pin;
+    uint8_t state;          // state of press state machine
+    bool raw_pressed;       // last level seen in events
+    bool stable_pressed;    // level accepted by debounce
+    bool settled;           // debounce window of last accepted edge is over
+    uint32_t edge_us;       // last accepted edge, start of debounce window
+    uint32_t press_us;      // start of current press
+} input_button_t;
+
+/// @brief Quadrature encoder and active low buttons decoded from event times
+/// @details Every event costs a few table lookups. Edges inside the debounce
+///          window after an accepted edge only update the raw level, which is
+///          accepted when the window closes. Times are compared as differences,
+///          so time_us_32() wrapping every 71 minutes does no harm
+typedef struct {
+    uint8_t enc_a_pin;
+    uint8_t enc_b_pin;
+    uint8_t enc_state;      // A << 1 | B
+    uint32_t debounce_us;
+    uint32_t long_press_us;
+    input_button_t buttons[INPUT_NUM_BUTTONS];
+} input_decoder_t;
+
+/// @brief Function to prepare decoder
+/// @param enc_state encoder levels at start, A << 1 | B
+/// @param button_pins pins of buttons, released at start
+void input_decoder_init(input_decoder_t *d, uint8_t enc_a_pin, uint8_t enc_b_pin, uint8_t enc_state,
+                        const uint8_t button_pins[INPUT_NUM_BUTTONS], uint32_t debounce_us, uint32_t long_press_us);
+
+/// @brief Function to decode one event, deadlines before it are handled first
+/// @param fn called for every action, in time order
+void input_decoder_event(input_decoder_t *d, const input_event_t *event, input_action_fn fn, void *ctx);
+
+/// @brief Function to handle deadlines (debounce end, long press) up to now
+void input_decoder_poll(input_decoder_t *d, uint32_t now_us, input_action_fn fn, void *ctx);
+
+/// @brief Function to get nearest deadline
+/// @return false if nothing will happen without new events
+bool input_decoder_deadline(const input_decoder_t *d, uint32_t *at_us);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,93 @@
+#include "packed_image.hpp"
+
+#include <algorithm>
+
+namespace Graphics {
+
+namespace {
+
+enum : uint8_t {
+    OpIndex = 0x00,
+    OpDiff = 0x40,
+    OpLuma = 0x80,
+    OpRun = 0xC0,
+    OpPixel = 0xFE
+};
+
+inline uint8_t pixelHash(uint16_t pixel) {
+    return ((pixel >> 11) * 3 + ((pixel >> 5) & 0x3F) * 5 + (pixel & 0x1F) * 7) & 0x3F;
+}
+
+// Piksel natywny RGB565 w formacie wyjścia
+template<typename Format>
+inline typename Format::Storage toFormat(uint16_t pixel) {
+    if constexpr (Format::depth == ColorDepth::RGB565) {
+        return Rgb565::toStorage(pixel);
+    } else {
+        return Format::pack(Rgb565::decode(pixel));
+    }
+}
+
+} // namespace
+
+template<typename Format>
+void decodeRow(const PackedImage& image, uint16_t row, uint16_t skip, uint16_t count, typename Format::Storage* out) {
+    if (row >= image.height || skip >= image.width) return;
+    count = std::min<uint16_t>(count, image.width - skip);
+
+    const uint8_t* in = image.data + image.rows[row];
+    uint16_t index[64] = {};
+    uint16_t pixel = 0;
+    typename Format::Storage value = toFormat<Format>(pixel);
+
+    // Pozycja w wierszu liczona względem pierwszego zapisywanego piksela
+    int32_t position = -static_cast<int32_t>(skip);
+    while (position < count) {
+        const uint8_t op = *in++;
+        if (op >= OpRun && op != OpPixel) {
+            const int32_t end = std::min<int32_t>(position + (op & 0x3F) + 1, count);
+            if (end > 0) {
+                const int32_t start = std::max<int32_t>(position, 0);
+                Format::fill(out + start, end - start, value);
+            }
+            position = end;
+            continue;
+        }
+
+        if (op < OpDiff) {
+            pixel = index[op];
+        } else {
+            if (op == OpPixel) {
+                pixel = static_cast<uint16_t>((in[0] << 8) | in[1]);
+                in += 2;
+            } else {
+                int32_t dr, dg, db;
+                if (op < OpLuma) {
+                    dr = ((op >> 4) & 3) - 2;
+                    dg = ((op >> 2) & 3) - 2;
+                    db = (op & 3) - 2;
+                } else {
+                    dg = (op & 0x3F) - 32;
+                    dr = (dg >> 1) + (*in >> 4) - 8;
+                    db = (dg >> 1) + (*in & 0x0F) - 8;
+                    ++in;
+                }
+                // Kanały zawijają się modulo swoja szerokość
+                pixel = static_cast<uint16_t>(((((pixel >> 11) + dr) & 0x1F) << 11) |
+                                              (((((pixel >> 5) & 0x3F) + dg) & 0x3F) << 5) |
+                                              (((pixel & 0x1F) + db) & 0x1F));
+            }
+            index[pixelHash(pixel)] = pixel;
+        }
+
+        value = toFormat<Format>(pixel);
+        if (position >= 0) out[position] = value;
+        ++position;
+    }
+}
+
+template void decodeRow<Rgb444>(const PackedImage&, uint16_t, uint16_t, uint16_t, Rgb444::Storage*);
+template void decodeRow<Rgb565>(const PackedImage&, uint16_t, uint16_t, uint16_t, Rgb565::Storage*);
+template void decodeRow<Rgb666>(const PackedImage&, uint16_t, uint16_t, uint16_t, Rgb666::Storage*);
+
+} // namespace Graphics
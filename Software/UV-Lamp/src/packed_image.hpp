@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#include "pixel_format.hpp"
+
+namespace Graphics {
+
+    /// @brief RGB565 image packed by tools/pack_images.py, decoded row by row
+    /// @details Every row starts from black and an empty 64-entry index, so decoding
+    ///          can begin at any row. Ops of row stream:
+    ///          - 00iiiiii           pixel from index
+    ///          - 01rrggbb           channel deltas -2..1 from previous pixel
+    ///          - 10gggggg rrrrbbbb  green delta -32..31, red and blue relative to half of it
+    ///          - 11nnnnnn           run of 1..62 previous pixels
+    ///          - 11111110 hi lo     native RGB565 pixel
+    struct PackedImage {
+        uint16_t width;         // width of image
+        uint16_t height;        // height of image
+        const uint32_t* rows;   // offset of every row in data, height + 1 entries
+        const uint8_t* data;    // packed rows
+
+        /// @brief Function to get size of packed image in flash
+        size_t getPackedSize() const { return rows[height] + (height + 1) * sizeof(uint32_t); }
+    };
+
+    /// @brief Function to decode part of one row, without touching pixels outside it
+    /// @param image packed image
+    /// @param row row to decode
+    /// @param skip number of pixels to skip at start of row
+    /// @param count number of pixels to write
+    /// @param out first pixel to write, in format of output
+    template<typename Format>
+    void decodeRow(const PackedImage& image, uint16_t row, uint16_t skip, uint16_t count, typename Format::Storage* out);
+
+    extern template void decodeRow<Rgb444>(const PackedImage&, uint16_t, uint16_t, uint16_t, Rgb444::Storage*);
+    extern template void decodeRow<Rgb565>(const PackedImage&, uint16_t, uint16_t, uint16_t, Rgb565::Storage*);
+    extern template void decodeRow<Rgb666>(const PackedImage&, uint16_t, uint16_t, uint16_t, Rgb666::Storage*);
+
+} // namespace Graphics
@@ -0,0 +1,276 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+namespace Graphics {
+
+    /// @brief Definicja głębi kolorów
+    enum class ColorDepth : uint8_t {
+        RGB444, // (12 bitów)
+        RGB565, // (16 bitów),
+        RGB666  // (18 bitów)
+    };
+
+    /// @brief Struktura reprezentująca kolor RGB
+    struct RGB {
+        uint8_t r;
+        uint8_t g;
+        uint8_t b;
+
+        constexpr RGB() : r(0), g(0), b(0) {}
+        constexpr RGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+
+        constexpr bool operator==(const RGB& other) const { return r == other.r && g == other.g && b == other.b; }
+        constexpr bool operator!=(const RGB& other) const { return !(*this == other); }
+
+        // Konwersja do wartości odpowiadającej głębi kolorów (0x0RGB, RGB565, 18-bit R6G6B6)
+        uint32_t toColorDepth(ColorDepth depth) const;
+
+        // Konwersja z wartości odpowiadającej głębi kolorów
+        static RGB fromColorDepth(uint32_t value, ColorDepth depth);
+    };
+
+    /// @brief Swap bytes of 16-bit value (single REV16 on Cortex-M0+)
+    constexpr uint16_t swapBytes(uint16_t value) {
+        return static_cast<uint16_t>((value >> 8) | (value << 8));
+    }
+
+    // Word access to pixel buffers of other types
+    typedef uint32_t __attribute__((may_alias)) word_alias_t;
+
+    /// @brief Fill halfword pixels, two per 32-bit store with aligned head and tail
+    /// @param dst first pixel
+    /// @param count number of pixels
+    /// @param value pixel to store
+    inline void fillHalfwords(uint16_t* dst, size_t count, uint16_t value) {
+        if (count > 0 && (reinterpret_cast<uintptr_t>(dst) & 2)) {
+            *dst++ = value;
+            --count;
+        }
+
+        const uint32_t pattern = value | (static_cast<uint32_t>(value) << 16);
+        word_alias_t* words = reinterpret_cast<word_alias_t*>(dst);
+        size_t pairs = count / 2;
+        for (; pairs >= 4; pairs -= 4) {
+            words[0] = pattern;
+            words[1] = pattern;
+            words[2] = pattern;
+            words[3] = pattern;
+            words += 4;
+        }
+        while (pairs--) {
+            *words++ = pattern;
+        }
+
+        if (count & 1) {
+            *reinterpret_cast<uint16_t*>(words) = value;
+        }
+    }
+
+    /// @brief Blend two native RGB565 pixels, all channels at once in one 32-bit register
+    /// @details Channels are spread to 0x07E0F81F (G high, R and B low) so each has
+    ///          room for the product with 5-bit alpha, then folded back to 16 bits
+    /// @param bg background pixel
+    /// @param fg foreground pixel
+    /// @param alpha weight of foreground, 0 - 32
+    /// @return blended pixel
+    constexpr uint16_t blend565(uint16_t bg, uint16_t fg, uint32_t alpha) {
+        const uint32_t b = (bg | (static_cast<uint32_t>(bg) << 16)) & 0x07E0F81F;
+        const uint32_t f = (fg | (static_cast<uint32_t>(fg) << 16)) & 0x07E0F81F;
+        const uint32_t r = ((((f - b) * alpha) >> 5) + b) & 0x07E0F81F;
+        return static_cast<uint16_t>(r | (r >> 16));
+    }
+
+    /// @brief Blend two native RGB565 pixels with 8-bit alpha
+    /// @details Red and blue are spread to 0x001F001F and share one multiply, green
+    ///          takes a second one; slower than blend565 but without alpha rounding
+    /// @param alpha weight of foreground, 0 - 256
+    constexpr uint16_t blend565Precise(uint16_t bg, uint16_t fg, uint32_t alpha) {
+        const uint32_t brb = ((bg & 0xF800u) << 5) | (bg & 0x001Fu);
+        const uint32_t frb = ((fg & 0xF800u) << 5) | (fg & 0x001Fu);
+        const uint32_t rb = ((((frb - brb) * alpha) >> 8) + brb) & 0x001F001F;
+        const uint32_t g = ((((static_cast<uint32_t>(fg & 0x07E0u) - (bg & 0x07E0u)) * alpha) >> 8) + (bg & 0x07E0u)) & 0x07E0;
+        return static_cast<uint16_t>(((rb >> 5) & 0xF800) | g | (rb & 0x001F));
+    }
+
+    /// @brief Add two native RGB565 pixels, channels saturate instead of carrying over
+    constexpr uint16_t add565(uint16_t a, uint16_t b) {
+        uint32_t x = ((a | (static_cast<uint32_t>(a) << 16)) & 0x07E0F81F) + ((b | (static_cast<uint32_t>(b) << 16)) & 0x07E0F81F);
+        const uint32_t rb = x & 0x00010020;     // carry out of blue and red
+        const uint32_t g = x & 0x08000000;      // carry out of green
+        x = (x | (rb - (rb >> 5)) | (g - (g >> 6))) & 0x07E0F81F;
+        return static_cast<uint16_t>(x | (x >> 16));
+    }
+
+    /// @brief Add two native 0x0RGB pixels, channels saturate instead of carrying over
+    constexpr uint16_t add444(uint16_t a, uint16_t b) {
+        uint32_t x = ((a | (static_cast<uint32_t>(a) << 12)) & 0x000F0F0F) + ((b | (static_cast<uint32_t>(b) << 12)) & 0x000F0F0F);
+        const uint32_t c = x & 0x00101010;      // carry out of every channel
+        x = (x | (c - (c >> 4))) & 0x000F0F0F;
+        return static_cast<uint16_t>((x & 0x0F0F) | ((x >> 12) & 0x00F0));
+    }
+
+    /// @brief Blend one 8-bit channel, alpha 0 - 255
+    constexpr uint8_t mixChannel(uint8_t b, uint8_t f, uint8_t alpha) {
+        return static_cast<uint8_t>(b + (((f - b) * (alpha + (alpha >> 7))) >> 8));
+    }
+
+    /// @brief Blend two native 0x0RGB pixels the same way, spread to 0x000F0F0F
+    /// @param alpha weight of foreground, 0 - 16
+    constexpr uint16_t blend444(uint16_t bg, uint16_t fg, uint32_t alpha) {
+        const uint32_t b = (bg | (static_cast<uint32_t>(bg) << 12)) & 0x000F0F0F;
+        const uint32_t f = (fg | (static_cast<uint32_t>(fg) << 12)) & 0x000F0F0F;
+        const uint32_t r = ((((f - b) * alpha) >> 4) + b) & 0x000F0F0F;
+        return static_cast<uint16_t>((r & 0x0F0F) | ((r >> 12) & 0x00F0));
+    }
+
+    /// @brief RGB444 format, stored as native 0x0RGB halfword
+    struct Rgb444 {
+        using Storage = uint16_t;
+        static constexpr ColorDepth depth = ColorDepth::RGB444;
+
+        /// @brief Native 12-bit value of color
+        static constexpr uint32_t encode(const RGB& c) {
+            return ((c.r & 0xF0) << 4) | (c.g & 0xF0) | (c.b >> 4);
+        }
+
+        /// @brief Color of native 12-bit value, channels expanded by replication
+        static constexpr RGB decode(uint32_t v) {
+            return RGB(static_cast<uint8_t>(((v >> 8) & 0x0F) * 0x11),
+                       static_cast<uint8_t>(((v >> 4) & 0x0F) * 0x11),
+                       static_cast<uint8_t>((v & 0x0F) * 0x11));
+        }
+
+        static constexpr Storage pack(const RGB& c) { return static_cast<Storage>(encode(c)); }
+        static constexpr RGB unpack(Storage s) { return decode(s); }
+
+        static void fill(Storage* dst, size_t count, Storage value) { fillHalfwords(dst, count, value); }
+
+        /// @brief Blend fg over bg, alpha 0 - 255
+        /// @tparam Precise true to blend with all 8 bits of alpha instead of 4
+        template<bool Precise = false>
+        static constexpr Storage blend(Storage bg, Storage fg, uint8_t alpha) {
+            if (!Precise) return blend444(bg, fg, (alpha + 8) >> 4);
+            return static_cast<Storage>((mixChannel(bg >> 8, fg >> 8, alpha) << 8) | (mixChannel((bg >> 4) & 0x0F, (fg >> 4) & 0x0F, alpha) << 4) |
+                                        mixChannel(bg & 0x0F, fg & 0x0F, alpha));
+        }
+
+        /// @brief Add two pixels, channels saturate
+        static constexpr Storage add(Storage a, Storage b) { return add444(a, b); }
+    };
+
+    /// @brief RGB565 format, stored in panel byte order (MSB first in memory, like LV_COLOR_16_SWAP)
+    struct Rgb565 {
+        using Storage = uint16_t;
+        static constexpr ColorDepth depth = ColorDepth::RGB565;
+
+        /// @brief Native 16-bit value of color
+        static constexpr uint32_t encode(const RGB& c) {
+            return ((c.r & 0xF8) << 8) | ((c.g & 0xFC) << 3) | (c.b >> 3);
+        }
+
+        /// @brief Color of native 16-bit value, channels expanded by replication
+        static constexpr RGB decode(uint32_t v) {
+            return RGB(static_cast<uint8_t>(((v >> 8) & 0xF8) | ((v >> 13) & 0x07)),
+                       static_cast<uint8_t>(((v >> 3) & 0xFC) | ((v >> 9) & 0x03)),
+                       static_cast<uint8_t>(((v << 3) & 0xF8) | ((v >> 2) & 0x07)));
+        }
+
+        /// @brief Storage of native value and back
+        static constexpr Storage toStorage(uint16_t native) { return swapBytes(native); }
+        static constexpr uint16_t fromStorage(Storage s) { return swapBytes(s); }
+
+        static constexpr Storage pack(const RGB& c) { return toStorage(static_cast<uint16_t>(encode(c))); }
+        static constexpr RGB unpack(Storage s) { return decode(fromStorage(s)); }
+
+        static void fill(Storage* dst, size_t count, Storage value) { fillHalfwords(dst, count, value); }
+
+        /// @brief Blend fg over bg, alpha 0 - 255
+        /// @tparam Precise true to blend with all 8 bits of alpha instead of 5
+        template<bool Precise = false>
+        static constexpr Storage blend(Storage bg, Storage fg, uint8_t alpha) {
+            return toStorage(Precise ? blend565Precise(fromStorage(bg), fromStorage(fg), alpha + (alpha >> 7))
+                                     : blend565(fromStorage(bg), fromStorage(fg), (alpha + 4) >> 3));
+        }
+
+        /// @brief Add two pixels, channels saturate
+        static constexpr Storage add(Storage a, Storage b) { return toStorage(add565(fromStorage(a), fromStorage(b))); }
+    };
+
+    /// @brief Packed 3-byte pixel, bytes as the panel takes them in 18-bit mode
+    struct Pixel666 {
+        uint8_t r;  // RRRRRR00
+        uint8_t g;  // GGGGGG00
+        uint8_t b;  // BBBBBB00
+
+        constexpr bool operator==(const Pixel666& other) const { return r == other.r && g == other.g && b == other.b; }
+        constexpr bool operator!=(const Pixel666& other) const { return !(*this == other); }
+    };
+    static_assert(sizeof(Pixel666) == 3, "Pixel666 must stay packed");
+
+    /// @brief RGB666 format, stored as packed 3-byte pixels
+    struct Rgb666 {
+        using Storage = Pixel666;
+        static constexpr ColorDepth depth = ColorDepth::RGB666;
+
+        /// @brief Native 18-bit value of color
+        static constexpr uint32_t encode(const RGB& c) {
+            return (static_cast<uint32_t>(c.r >> 2) << 12) | ((c.g >> 2) << 6) | (c.b >> 2);
+        }
+
+        /// @brief Color of native 18-bit value, channels expanded by replication
+        static constexpr RGB decode(uint32_t v) {
+            return RGB(static_cast<uint8_t>(((v >> 10) & 0xFC) | ((v >> 16) & 0x03)),
+                       static_cast<uint8_t>(((v >> 4) & 0xFC) | ((v >> 10) & 0x03)),
+                       static_cast<uint8_t>(((v << 2) & 0xFC) | ((v >> 4) & 0x03)));
+        }
+
+        static constexpr Storage pack(const RGB& c) {
+            return Pixel666{static_cast<uint8_t>(c.r & 0xFC), static_cast<uint8_t>(c.g & 0xFC), static_cast<uint8_t>(c.b & 0xFC)};
+        }
+        static constexpr RGB unpack(Storage s) {
+            return RGB(static_cast<uint8_t>(s.r | (s.r >> 6)), static_cast<uint8_t>(s.g | (s.g >> 6)), static_cast<uint8_t>(s.b | (s.b >> 6)));
+        }
+
+        /// @brief Fill packed pixels, four pixels as three 32-bit stores once aligned
+        static void fill(Storage* dst, size_t count, Storage value) {
+            while (count > 0 && (reinterpret_cast<uintptr_t>(dst) & 3)) {
+                *dst++ = value;
+                --count;
+            }
+
+            // r g b r | g b r g | b r g b, little-endian words
+            const uint32_t w0 = value.r | (value.g << 8) | (value.b << 16) | (static_cast<uint32_t>(value.r) << 24);
+            const uint32_t w1 = value.g | (value.b << 8) | (value.r << 16) | (static_cast<uint32_t>(value.g) << 24);
+            const uint32_t w2 = value.b | (value.r << 8) | (value.g << 16) | (static_cast<uint32_t>(value.b) << 24);
+            word_alias_t* words = reinterpret_cast<word_alias_t*>(dst);
+            for (size_t quads = count / 4; quads > 0; --quads) {
+                words[0] = w0;
+                words[1] = w1;
+                words[2] = w2;
+                words += 3;
+            }
+
+            dst = reinterpret_cast<Storage*>(words);
+            for (count &= 3; count > 0; --count) {
+                *dst++ = value;
+            }
+        }
+
+        /// @brief Blend fg over bg, alpha 0 - 255, channel by channel (always 8-bit alpha)
+        template<bool Precise = false>
+        static constexpr Storage blend(Storage bg, Storage fg, uint8_t alpha) {
+            return Pixel666{static_cast<uint8_t>(mixChannel(bg.r, fg.r, alpha) & 0xFC), static_cast<uint8_t>(mixChannel(bg.g, fg.g, alpha) & 0xFC),
+                            static_cast<uint8_t>(mixChannel(bg.b, fg.b, alpha) & 0xFC)};
+        }
+
+        /// @brief Add two pixels, channels saturate
+        static constexpr Storage add(Storage a, Storage b) {
+            return Pixel666{sum(a.r, b.r), sum(a.g, b.g), sum(a.b, b.b)};
+        }
+
+    private:
+        static constexpr uint8_t sum(uint8_t a, uint8_t b) { return a + b > 0xFC ? 0xFC : static_cast<uint8_t>(a + b); }
+    };
+
+} // namespace Graphics
@@ -0,0 +1,76 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Plain C so main.c can use it; shared between the two RP2040 cores
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Lock-free queue of fixed size items, one producer and one consumer
+/// @details Producer only writes head and consumer only writes tail, so the
+///          two sides may run on different cores without locks. Counters run
+///          freely and are masked with capacity - 1 when indexing slots
+typedef struct {
+    uint32_t head;          // items pushed so far, written by producer
+    uint32_t tail;          // items popped so far, written by consumer
+    uint32_t capacity;      // number of slots, power of two
+    uint32_t item_size;     // size of one item in bytes
+    uint8_t *slots;         // capacity * item_size bytes
+} spsc_queue_t;
+
+/// @brief Function to prepare empty queue
+/// @param q queue
+/// @param slots memory for capacity items, must outlive the queue
+/// @param item_size size of one item in bytes
+/// @param capacity number of slots, power of two
+static inline void spsc_queue_init(spsc_queue_t *q, void *slots, uint32_t item_size, uint32_t capacity)
+{
+    q->head = 0;
+    q->tail = 0;
+    q->capacity = capacity;
+    q->item_size = item_size;
+    q->slots = (uint8_t *)slots;
+}
+
+/// @brief Function to add item, producer side only
+/// @return false if queue is full, item is then not added
+static inline bool spsc_queue_push(spsc_queue_t *q, const void *item)
+{
+    const uint32_t head = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+    const uint32_t tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+    if (head - tail == q->capacity) return false;
+
+    memcpy(q->slots + (head & (q->capacity - 1)) * q->item_size, item, q->item_size);
+
+    // Slot has to be filled before consumer sees new head
+    __atomic_store_n(&q->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/// @brief Function to take oldest item, consumer side only
+/// @return false if queue is empty
+static inline bool spsc_queue_pop(spsc_queue_t *q, void *item)
+{
+    const uint32_t tail = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+    const uint32_t head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+    if (head == tail) return false;
+
+    memcpy(item, q->slots + (tail & (q->capacity - 1)) * q->item_size, q->item_size);
+
+    // Slot has to be copied out before producer may reuse it
+    __atomic_store_n(&q->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/// @brief Function to check if queue has no items, either side
+static inline bool spsc_queue_empty(spsc_queue_t *q)
+{
+    return __atomic_load_n(&q->head, __ATOMIC_ACQUIRE) == __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+"""Pack RGB565 image arrays into row-indexed QOI-style assets.
+
+Reads `const unsigned char name[] = { ... };` arrays of little-endian RGB565
+pixels (the Image2Lcd layout used in examples/ImageData.c) and writes a C++
+source and header defining one Graphics::PackedImage per image.
+
+Every row is coded on its own, starting from black and an empty index, so a
+decoder can start at any row through the offset table. Ops, as in
+src/packed_image.hpp:
+
+    00iiiiii            pixel from 64-entry index
+    01rrggbb            channel deltas -2..1 from previous pixel
+    10gggggg rrrrbbbb   green delta -32..31, red and blue relative to half of it
+    11nnnnnn            run of 1..62 previous pixels
+    11111110 hi lo      native RGB565 pixel
+
+Usage:
+    pack_images.py --input ImageData.c --output image_assets \\
+        gImage_1IN69_PIC:240x280 gImage_up:150x150
+"""
+
+import argparse
+import os
+import re
+import sys
+
+OP_INDEX = 0x00
+OP_DIFF = 0x40
+OP_LUMA = 0x80
+OP_RUN = 0xC0
+OP_PIXEL = 0xFE
+MAX_RUN = 62
+
+
+def channels(pixel):
+    return pixel >> 11, (pixel >> 5) & 0x3F, pixel & 0x1F
+
+
+def pixel_hash(pixel):
+    r, g, b = channels(pixel)
+    return (r * 3 + g * 5 + b * 7) & 0x3F
+
+
+def wrap(value, bits):
+    # Różnica modulo szerokość kanału, w zakresie ze znakiem
+    half = 1 << (bits - 1)
+    return ((value + half) & ((1 << bits) - 1)) - half
+
+
+def encode_row(row):
+    out = bytearray()
+    index = [0] * 64
+    prev = 0
+    run = 0
+
+    for pixel in row:
+        if pixel == prev:
+            run += 1
+            if run == MAX_RUN:
+                out.append(OP_RUN | (run - 1))
+                run = 0
+            continue
+        if run:
+            out.append(OP_RUN | (run - 1))
+            run = 0
+
+        slot = pixel_hash(pixel)
+        if index[slot] == pixel:
+            out.append(OP_INDEX | slot)
+        else:
+            index[slot] = pixel
+            r, g, b = channels(pixel)
+            pr, pg, pb = channels(prev)
+            dr, dg, db = wrap(r - pr, 5), wrap(g - pg, 6), wrap(b - pb, 5)
+            dr_dg, db_dg = wrap(dr - (dg >> 1), 5), wrap(db - (dg >> 1), 5)
+
+            if -2 <= dr <= 1 and -2 <= dg <= 1 and -2 <= db <= 1:
+                out.append(OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2))
+            elif -8 <= dr_dg <= 7 and -8 <= db_dg <= 7:
+                out.append(OP_LUMA | (dg + 32))
+                out.append((dr_dg + 8) << 4 | (db_dg + 8))
+            else:
+                out += bytes((OP_PIXEL, pixel >> 8, pixel & 0xFF))
+        prev = pixel
+
+    if run:
+        out.append(OP_RUN | (run - 1))
+    return out
+
+
+def decode_row(data, width):
+    # Dekoder referencyjny do sprawdzenia wyniku
+    out = []
+    index = [0] * 64
+    prev = 0
+    i = 0
+    while len(out) < width:
+        op = data[i]
+        i += 1
+        if op == OP_PIXEL:
+            prev = data[i] << 8 | data[i + 1]
+            i += 2
+        elif op >= OP_RUN:
+            out += [prev] * ((op & 0x3F) + 1)
+            continue
+        elif op >= OP_LUMA:
+            dg = (op & 0x3F) - 32
+            extra = data[i]
+            i += 1
+            r, g, b = channels(prev)
+            r = (r + (dg >> 1) + (extra >> 4) - 8) & 0x1F
+            g = (g + dg) & 0x3F
+            b = (b + (dg >> 1) + (extra & 0x0F) - 8) & 0x1F
+            prev = r << 11 | g << 5 | b
+        elif op >= OP_DIFF:
+            r, g, b = channels(prev)
+            r = (r + ((op >> 4) & 3) - 2) & 0x1F
+            g = (g + ((op >> 2) & 3) - 2) & 0x3F
+            b = (b + (op & 3) - 2) & 0x1F
+            prev = r << 11 | g << 5 | b
+        else:
+            prev = index[op]
+            out.append(prev)
+            continue
+        index[pixel_hash(prev)] = prev
+        out.append(prev)
+    return out
+
+
+def read_array(source, name):
+    match = re.search(r"\b" + re.escape(name) + r"\s*\[[^\]]*\]\s*=\s*\{(.*?)\};", source, re.S)
+    if match is None:
+        sys.exit(f"pack_images: array {name} not found")
+    body = re.sub(r"/\*.*?\*/", "", match.group(1), flags=re.S)
+    return bytes(int(value, 0) for value in re.findall(r"0[xX][0-9a-fA-F]+|\d+", body))
+
+
+def pack(name, width, height, raw):
+    if len(raw) < width * height * 2:
+        sys.exit(f"pack_images: {name} has {len(raw)} bytes, {width}x{height} needs {width * height * 2}")
+
+    data = bytearray()
+    offsets = []
+    for y in range(height):
+        row = [raw[2 * i] | raw[2 * i + 1] << 8 for i in range(y * width, (y + 1) * width)]
+        coded = encode_row(row)
+        if decode_row(coded, width) != row:
+            sys.exit(f"pack_images: {name} row {y} does not round-trip")
+        offsets.append(len(data))
+        data += coded
+    offsets.append(len(data))
+    return offsets, data
+
+
+def c_list(values, per_line, fmt):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(fmt.format(v) for v in values[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Pack RGB565 image arrays into row-indexed assets")
+    parser.add_argument("--input", required=True, help="C source with image arrays")
+    parser.add_argument("--output", required=True, help="output path without extension")
+    parser.add_argument("images", nargs="+", help="name:WIDTHxHEIGHT")
+    args = parser.parse_args()
+
+    with open(args.input, encoding="latin-1") as f:
+        source = f.read()
+
+    header_name = os.path.basename(args.output) + ".hpp"
+    header = [
+        "// Generated by tools/pack_images.py, do not edit",
+        "#pragma once",
+        '#include "packed_image.hpp"',
+        "",
+    ]
+    body = [
+        "// Generated by tools/pack_images.py, do not edit",
+        f'#include "{header_name}"',
+        "",
+    ]
+
+    for image in args.images:
+        match = re.fullmatch(r"(\w+):(\d+)x(\d+)", image)
+        if match is None:
+            sys.exit(f"pack_images: bad image spec {image}")
+        name, width, height = match.group(1), int(match.group(2)), int(match.group(3))
+        offsets, data = pack(name, width, height, read_array(source, name))
+
+        header.append(f"extern const Graphics::PackedImage {name}_packed;  // {len(data) + 4 * len(offsets)} of {width * height * 2} bytes")
+        body += [
+            f"static const uint32_t {name}_rows[{len(offsets)}] = {{",
+            c_list(offsets, 8, "{}"),
+            "};",
+            "",
+            f"static const uint8_t {name}_data[{len(data)}] = {{",
+            c_list(data, 16, "0x{:02X}"),
+            "};",
+            "",
+            f"const Graphics::PackedImage {name}_packed = {{{width}, {height}, {name}_rows, {name}_data}};",
+            "",
+        ]
+        print(f"pack_images: {name} {width}x{height}: {width * height * 2} -> {len(data) + 4 * len(offsets)} bytes")
+
+    with open(args.output + ".hpp", "w") as f:
+        f.write("\n".join(header) + "\n")
+    with open(args.output + ".cpp", "w") as f:
+        f.write("\n".join(body))
+
+
+if __name__ == "__main__":
+    main()